@@ -40,4 +40,21 @@ int fft_Iterative(scatter_t in, scatter_t out);
  */
 int fft_Compute(scatter_t timeSerie, scatter_t* freqSerie);
 
+/**
+ * @brief Spectrum of a non-uniformly sampled time serie, such as the output
+ *        of LCADC(), by a type-1 non-uniform FFT with Gaussian gridding.
+ *        Each sample is weighted by the time it stands for, half the time to
+ *        its neighbours divided by the average sampling period, so a
+ *        uniformly sampled serie gives the magnitudes of the DFT. Runs in
+ *        O(N + M log M) for N samples and M frequencies.
+ * 
+ * @param timeSerie Time serie (ns), in ascending time
+ * @param fStart First frequency of the spectrum (Hz)
+ * @param fStep Step between the frequencies of the spectrum (Hz)
+ * @param nbFrequencies Number of frequencies of the spectrum
+ * @param freqSerie Magnitudes vs frequency (Hz)
+ * @return int - 0 if success, -1 otherwise
+ */
+int fft_NonUniform(scatter_t timeSerie, double fStart, double fStep, size_t nbFrequencies, scatter_t* freqSerie);
+
 #endif // FFT_H
\ No newline at end of file
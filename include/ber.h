@@ -0,0 +1,110 @@
+/**
+ * @file ber.h
+ * @author OUSSET Gaël
+ * @brief Header file for ber.c, Monte-Carlo bit error rate of the modes
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * Each trial generates a frame of random payload with nfc_createSignal(),
+ * noise included, and decodes it with demod_frame(). The payload and the
+ * noise of a trial are drawn from a seed derived from the seed of the run,
+ * the noise level and the number of the trial, so the results do not
+ * depend on the number of threads. The trials run by rounds of
+ * BER_ROUND_SIZE spread over the cores, until the confidence interval of
+ * the bit error rate is narrow enough or the maximum number of trials is
+ * reached.
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef BER_H
+#define BER_H
+
+#include "nfcsig.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Number of trials run between two checks of the confidence interval
+ */
+#define BER_ROUND_SIZE 64
+
+/**
+ * Quantile of the normal distribution of the confidence intervals (95%)
+ */
+#define BER_Z 1.959963984540054
+
+//========== Structures declarations
+/**
+ * @brief Parameters of a bit error rate run
+ * 
+ */
+typedef struct {
+    nfc_standard_t   standard;                   // NFC standard
+    nfc_dataTransm_t dataTransm;                 // Data transmission mode
+    unsigned int     bitRate;                    // Bit rate (bit/s)
+    size_t           dataSize;                   // Size of the payload of a frame (bytes)
+    unsigned int     numberOfPoints;             // Number of points of a frame
+    const double*    noiseLevels;                // Noise levels to simulate
+    size_t           nbNoiseLevels;              // Number of noise levels
+    uint64_t         maxTrials;                  // Maximum number of frames per noise level
+    uint64_t         minErrors;                  // Bit errors needed before stopping early
+    double           precision;                  // Half width of the interval to stop early, relative to the bit error rate
+    uint64_t         seed;                       // Seed of the run
+} ber_config_t;
+
+/**
+ * @brief Result of a noise level. The bounds are the Wilson score interval
+ *        at BER_Z, the bits are counted as independent trials.
+ * 
+ */
+typedef struct {
+    double   noiseLevel;                         // Noise level
+    uint64_t nbFrames;                           // Number of frames sent
+    uint64_t nbFrameErrors;                      // Frames with at least one wrong bit
+    uint64_t nbBits;                             // Number of bits sent
+    uint64_t nbBitErrors;                        // Number of wrong bits
+    double   ber;                                // Bit error rate
+    double   berLow;                             // Lower bound of the bit error rate
+    double   berHigh;                            // Upper bound of the bit error rate
+    double   fer;                                // Frame error rate
+    double   ferLow;                             // Lower bound of the frame error rate
+    double   ferHigh;                            // Upper bound of the frame error rate
+    int      converged;                          // 1 if stopped early, 0 if maxTrials was reached
+} ber_result_t;
+
+//========== Functions
+/**
+ * @brief Compute the Wilson score interval of a proportion at BER_Z
+ * 
+ * @param nbErrors Number of errors
+ * @param nbTrials Number of trials
+ * @param rate Estimated proportion, 0 without trials
+ * @param low Lower bound of the proportion
+ * @param high Upper bound of the proportion
+ */
+void ber_interval(uint64_t nbErrors, uint64_t nbTrials, double* rate, double* low, double* high);
+
+/**
+ * @brief Estimate the bit and frame error rates at each noise level. The
+ *        messages of the trials follow the settings of the current
+ *        context, which should be silenced.
+ * 
+ * @param config Parameters of the run
+ * @param results Result of each noise level, nbNoiseLevels of the configuration
+ * @return int - 0 if success, -1 otherwise
+ */
+int ber_run(const ber_config_t* config, ber_result_t* results);
+
+/**
+ * @brief Write the results as a CSV table, one line per noise level
+ * 
+ * @param file Destination, opened for writing
+ * @param results Results of ber_run()
+ * @param nbResults Number of results
+ * @return int - 0 if success, -1 otherwise
+ */
+int ber_writeTable(FILE* file, const ber_result_t* results, size_t nbResults);
+
+#endif // BER_H
@@ -13,6 +13,11 @@
 #define CONFIG_H
 
 //----- Program parameters
+/**
+ * Version of the library, part of the key of the cached waveforms
+ */
+#define NFCSIM_VERSION "0.1"
+
 /**
  * If defined, all printf will be disabled
  * Required if compiled with the -mwindows flag
@@ -31,11 +36,52 @@
  */
 #define VERBOSITY 5
 
+/**
+ * Print the messages from the calling thread instead of the logging thread,
+ * see logging.h
+ */
+// #define SYNC_LOGGING
+
+/**
+ * Number of messages waiting for the logging thread, the debug, info,
+ * success and warning messages are dropped above it
+ */
+#define LOG_BUFFER_SIZE 1024
+
 /**
  * Remove all assert calls
  */
 // #define NO_ASSERT
 
+/**
+ * Remove the timers of the pipeline stages, see profile.h
+ */
+// #define NO_PROFILING
+
+/**
+ * Number of events kept per thread by the tracer, the oldest events are
+ * overwritten above it
+ */
+#define TRACE_BUFFER_SIZE 16384
+
+/**
+ * Number of threads used to generate a single signal
+ * 0: Use all the available cores
+ */
+#define NB_THREADS 0
+
+/**
+ * Minimum number of points handled by a thread, smaller signals are
+ * generated on a single thread
+ */
+#define MIN_POINTS_PER_THREAD 4096
+
+/**
+ * Maximum size of the on-disk waveform cache (bytes), the least recently
+ * used waveforms are evicted above it
+ */
+#define CACHE_MAX_SIZE (1024ULL * 1024ULL * 1024ULL)
+
 //----- Simulation parameters
 /**
  * Use the M_PI constant from the math library
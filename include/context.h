@@ -0,0 +1,268 @@
+/**
+ * @file context.h
+ * @author OUSSET Gaël
+ * @brief Execution context of the library: random generator, logging,
+ *        allocator and scratch memory
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "logging.h"
+#include "profile.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+//========== Structures declarations
+/**
+ * @brief Destination of the log messages
+ * 
+ * @param user User pointer given with the sink
+ * @param type Type of the message
+ * @param message Formatted message, without style nor new line
+ */
+typedef void (*nfc_logSink_t)(void* user, print_type_t type, const char* message);
+
+/**
+ * @brief Memory allocator
+ * 
+ */
+typedef struct {
+    void* (*alloc)(void* user, size_t size);                // Allocate a block
+    void* (*realloc)(void* user, void* ptr, size_t size);   // Resize a block
+    void  (*free)(void* user, void* ptr);                   // Free a block
+    void* user;                                             // Given to each call
+} nfc_allocator_t;
+
+/**
+ * @brief Memory used by a stage
+ * 
+ */
+typedef struct {
+    unsigned long long bytes;                    // Bytes currently allocated
+    unsigned long long peak;                     // Maximum of bytes
+    unsigned long long total;                    // Bytes allocated since the creation of the context
+    unsigned long      nbAlloc;                  // Number of allocations
+    unsigned long      nbRealloc;                // Number of reallocations
+    unsigned long      nbFree;                   // Number of frees
+} nfc_memStats_t;
+
+/**
+ * @brief Execution context. Every function of the library uses the context
+ *        bound to the calling thread, so independent simulations can run in
+ *        parallel threads, each with its own context. The workers of
+ *        parallel_for() share the context of the caller: its messages,
+ *        allocator and statistics, but not its scratch memory. The stage
+ *        being run is kept by each thread, see nfc_contextStage().
+ * 
+ */
+typedef struct nfc_context {
+    uint64_t            seed;                    // Seed of the random generator
+    _Atomic uint64_t    counter;                 // Index of the next random value
+    nfc_logSink_t       logSink;                 // Destination of the messages
+    void*               logUser;                 // User pointer of the sink
+    int                 verbosity;               // Maximum type of printed messages
+    nfc_allocator_t     allocator;               // Memory allocator
+    void*               scratch;                 // Scratch memory reused between calls
+    size_t              scratchSize;             // Size of the scratch memory
+    pthread_mutex_t     lock;                    // Lock of the statistics, updated by the workers
+    nfc_memStats_t      memStats[NB_PROF_STAGES]; // Memory allocated by each stage
+    nfc_memStats_t      memTotal;                // Memory allocated by all the stages
+    prof_stats_t        profStats[NB_PROF_STAGES]; // Time spent in each stage
+    prof_counters_t*    counters;                // Hardware counters, NULL if closed
+    struct nfc_context* parent;                  // Context receiving the statistics when destroyed, NULL if none
+} *nfc_context_t;
+
+//========== Functions
+/**
+ * @brief Create a context with the default settings: fixed seed, messages on
+ *        stderr up to VERBOSITY, standard allocator
+ * 
+ * @param context Created context
+ * @return int - 0 if success, -1 otherwise
+ */
+int nfc_contextCreate(nfc_context_t* context);
+
+/**
+ * @brief Create a context with the messages and the allocator of the
+ *        current context, for a task that needs its own random generator.
+ *        Its statistics are added to the current context when it is
+ *        destroyed, which must happen before the current context is.
+ * 
+ * @param context Created context
+ * @return int - 0 if success, -1 otherwise
+ */
+int nfc_contextFork(nfc_context_t* context);
+
+/**
+ * @brief Destroy a context. It must not be bound to any thread.
+ * 
+ * @param context Context to destroy
+ */
+void nfc_contextDestroy(nfc_context_t context);
+
+/**
+ * @brief Bind a context to the calling thread
+ * 
+ * @param context Context to bind, NULL to go back to the default context of
+ *                the thread
+ */
+void nfc_contextBind(nfc_context_t context);
+
+/**
+ * @brief Bind the context of another thread to the calling thread, as the
+ *        workers of parallel_for() do. The scratch memory of the context is
+ *        left to its thread.
+ * 
+ * @param context Context to share
+ */
+void nfc_contextShare(nfc_context_t context);
+
+/**
+ * @brief Return the context bound to the calling thread, or the default
+ *        context of the thread if none is bound
+ * 
+ * @return nfc_context_t - Current context
+ */
+nfc_context_t nfc_contextGet(void);
+
+/**
+ * @brief Restart the random generator of a context
+ * 
+ * @param context Context
+ * @param seed New seed
+ */
+void nfc_contextSeed(nfc_context_t context, uint64_t seed);
+
+/**
+ * @brief Set the destination and the level of the messages of a context
+ * 
+ * @param context Context
+ * @param sink Destination of the messages, NULL for stderr
+ * @param user User pointer given to the sink
+ * @param verbosity Maximum type of printed messages, see VERBOSITY
+ */
+void nfc_contextSetLog(nfc_context_t context, nfc_logSink_t sink, void* user, int verbosity);
+
+/**
+ * @brief Set the memory allocator of a context. The blocks allocated
+ *        before keep their allocator, nfc_realloc() and nfc_free() release
+ *        each block through the allocator that created it.
+ * 
+ * @param context Context
+ * @param allocator Allocator, NULL for the standard one
+ */
+void nfc_contextSetAllocator(nfc_context_t context, nfc_allocator_t* allocator);
+
+/**
+ * @brief Draw a random value from the generator of a context. The draws of
+ *        threads sharing a context are not reproducible, a task drawing
+ *        values works in its own context, see nfc_contextFork().
+ * 
+ * @param context Context
+ * @return double - Random value uniformly distributed in [0, 1)
+ */
+double nfc_contextRandom(nfc_context_t context);
+
+/**
+ * @brief Reserve consecutive values of the generator of a context
+ * 
+ * @param context Context
+ * @param nbValues Number of values
+ * @return uint64_t - Index of the first value
+ */
+uint64_t nfc_contextDraw(nfc_context_t context, uint64_t nbValues);
+
+/**
+ * @brief Return the stage run by the calling thread, in which its
+ *        allocations and time are counted
+ * 
+ * @return prof_stage_t - Stage being run
+ */
+prof_stage_t nfc_contextStage(void);
+
+/**
+ * @brief Set the stage run by the calling thread
+ * 
+ * @param stage Stage being run
+ */
+void nfc_contextSetStage(prof_stage_t stage);
+
+/**
+ * @brief Return the scratch memory of a context, grown to at least size
+ *        bytes. Its content is not kept between calls. The default context
+ *        of a thread and the contexts shared with a worker have no scratch
+ *        memory, the caller allocates its own.
+ * 
+ * @param context Context
+ * @param size Required size (bytes)
+ * @return void* - Scratch memory, NULL if it cannot be allocated
+ */
+void* nfc_contextScratch(nfc_context_t context, size_t size);
+
+/**
+ * @brief Return the memory used by a stage in a context. Blocks are
+ *        attributed to the stage that allocated them.
+ * 
+ * @param context Context
+ * @param stage Stage, NB_PROF_STAGES for all the stages
+ * @return nfc_memStats_t - Memory used by the stage
+ */
+nfc_memStats_t nfc_contextMemStats(nfc_context_t context, prof_stage_t stage);
+
+/**
+ * @brief Print the memory used by each stage of a context
+ * 
+ * @param context Context
+ * @param print_type Type of the messages
+ */
+void nfc_contextMemReport(nfc_context_t context, print_type_t print_type);
+
+//----- Allocation through the current context
+/*
+ * Blocks are preceded by a small header recording their size and stage, so
+ * they must be freed with nfc_free(), never with free().
+ */
+/**
+ * @brief Allocate memory with the allocator of the current context
+ * 
+ * @param size Size of the block (bytes)
+ * @return void* - Allocated block, NULL on failure
+ */
+void* nfc_malloc(size_t size);
+
+/**
+ * @brief Allocate zeroed memory with the allocator of the current context
+ * 
+ * @param nb Number of elements
+ * @param size Size of an element (bytes)
+ * @return void* - Allocated block, NULL on failure
+ */
+void* nfc_calloc(size_t nb, size_t size);
+
+/**
+ * @brief Resize memory with the allocator that allocated it, counted in
+ *        the current context
+ * 
+ * @param ptr Block to resize
+ * @param size New size (bytes)
+ * @return void* - Resized block, NULL on failure
+ */
+void* nfc_realloc(void* ptr, size_t size);
+
+/**
+ * @brief Free memory with the allocator that allocated it, counted in the
+ *        current context
+ * 
+ * @param ptr Block to free
+ */
+void nfc_free(void* ptr);
+
+#endif // CONTEXT_H
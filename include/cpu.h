@@ -0,0 +1,139 @@
+/**
+ * @file cpu.h
+ * @author OUSSET Gaël
+ * @brief Runtime dispatch of the hot kernels on the features of the CPU
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * The CPU is detected once, on the first call to cpu_kernels(), and the
+ * kernels of the best supported tier are bound. The NFCSIM_CPU environment
+ * variable (generic, avx2 or avx512) forces a lower tier for testing.
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef CPU_H
+#define CPU_H
+
+#include "config.h"
+#include "scatter.h"
+#include <complex.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+//========== Structures declarations
+/**
+ * @brief Tiers of CPU features, each one includes the previous ones
+ * 
+ */
+typedef enum {
+    CPU_GENERIC,                                 // Baseline of the architecture
+    CPU_AVX2,                                    // x86-64 with AVX2 and FMA
+    CPU_AVX512,                                  // x86-64 with AVX-512 F, DQ and VL
+    NB_CPU_TIERS
+} cpu_tier_t;
+
+/**
+ * @brief Parameters of the envelope kernel, see nfc_createEnvelope()
+ * 
+ */
+typedef struct {
+    const char*  symbols;                        // Sub-modulated symbols
+    size_t       nbSymbols;                      // Number of symbols
+    unsigned int simDuration;                    // Duration of the simulation (ns)
+    unsigned int numberOfPoints;                 // Number of points of the envelope
+    unsigned int symbolDuration;                 // Duration of a symbol (ns)
+    unsigned int transTime;                      // Transition time (points)
+    double       levels[2];                      // Level of a symbol at 0 and at 1
+} cpu_envelope_t;
+
+/**
+ * @brief Kernels of a tier. Within a tier, the result of a point only
+ *        depends on its own inputs, not on the number of points of the call
+ *        nor on its place among them. The tiers give the same results up to
+ *        the rounding of fused multiply-adds, of the magnitude and of the
+ *        sine of the carrier (an ulp or two): results compared bit for bit
+ *        across machines (shards, cached waveforms) need the same tier, see
+ *        NFCSIM_CPU.
+ * 
+ */
+typedef struct {
+    /**
+     * @brief Generate the points [first, last) of the envelope: average of
+     *        the symbol levels over the transition time
+     */
+    void (*envelope)(const cpu_envelope_t* env, point_t* points, size_t first, size_t last);
+
+    /**
+     * @brief Multiply the n points by the carrier, out can be in
+     */
+    void (*carrier)(const point_t* in, point_t* out, size_t n, unsigned int carrierFreq);
+
+    /**
+     * @brief Add uniform noise to the n points, the noise of the point i is
+     *        drawn with the counter counter+i, out can be in
+     */
+    void (*noise)(const point_t* in, point_t* out, size_t n, double noiseLevel, uint64_t seed, uint64_t counter);
+
+    /**
+     * @brief Apply the butterflies of the FFT on the n bit-reversed values
+     *        of X (power of 2), twiddles is a buffer of n/2 values
+     */
+    void (*butterflies)(complex double* X, complex double* twiddles, size_t n);
+
+    /**
+     * @brief Write the magnitude of the n values of X in the y of out
+     */
+    void (*magnitude)(const complex double* X, point_t* out, size_t n);
+
+    /**
+     * @brief Write to indices the i of [first, last) where one of the
+     *        sorted levels is strictly between the points i-1 and i, and
+     *        return how many there are. first should be at least 1, indices
+     *        should hold last-first values.
+     */
+    size_t (*crossings)(const point_t* points, size_t first, size_t last, const double* levels, unsigned int nbLevels, size_t* indices);
+} cpu_kernels_t;
+
+//========== Functions
+/**
+ * @brief Return the kernels of the current tier, the CPU is detected on the
+ *        first call
+ * 
+ * @return const cpu_kernels_t* - Kernels of the current tier
+ */
+const cpu_kernels_t* cpu_kernels(void);
+
+/**
+ * @brief Return the current tier, see cpu_kernels()
+ * 
+ * @return cpu_tier_t - Current tier
+ */
+cpu_tier_t cpu_tier(void);
+
+/**
+ * @brief Return the best tier supported by the CPU, regardless of NFCSIM_CPU
+ * 
+ * @return cpu_tier_t - Best supported tier
+ */
+cpu_tier_t cpu_supportedTier(void);
+
+/**
+ * @brief Bind the kernels of another tier. Should not be called while other
+ *        threads are running the library.
+ * 
+ * @param tier New tier
+ * @return int - 0 if success, -1 if the CPU does not support the tier
+ */
+int cpu_setTier(cpu_tier_t tier);
+
+/**
+ * @brief Return the name of a tier, as given to NFCSIM_CPU
+ * 
+ * @param tier Tier
+ * @return const char* - Name of the tier
+ */
+const char* cpu_tierName(cpu_tier_t tier);
+
+#endif // CPU_H
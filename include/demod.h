@@ -13,24 +13,187 @@
 #define DEMOD_H
 
 #include "config.h"
+#include "nfcsig.h"
 #include "scatter.h"
 
+//========== Structures declarations
 /**
- * @brief Simulate a Level Crossing ADC
+ * @brief Level Crossing ADC fed block by block. It keeps the last point,
+ *        the skip counter and the step whose crossed levels are being
+ *        emitted, so that the blocks give the same samples as LCADC() on
+ *        the whole signal.
+ * 
+ */
+typedef struct LCADC_stream {
+    double*      levels;                         // Levels in ascending order
+    unsigned int nbLevels;                       // Number of levels
+    unsigned int skip;                           // Number of crossings ignored after each sample
+    unsigned int skpCnt;                         // Crossings still to ignore
+    point_t      previous;                       // Last point received
+    char         hasPrevious;                    // 1 once a point has been received
+    point_t      a;                              // First point of the current step
+    point_t      b;                              // Second point of the current step
+    size_t       next;                           // Next rank of level to emit for the current step
+    size_t       first;                          // First rank of level crossed by the current step
+    size_t       last;                           // Rank after the last level crossed by the current step
+} *LCADC_stream_t;
+
+/**
+ * @brief Candidate configuration of a Level Crossing ADC
+ * 
+ */
+typedef struct {
+    double*      levels;                         // Levels, in any order
+    unsigned int nbLevels;                       // Number of levels
+    unsigned int skip;                           // Number of crossings ignored after each sample
+} LCADC_config_t;
+
+/**
+ * @brief Samples and metrics of a Level Crossing ADC configuration
+ * 
+ */
+typedef struct {
+    scatter_t samples;                           // Samples, NULL if not kept
+    size_t    nbSamples;                         // Number of samples
+    double    rmsError;                          // RMS error of the reconstruction, see LCADC_batch()
+} LCADC_result_t;
+
+/**
+ * @brief Receiver of the frames of a mode. The carrier phase is estimated
+ *        on the whole frame, then the signal is projected on the carrier
+ *        and integrated over each sub-carrier half period (chip) with
+ *        prefix sums. The timing of the chips is searched to open the eye,
+ *        then the chips are demodulated into the quarters of bit and
+ *        decoded. All the buffers are allocated once, for frames of up to
+ *        maxPoints.
+ * 
+ */
+typedef struct demod {
+    nfc_sigParam_t param;                        // Parameters of the frames, without data
+    size_t         maxPoints;                    // Maximum number of points of a frame
+    double*        projection;                   // Prefix sums of the signal times the carrier
+    double*        energy;                       // Prefix sums of the squared carrier
+    double*        chips;                        // Amplitude of the envelope on each chip
+    double*        weights;                      // Energy of the carrier on each chip
+    size_t         nbChips;                      // Number of chips of a frame
+    unsigned int   chipDuration;                 // Duration of a chip (ns)
+    int            timing;                       // Start of the first chip on the last frame (ns)
+    double         margin;                       // Smallest soft bit of the last frame, relative to the eye opening
+} *demod_t;
+
+//========== Functions
+/**
+ * @brief Simulate a Level Crossing ADC. A sample is taken for every level
+ *        strictly between two consecutive points, in the order the levels
+ *        are crossed, at the time interpolated linearly between the points.
+ *        Runs in linear time of the number of points.
  * 
  * @param signal Input signal
- * @param levels Levels to compare the signal to
+ * @param levels Levels to compare the signal to, in any order
  * @param nbLevels Number of levels
- * @param skip Keep only one point every skip
+ * @param skip Number of crossings ignored after each sample
  * @param output Sampled signal
  * @return int - 0 if success, -1 otherwise
  */
 int LCADC(scatter_t signal, double* levels, unsigned int nbLevels, unsigned int skip, scatter_t* output);
 
+/**
+ * @brief Create a Level Crossing ADC fed block by block, see LCADC()
+ * 
+ * @param levels Levels to compare the signal to, in any order (copied)
+ * @param nbLevels Number of levels
+ * @param skip Number of crossings ignored after each sample
+ * @param stream Created stream
+ * @return int - 0 if success, -1 otherwise
+ */
+int LCADC_streamCreate(double* levels, unsigned int nbLevels, unsigned int skip, LCADC_stream_t* stream);
+
+/**
+ * @brief Destroy a Level Crossing ADC stream
+ * 
+ * @param stream Stream to destroy
+ */
+void LCADC_streamDestroy(LCADC_stream_t stream);
+
+/**
+ * @brief Feed the next points of the signal to the stream. The samples are
+ *        written to the buffer of the caller. When it is full, the stream
+ *        stops and the points not consumed should be pushed again; the
+ *        samples of a step already started are kept and emitted first on
+ *        the next call, which may have no point.
+ * 
+ * @param stream Stream
+ * @param points Next points of the signal
+ * @param nbPoints Number of points
+ * @param samples Buffer of samples
+ * @param maxSamples Size of the buffer of samples
+ * @param nbSamples Number of samples written to the buffer
+ * @param nbConsumed Number of points consumed, nbPoints unless the buffer is full
+ * @return int - 0 if success, -1 otherwise
+ */
+int LCADC_streamPush(
+    LCADC_stream_t stream,
+    const point_t* points,
+    size_t nbPoints,
+    point_t* samples,
+    size_t maxSamples,
+    size_t* nbSamples,
+    size_t* nbConsumed
+);
+
+/**
+ * @brief Simulate many Level Crossing ADC configurations in one pass over
+ *        the signal. The configurations are split between the threads, each
+ *        thread reads the signal block by block and runs all its
+ *        configurations on a block while it is in cache.
+ *        The reconstruction holds the level of the last sample from the
+ *        point that ends its step, 0 before the first sample; its error is
+ *        measured on every point of the signal.
+ * 
+ * @param signal Input signal
+ * @param configs Configurations to simulate
+ * @param nbConfigs Number of configurations
+ * @param keepSamples 1 to return the samples, 0 for the metrics only
+ * @param results Samples and metrics of each configuration, samples to destroy with scatter_destroy()
+ * @return int - 0 if success, -1 otherwise
+ */
+int LCADC_batch(scatter_t signal, LCADC_config_t* configs, size_t nbConfigs, int keepSamples, LCADC_result_t* results);
+
+/**
+ * @brief Create a receiver for the frames of a mode
+ * 
+ * @param sigParam Parameters of the frames, the data is ignored and only its size is used
+ * @param maxPoints Maximum number of points of a frame
+ * @param demod Created receiver
+ * @return int - 0 if success, -1 otherwise
+ */
+int demod_create(nfc_sigParam_t* sigParam, size_t maxPoints, demod_t* demod);
+
+/**
+ * @brief Destroy a receiver
+ * 
+ * @param demod Receiver to destroy
+ */
+void demod_destroy(demod_t demod);
+
+/**
+ * @brief Decode a frame: envelope detection, chip timing recovery within
+ *        half a chip, sub-carrier demodulation (none, OOK or BPSK) and
+ *        decoding (modified Miller, NRZ or Manchester). Nothing is
+ *        allocated. The carrier should be at the frequency of the
+ *        parameters, with any phase.
+ * 
+ * @param demod Receiver
+ * @param signal Modulated signal of the frame (amplitude vs time in ns), in ascending time
+ * @param data Decoded data, dataSize bytes of the parameters of the receiver
+ * @return int - 0 if success, -1 otherwise
+ */
+int demod_frame(demod_t demod, scatter_t signal, char* data);
+
 /**
  * @brief Create a sin period lookup table
  * 
- * @param LUT Pointeur to the LUT array
+ * @param LUT Pointeur to the LUT array, to free with nfc_free()
  * @param LUTSize Size of the LUT
  * @return int - 0 if success, -1 otherwise
  */
@@ -0,0 +1,177 @@
+/**
+ * @file events.h
+ * @author OUSSET Gaël
+ * @brief Header file for events.c, compact binary files of LCADC samples
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * An event file holds samples whose levels belong to a known set, in
+ * non-decreasing time order, as LCADC() produces them. Each event is one
+ * varint: the time elapsed since the previous event, shifted left by the
+ * number of bits of a level index, or'ed with the index of its level. The
+ * events are grouped in blocks of EVENTS_BLOCK_SIZE, and an index of the
+ * blocks at the end of the file gives the offset and the time of the first
+ * event of each block, so the reader maps the file and seeks by bisection.
+ * 
+ * Layout: header, levels (double, ascending), blocks padded to 8 bytes,
+ * index (events_index_t per block). Integers are in the byte order of the
+ * writer.
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include "scatter.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Number of events of a block of the index
+ */
+#define EVENTS_BLOCK_SIZE 4096
+
+/**
+ * Maximum number of levels of an event file
+ */
+#define EVENTS_MAX_LEVELS 65536
+
+//========== Structures declarations
+/**
+ * @brief Entry of the index of an event file
+ * 
+ */
+typedef struct {
+    uint64_t offset;                             // Offset of the block in the file (bytes)
+    int64_t  time;                               // Time of the first event of the block
+} events_index_t;
+
+/**
+ * @brief Streaming writer of an event file
+ * 
+ */
+typedef struct events_writer {
+    FILE*           file;                        // File being written
+    char*           filename;                    // Name of the file
+    double*         levels;                      // Levels, in ascending order
+    unsigned int    nbLevels;                    // Number of levels
+    unsigned int    levelBits;                   // Number of bits of a level index
+    uint64_t        nbEvents;                    // Number of events written
+    uint64_t        offset;                      // Offset of the next block (bytes)
+    int64_t         previous;                    // Time of the previous event
+    events_index_t* index;                       // Index of the blocks
+    size_t          capacity;                    // Allocated entries of the index
+    unsigned char*  buffer;                      // Encoded events of the current block
+    size_t          used;                        // Bytes used in the buffer
+} *events_writer_t;
+
+/**
+ * @brief Streaming reader of a memory-mapped event file
+ * 
+ */
+typedef struct events_reader {
+    const unsigned char*  content;               // Content of the file
+    size_t                fileSize;              // Size of the file (bytes)
+    const double*         levels;                // Levels, in ascending order
+    unsigned int          nbLevels;              // Number of levels
+    unsigned int          levelBits;             // Number of bits of a level index
+    uint64_t              nbEvents;              // Number of events of the file
+    uint64_t              nbBlocks;              // Number of blocks of the file
+    const events_index_t* index;                 // Index of the blocks
+    uint64_t              next;                  // Number of the next event read
+    size_t                position;              // Offset of the next event (bytes)
+    int64_t               previous;              // Time of the previous event
+} *events_reader_t;
+
+//========== Functions
+/**
+ * @brief Create an event file, the events are appended with events_write()
+ * 
+ * @param filename Name of the file
+ * @param levels Levels of the events, in any order
+ * @param nbLevels Number of levels
+ * @param writer Created writer
+ * @return int - 0 if success, -1 otherwise
+ */
+int events_writerOpen(char* filename, double* levels, unsigned int nbLevels, events_writer_t* writer);
+
+/**
+ * @brief Append events to an event file. The events must not go back in
+ *        time and their y must be one of the levels of the file.
+ * 
+ * @param writer Writer
+ * @param events Events to append
+ * @param nbEvents Number of events
+ * @return int - 0 if success, -1 otherwise
+ */
+int events_write(events_writer_t writer, const point_t* events, size_t nbEvents);
+
+/**
+ * @brief Write the index and the header, then close the file and destroy
+ *        the writer. The file is removed if it cannot be completed.
+ * 
+ * @param writer Writer
+ * @return int - 0 if success, -1 otherwise
+ */
+int events_writerClose(events_writer_t writer);
+
+/**
+ * @brief Map an event file and read it from its first event
+ * 
+ * @param filename Name of the file
+ * @param reader Created reader
+ * @return int - 0 if success, -1 otherwise
+ */
+int events_readerOpen(char* filename, events_reader_t* reader);
+
+/**
+ * @brief Unmap the file and destroy the reader
+ * 
+ * @param reader Reader
+ */
+void events_readerClose(events_reader_t reader);
+
+/**
+ * @brief Read the next events
+ * 
+ * @param reader Reader
+ * @param events Where the events are written
+ * @param maxEvents Room of events
+ * @param nbEvents Number of events read, 0 at the end of the file
+ * @return int - 0 if success, -1 if the file is corrupted
+ */
+int events_read(events_reader_t reader, point_t* events, size_t maxEvents, size_t* nbEvents);
+
+/**
+ * @brief Move the reader to the first event at or after a time. The block
+ *        is found in the index, then decoded up to the time.
+ * 
+ * @param reader Reader
+ * @param time Time to seek
+ * @return int - 0 if success, -1 if the file is corrupted
+ */
+int events_seek(events_reader_t reader, int time);
+
+/**
+ * @brief Write a cloud of samples to an event file
+ * 
+ * @param filename Name of the file
+ * @param samples Samples, see events_write()
+ * @param levels Levels of the samples, in any order
+ * @param nbLevels Number of levels
+ * @return int - 0 if success, -1 otherwise
+ */
+int events_save(char* filename, scatter_t samples, double* levels, unsigned int nbLevels);
+
+/**
+ * @brief Read all the events of an event file into a cloud of samples
+ * 
+ * @param filename Name of the file
+ * @param samples Read samples
+ * @return int - 0 if success, -1 otherwise
+ */
+int events_load(char* filename, scatter_t* samples);
+
+#endif // EVENTS_H
@@ -62,7 +62,12 @@
 #ifdef HEADLESS
     #define PRINT(level, format, ...) ((void)0)
 #else
-    #define PRINT(type, format, ...) printInfo(type, format, ##__VA_ARGS__)
+    // The type is a constant, so the messages above VERBOSITY are removed at
+    // compile time, along with the evaluation of their arguments
+    #define PRINT(type, format, ...) do {                \
+            if ((int)(type) <= VERBOSITY)                 \
+                printInfo(type, format, ##__VA_ARGS__);   \
+        } while (0)
 #endif
 
 //========== Rescourses related to the print type
@@ -76,7 +81,26 @@ typedef enum {
 } print_type_t;
 
 /**
- * @brief Print a message with a specific type
+ * @brief Default destination of the messages: one styled line on stderr,
+ *        written with a single call so lines of different threads do not
+ *        interleave
+ * 
+ * @param user Unused
+ * @param print_type Type of the message
+ * @param message Formatted message
+ */
+void printStderr(void* user, print_type_t print_type, const char* message);
+
+/**
+ * @brief Print a message with a specific type, through the sink and up to
+ *        the verbosity of the current context (see context.h).
+ *        The message is formatted by the calling thread, then written to a
+ *        lock-free ring buffer and sent to the sink by a background thread,
+ *        so the caller never waits for the output. The sink must accept
+ *        being called from that thread. When the buffer is full, normal
+ *        and error messages are printed by the calling thread and the others
+ *        are dropped. Messages are also printed by the calling thread once
+ *        the logging thread is stopped, or if SYNC_LOGGING is defined.
  * 
  * @param print_type Specify the type of the message, can be PRINT_ERR, PRINT_WARN, PRINT_INFO or PRINT_NEUTRAL
  * @param format The format of the message
@@ -84,4 +108,11 @@ typedef enum {
  */
 void printInfo(print_type_t print_type, const char* format, ...);
 
+/**
+ * @brief Wait until the messages printed so far have been sent to their
+ *        sink. Called before a sink is changed or destroyed, and at exit.
+ * 
+ */
+void printFlush(void);
+
 #endif // LOGGING_H
@@ -0,0 +1,95 @@
+/**
+ * @file nfclazy.h
+ * @author OUSSET Gaël
+ * @brief Header file for nfclazy.c, lazily evaluated NFC signals
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef NFCLAZY_H
+#define NFCLAZY_H
+
+#include "nfcsig.h"
+#include "scatter.h"
+#include <stdint.h>
+
+//========== Structures declarations
+/**
+ * @brief NFC signal evaluated on demand. No sample is stored, any range of
+ *        the signal is computed directly from the data and the parameters.
+ * 
+ */
+typedef struct nfc_lazySignal {
+    nfc_sigParam_t sigParam;                     // Parameters of the signal (owns a copy of the data)
+    uint64_t       seed;                         // Seed of the noise, drawn per sample index
+    size_t         subModulatedSize;             // Number of sub-modulated symbols
+    unsigned int   symboleDuration;              // Duration of a sub-modulated symbol (ns)
+    unsigned int   transTime;                    // Transition time of the envelope (points)
+    double         modulationDepth;              // Depth of the modulation
+} *nfc_lazySig_t;
+
+//========== Functions
+/**
+ * @brief Create a lazily evaluated signal.
+ *        Without noise, the samples are the same as the ones generated by
+ *        nfc_createSignal(). The noise is drawn from a counter-based generator
+ *        keyed by the sample index, so the same sample always gets the same
+ *        noise whatever the requested range.
+ * 
+ * @param sigParam Parameters of the signal (simDuration must be set)
+ * @param seed Seed of the noise
+ * @param lazySig Created lazy signal
+ * @return int - 0 if success, -1 otherwise
+ */
+int nfc_lazyCreate(nfc_sigParam_t* sigParam, uint64_t seed, nfc_lazySig_t* lazySig);
+
+/**
+ * @brief Destroy a lazily evaluated signal
+ * 
+ * @param lazySig Lazy signal to destroy
+ */
+void nfc_lazyDestroy(nfc_lazySig_t lazySig);
+
+/**
+ * @brief Return the time of a sample
+ * 
+ * @param lazySig Lazy signal
+ * @param index Index of the sample
+ * @return int - Time of the sample (ns)
+ */
+int nfc_lazyGetX(nfc_lazySig_t lazySig, size_t index);
+
+/**
+ * @brief Compute a single sample of the signal
+ * 
+ * @param lazySig Lazy signal
+ * @param index Index of the sample, below the number of points
+ * @return double - Amplitude of the sample, NAN if out of the signal
+ */
+double nfc_lazyGetY(nfc_lazySig_t lazySig, size_t index);
+
+/**
+ * @brief Return the index of the first sample of a bit of the data. The
+ *        symbol index follows from the time, so no sample is computed.
+ * 
+ * @param lazySig Lazy signal
+ * @param bit Index of the bit in the data (LSB first)
+ * @return size_t - Index of the first sample of the bit
+ */
+size_t nfc_lazyBitIndex(nfc_lazySig_t lazySig, size_t bit);
+
+/**
+ * @brief Compute the samples [first, last) of the signal
+ * 
+ * @param lazySig Lazy signal
+ * @param first Index of the first sample
+ * @param last Index after the last sample, at most the number of points
+ * @param signal Computed samples (amplitude vs time in ns)
+ * @return int - 0 if success, -1 otherwise
+ */
+int nfc_lazyRange(nfc_lazySig_t lazySig, size_t first, size_t last, scatter_t* signal);
+
+#endif // NFCLAZY_H
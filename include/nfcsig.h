@@ -82,6 +82,60 @@ typedef enum {
  */
 int nfc_autoSimTime(nfc_sigParam_t* sigParam);
 
+/**
+ * @brief Check the consistency of the parameters of a signal, except the data
+ * 
+ * @param sigParam Parameters of the signal
+ * @return int - 0 if the parameters are valid, -1 otherwise
+ */
+int nfc_checkParam(nfc_sigParam_t* sigParam);
+
+//========== Symbol access
+/**
+ * @brief Return the number of symbols produced by the sub-carrier modulation
+ * 
+ * @param sigParam Parameters of the signal
+ * @return size_t - Number of sub-modulated symbols, 0 if the parameters are invalid
+ */
+size_t nfc_subModulatedSize(nfc_sigParam_t* sigParam);
+
+/**
+ * @brief Return one encoded symbol without encoding the whole data.
+ *        Gives the same value as nfc_encodeData()'s output at the same index.
+ * 
+ * @param sigParam Parameters of the signal
+ * @param index Index of the encoded symbol (4 symbols per bit)
+ * @return char - Value of the symbol (0 or 1)
+ */
+char nfc_encodedSymbol(nfc_sigParam_t* sigParam, size_t index);
+
+/**
+ * @brief Return one sub-modulated symbol without modulating the whole data.
+ *        Gives the same value as nfc_modulateSubCarrier()'s output at the same
+ *        index.
+ * 
+ * @param sigParam Parameters of the signal
+ * @param index Index of the sub-modulated symbol
+ * @return char - Value of the symbol (0 or 1)
+ */
+char nfc_subModulatedSymbol(nfc_sigParam_t* sigParam, size_t index);
+
+/**
+ * @brief Return the duration of a sub-modulated symbol
+ * 
+ * @param sigParam Parameters of the signal
+ * @return unsigned int - Duration of a symbol (ns)
+ */
+unsigned int nfc_symbolDuration(nfc_sigParam_t* sigParam);
+
+/**
+ * @brief Return the length of the envelope transition (2 carrier periods)
+ * 
+ * @param sigParam Parameters of the signal
+ * @return unsigned int - Transition time in points
+ */
+unsigned int nfc_transitionTime(nfc_sigParam_t* sigParam);
+
 //========== Signal coding
 /**
  * @brief Convert a serie of bytes into encoded bits.
@@ -92,7 +146,7 @@ int nfc_autoSimTime(nfc_sigParam_t* sigParam);
  * Output bits : || out[0] | out[1] | out[2] | out[3] || out[4] | out[5] | out[6] | out[7] ||
  * 
  * @param sigParam Parameters of the signal
- * @param encodedData Encoded data
+ * @param encodedData Encoded data, to free with nfc_free()
  * @param encodedSize Size of the encoded data (4*size)
  * @return int - 0 if success, -1 otherwise
  */
@@ -106,7 +160,7 @@ int nfc_encodeData(nfc_sigParam_t* sigParam, char** encodedData, size_t* encoded
  * @param encodeData Data to modulate
  * @param encodedSize Size of the data
  * @param sigParam Parameters of the signal
- * @param subModulatedData Modulated data
+ * @param subModulatedData Modulated data, to free with nfc_free()
  * @param subModulatedSize Size of the modulated data
  * @return int - 0 if success, -1 otherwise
  */
@@ -135,6 +189,26 @@ int nfc_createEnvelope(char* subModulatedData, size_t subModulatedSize, nfc_sigP
  */
 int nfc_modulate(scatter_t enveloppe, nfc_sigParam_t* sigParam, scatter_t* modulatedSignal);
 
+/**
+ * @brief Modulate the enveloppe into a cloud of points owned by the caller
+ * 
+ * @param enveloppe Enveloppe of the signal to modulate (amplitude vs time in ns)
+ * @param sigParam Parameters of the signal
+ * @param modulatedSignal Modulated signal, same size as the enveloppe. Can be
+ *                        the enveloppe itself
+ * @return int - 0 if success, -1 otherwise
+ */
+int nfc_modulateInto(scatter_t enveloppe, nfc_sigParam_t* sigParam, scatter_t modulatedSignal);
+
+/**
+ * @brief Modulate the enveloppe in place
+ * 
+ * @param signal Enveloppe of the signal, replaced by the modulated signal
+ * @param sigParam Parameters of the signal
+ * @return int - 0 if success, -1 otherwise
+ */
+int nfc_modulateInPlace(scatter_t signal, nfc_sigParam_t* sigParam);
+
 //========== Noise
 /**
  * @brief Add noice to a signal
@@ -146,6 +220,26 @@ int nfc_modulate(scatter_t enveloppe, nfc_sigParam_t* sigParam, scatter_t* modul
  */
 int nfc_addNoise(scatter_t signal, nfc_sigParam_t* sigParam, scatter_t* noisySignal);
 
+/**
+ * @brief Add noise to a signal into a cloud of points owned by the caller
+ * 
+ * @param signal Signal to add noise to (amplitude vs time in ns)
+ * @param sigParam Parameters of the signal
+ * @param noisySignal Noisy signal, same size as the signal. Can be the
+ *                    signal itself
+ * @return int - 0 if success, -1 otherwise
+ */
+int nfc_addNoiseInto(scatter_t signal, nfc_sigParam_t* sigParam, scatter_t noisySignal);
+
+/**
+ * @brief Add noise to a signal in place
+ * 
+ * @param signal Signal to add noise to, replaced by the noisy signal
+ * @param sigParam Parameters of the signal
+ * @return int - 0 if success, -1 otherwise
+ */
+int nfc_addNoiseInPlace(scatter_t signal, nfc_sigParam_t* sigParam);
+
 //========== General function
 /**
  * @brief Generate an NFC signal
@@ -156,6 +250,21 @@ int nfc_addNoise(scatter_t signal, nfc_sigParam_t* sigParam, scatter_t* noisySig
  */
 int nfc_createSignal(nfc_sigParam_t* sigParam, scatter_t* signal);
 
+/**
+ * @brief Fill the parameters of a standard NFC signal
+ * 
+ * @param data Data to encode
+ * @param size Size of the data in bytes
+ * @param standard NFC standard to use (A or B)
+ * @param dataTransm Data transmission mode (PCD or PICC)
+ * @param bitRate Bit rate of the input data (bit/s)
+ * @param noiseLevel Signal to noise ratio between 0 and 1
+ * @param numberOfPoints Number of points to generate
+ * @param sigParam Parameters of the signal
+ * @return int - 0 if success, -1 otherwise
+ */
+int nfc_standardParam(char* data, size_t size, nfc_standard_t standard, nfc_dataTransm_t dataTransm, unsigned int bitRate, double noiseLevel, unsigned int numberOfPoints, nfc_sigParam_t* sigParam);
+
 /**
  * @brief Generate a standard NFC signal
  * 
@@ -18,5 +18,10 @@
 #include "FFT.h"
 #include "CSV.h"
 #include "demod.h"
+#include "ber.h"
+#include "sweep.h"
+#include "partial.h"
+#include "profile.h"
+#include "trace.h"
 
 #endif // NFCSIM_H
\ No newline at end of file
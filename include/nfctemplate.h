@@ -0,0 +1,75 @@
+/**
+ * @file nfctemplate.h
+ * @author OUSSET Gaël
+ * @brief Header file for nfctemplate.c, synthesis of NFC envelopes from
+ *        precomputed transition ramps
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef NFCTEMPLATE_H
+#define NFCTEMPLATE_H
+
+#include "nfcsig.h"
+#include "scatter.h"
+
+//========== Structures declarations
+/**
+ * @brief Transitions of the envelope of a parameter set.
+ *        The symbols are placed as nfc_createEnvelope() does, every symbol
+ *        duration rounded down to the ns. When the window of a point (the
+ *        transition time) covers at most two runs of equal symbols, its
+ *        average only depends on the level of the last run and on the
+ *        number of points of the window in the previous one, so it is read
+ *        from a ramp of transTime+1 values per level.
+ * 
+ */
+typedef struct nfc_template {
+    nfc_sigParam_t sigParam;                     // Parameters the templates are built for (no data)
+    size_t         nbSymbols;                    // Number of sub-modulated symbols
+    unsigned int   symbolDuration;               // Duration of a symbol (ns)
+    unsigned int   transTime;                    // Transition time (points)
+    double         levels[2];                    // Level of a symbol at 0 and at 1
+    double*        ramps;                        // Ramps towards each level, transTime+1 values per level
+} *nfc_template_t;
+
+//========== Functions
+/**
+ * @brief Precompute the transitions of a parameter set.
+ *        Value c of the ramp towards level b is the average of a window
+ *        whose c first points are at the other level, summed in the order
+ *        of its points as nfc_createEnvelope() does. The data and the noise
+ *        level of the parameters are not used: create the templates once
+ *        and keep them for every data of the same size.
+ * 
+ * @param sigParam Parameters of the signal (simDuration must be set)
+ * @param tpl Created templates
+ * @return int - 0 if success, -1 otherwise
+ */
+int nfc_templateCreate(nfc_sigParam_t* sigParam, nfc_template_t* tpl);
+
+/**
+ * @brief Destroy precomputed transitions
+ * 
+ * @param tpl Templates to destroy
+ */
+void nfc_templateDestroy(nfc_template_t tpl);
+
+/**
+ * @brief Generate a signal from the templates, then modulate it and add
+ *        noise as nfc_createSignal() does, which gives the same signal.
+ *        The carrier is not part of the templates: with the standard
+ *        frequencies its period never divides the symbol duration, so its
+ *        phase differs at each symbol.
+ * 
+ * @param tpl Templates built for the same parameters
+ * @param sigParam Parameters of the signal (data and noise level)
+ * @param signal Generated signal (amplitude vs time in ns)
+ * @return int - 0 if success, -1 otherwise
+ */
+int nfc_templateSignal(nfc_template_t tpl, nfc_sigParam_t* sigParam, scatter_t* signal);
+
+#endif // NFCTEMPLATE_H
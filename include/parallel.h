@@ -0,0 +1,58 @@
+/**
+ * @file parallel.h
+ * @author OUSSET Gaël
+ * @brief Split a loop into chunks processed by several threads
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "config.h"
+#include <stdlib.h>
+
+/**
+ * @brief Task applied on a chunk [first, last) of a loop
+ * 
+ * @param arg Argument shared by all the chunks
+ * @param first First index of the chunk
+ * @param last Index after the last one of the chunk
+ */
+typedef void (*parallel_task_t)(void* arg, size_t first, size_t last);
+
+/**
+ * @brief Return the number of threads to use, see NB_THREADS
+ * 
+ * @return unsigned int - Number of threads (at least 1)
+ */
+unsigned int parallel_nbThreads(void);
+
+/**
+ * @brief Force the number of threads of parallel_for(), to check that the
+ *        results do not depend on it. Should not be called while other
+ *        threads are running the library.
+ * 
+ * @param nbThreads Number of threads, 0 to come back to NB_THREADS
+ */
+void parallel_setNbThreads(unsigned int nbThreads);
+
+/**
+ * @brief Split [0, size) into contiguous chunks and run the task on each of
+ *        them concurrently. The calling thread processes the first chunk.
+ *        The other chunks run in the context and the stage of the caller,
+ *        see nfc_contextShare(). Falls back on a single call if threads
+ *        cannot be created, and when called from a task of another loop.
+ * 
+ * @param size Number of iterations
+ * @param minChunk Minimum number of iterations per chunk
+ * @param task Task to apply on each chunk
+ * @param arg Argument given to the task
+ * @return int - 0 if success, -1 otherwise
+ */
+int parallel_for(size_t size, size_t minChunk, parallel_task_t task, void* arg);
+
+#endif // PARALLEL_H
@@ -0,0 +1,269 @@
+/**
+ * @file partial.h
+ * @author OUSSET Gaël
+ * @brief Header file for partial.c, partial results of the shards of a run
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * A long run is split into N shards selected with "--shard i/N", each one
+ * processing a contiguous range of the items of the run, possibly in
+ * another process or on another machine. A shard writes its partial
+ * results to a text file, holding the tool and the configuration that
+ * produced it, the shards it covers and named entries:
+ *  - counts: integers, added by the merge (counters, histograms),
+ *  - sums: sums of doubles kept exactly, added by the merge,
+ *  - values: constants that must be the same in every shard (axes),
+ *  - rows: lines of a table, concatenated by the merge and sorted on
+ *    their first column.
+ * The sums are fixed point integers covering the whole range of the
+ * doubles, so the merge gives the same bits whatever the split of the run.
+ * 
+ * Layout:
+ *   NFCSIM-PARTIAL <version>
+ *   tool <name>
+ *   config <configuration, up to the end of the line>
+ *   shards <N> <number of shards> <index>...
+ *   counts <name> <size>        then one integer per line
+ *   sums <name> <size>          then per line: first limb, number of limbs, limbs
+ *   values <name> <size>        then one double per line
+ *   rows <name> <columns> <rows> then the names of the columns, then a row per line
+ *   end
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef PARTIAL_H
+#define PARTIAL_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Version of the layout of the partial result files
+ */
+#define PARTIAL_VERSION 1
+
+/**
+ * Number of 32 bits limbs of an exact sum: the lowest bit is the smallest
+ * subnormal double (2^-1074), with room for the carries above the largest
+ */
+#define PARTIAL_SUM_LIMBS 68
+
+/**
+ * Number of additions to an exact sum between two propagations of the
+ * carries
+ */
+#define PARTIAL_SUM_PENDING (1U << 29)
+
+/**
+ * Maximum length of the names and of the configuration
+ */
+#define PARTIAL_MAX_NAME 1024
+
+//========== Structures declarations
+/**
+ * @brief Shard of a run: the index-th of count parts, 0 <= index < count
+ * 
+ */
+typedef struct {
+    unsigned int index;                          // Index of the shard
+    unsigned int count;                          // Number of shards of the run
+} shard_t;
+
+/**
+ * @brief Exact sum of doubles, a fixed point integer in base 2^32. All
+ *        the limbs but the last one are in [0, 2^32) once the carries are
+ *        propagated.
+ * 
+ */
+typedef struct {
+    int64_t  limbs[PARTIAL_SUM_LIMBS];           // Limbs, the first one is the least significant
+    uint32_t pending;                            // Additions since the last propagation of the carries
+} partial_sum_t;
+
+/**
+ * @brief Kind of entry of partial results
+ * 
+ */
+typedef enum {
+    PARTIAL_COUNTS,                              // Integers, added
+    PARTIAL_SUMS,                                // Exact sums, added
+    PARTIAL_VALUES,                              // Constants, checked
+    PARTIAL_ROWS,                                // Rows of a table, concatenated
+    NB_PARTIAL_KINDS
+} partial_kind_t;
+
+/**
+ * @brief Named entry of partial results
+ * 
+ */
+typedef struct {
+    char*          name;                         // Name of the entry
+    partial_kind_t kind;                         // Kind of the entry
+    size_t         size;                         // Number of values, or of columns of the rows
+    uint64_t*      counts;                       // Values of PARTIAL_COUNTS
+    partial_sum_t* sums;                         // Values of PARTIAL_SUMS
+    double*        values;                       // Values of PARTIAL_VALUES, rows of PARTIAL_ROWS
+    char**         columns;                      // Names of the columns of PARTIAL_ROWS
+    size_t         nbRows;                       // Number of rows of PARTIAL_ROWS
+    size_t         capacity;                     // Allocated rows of PARTIAL_ROWS
+} partial_entry_t;
+
+/**
+ * @brief Partial results of one or more shards of a run
+ * 
+ */
+typedef struct partial {
+    char*            tool;                       // Tool of the run
+    char*            config;                     // Configuration of the run
+    unsigned int     nbShards;                   // Number of shards of the run
+    unsigned char*   shards;                     // 1 for each shard covered by the results
+    partial_entry_t* entries;                    // Entries of the results
+    size_t           nbEntries;                  // Number of entries
+} *partial_t;
+
+//========== Functions
+/**
+ * @brief Parse a shard given as "i/N"
+ * 
+ * @param text Text of the shard
+ * @param shard Parsed shard
+ * @return int - 0 if success, -1 otherwise
+ */
+int shard_parse(const char* text, shard_t* shard);
+
+/**
+ * @brief Return the range of the items of a run processed by a shard
+ * 
+ * @param shard Shard
+ * @param size Number of items of the run
+ * @param first First item of the shard
+ * @param last Item after the last one of the shard
+ */
+void shard_range(const shard_t* shard, size_t size, size_t* first, size_t* last);
+
+/**
+ * @brief Add a finite double to an exact sum
+ * 
+ * @param sum Exact sum
+ * @param value Value to add
+ * @return int - 0 if success, -1 if the value is not finite
+ */
+int partial_sumAdd(partial_sum_t* sum, double value);
+
+/**
+ * @brief Return the double closest to an exact sum, the same for the same
+ *        exact sum
+ * 
+ * @param sum Exact sum
+ * @return double - Value of the sum
+ */
+double partial_sumValue(partial_sum_t* sum);
+
+/**
+ * @brief Create empty partial results
+ * 
+ * @param tool Tool of the run
+ * @param config Configuration of the run, the merged results must have the same
+ * @param shard Shard covered by the results
+ * @param partial Created results
+ * @return int - 0 if success, -1 otherwise
+ */
+int partial_create(const char* tool, const char* config, const shard_t* shard, partial_t* partial);
+
+/**
+ * @brief Destroy partial results
+ * 
+ * @param partial Results to destroy
+ */
+void partial_destroy(partial_t partial);
+
+/**
+ * @brief Return an entry, created empty (zeros, no row) if needed. The
+ *        entry is valid until another entry is created.
+ * 
+ * @param partial Results
+ * @param name Name of the entry
+ * @param kind Kind of the entry
+ * @param size Number of values, or of columns of the rows
+ * @param entry Entry
+ * @return int - 0 if success, -1 if an entry of the name has another kind or size
+ */
+int partial_entry(partial_t partial, const char* name, partial_kind_t kind, size_t size, partial_entry_t** entry);
+
+/**
+ * @brief Return an existing entry
+ * 
+ * @param partial Results
+ * @param name Name of the entry
+ * @return partial_entry_t* - Entry, NULL if not found
+ */
+partial_entry_t* partial_find(partial_t partial, const char* name);
+
+/**
+ * @brief Name the columns of an entry of rows
+ * 
+ * @param entry Entry of rows
+ * @param columns Names of the columns, size of the entry
+ * @return int - 0 if success, -1 otherwise
+ */
+int partial_setColumns(partial_entry_t* entry, const char** columns);
+
+/**
+ * @brief Append a row to an entry of rows
+ * 
+ * @param entry Entry of rows
+ * @param row Values of the row, size of the entry
+ * @return int - 0 if success, -1 otherwise
+ */
+int partial_addRow(partial_entry_t* entry, const double* row);
+
+/**
+ * @brief Add partial results to others of the same run, the rows sorted
+ *        on their first column
+ * 
+ * @param partial Results, receive the other ones
+ * @param other Results of other shards
+ * @return int - 0 if success, -1 if the results are not of the same run or share shards
+ */
+int partial_merge(partial_t partial, partial_t other);
+
+/**
+ * @brief Tell if partial results cover all the shards of the run
+ * 
+ * @param partial Results
+ * @return int - 1 if complete, 0 otherwise
+ */
+int partial_complete(partial_t partial);
+
+/**
+ * @brief Write partial results to a file, the rows sorted on their first
+ *        column
+ * 
+ * @param partial Results
+ * @param filename Name of the file
+ * @return int - 0 if success, -1 otherwise
+ */
+int partial_write(partial_t partial, const char* filename);
+
+/**
+ * @brief Read partial results from a file
+ * 
+ * @param filename Name of the file
+ * @param partial Read results
+ * @return int - 0 if success, -1 otherwise
+ */
+int partial_read(const char* filename, partial_t* partial);
+
+/**
+ * @brief Read and merge partial result files
+ * 
+ * @param filenames Names of the files
+ * @param nbFiles Number of files
+ * @param partial Merged results
+ * @return int - 0 if success, -1 otherwise
+ */
+int partial_readAll(const char** filenames, size_t nbFiles, partial_t* partial);
+
+#endif // PARTIAL_H
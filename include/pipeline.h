@@ -0,0 +1,124 @@
+/**
+ * @file pipeline.h
+ * @author OUSSET Gaël
+ * @brief Header file for pipeline.c, incremental generation of NFC signals
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "nfcsig.h"
+#include "scatter.h"
+
+//========== Structures declarations
+/**
+ * @brief Stages of the generation of a signal, in order
+ * 
+ */
+typedef enum {
+    STAGE_ENCODE,                                // nfc_encodeData()
+    STAGE_SUBCARRIER,                            // nfc_modulateSubCarrier()
+    STAGE_ENVELOPE,                              // nfc_createEnvelope()
+    STAGE_MODULATE,                              // nfc_modulate()
+    STAGE_NOISE,                                 // nfc_addNoise()
+    NB_STAGES                                    // Number of stages
+} nfc_stage_t;
+
+/**
+ * @brief Fields of nfc_sigParam_t, as bits of a mask
+ * 
+ */
+typedef enum {
+    FIELD_DATA             = 1 << 0,             // Content of the data
+    FIELD_DATA_SIZE        = 1 << 1,
+    FIELD_BIT_RATE         = 1 << 2,
+    FIELD_ENCODING_TYPE    = 1 << 3,
+    FIELD_SUB_MODULATION   = 1 << 4,
+    FIELD_SUB_CARRIER_FREQ = 1 << 5,
+    FIELD_CARRIER_FREQ     = 1 << 6,
+    FIELD_MODULATION_INDEX = 1 << 7,
+    FIELD_NOISE_LEVEL      = 1 << 8,
+    FIELD_SIM_DURATION     = 1 << 9,
+    FIELD_NUMBER_OF_POINTS = 1 << 10
+} nfc_field_t;
+
+/**
+ * @brief Generation pipeline keeping the output of each stage. When the
+ *        parameters change, only the stages depending on a changed field,
+ *        and the ones after them, are run again.
+ * 
+ */
+typedef struct nfc_pipeline {
+    nfc_sigParam_t sigParam;                     // Parameters of the cached outputs
+    char*          data;                         // Copy of the data of the cached outputs
+    char           valid[NB_STAGES];             // 1 if the output of the stage is up to date
+    unsigned long  nbRuns[NB_STAGES];            // Number of times each stage was run
+    char*          encodedData;                  // Output of STAGE_ENCODE
+    size_t         encodedSize;
+    char*          subModulatedData;             // Output of STAGE_SUBCARRIER
+    size_t         subModulatedSize;
+    scatter_t      envelope;                     // Output of STAGE_ENVELOPE
+    scatter_t      modulatedSignal;              // Output of STAGE_MODULATE
+    scatter_t      noisySignal;                  // Output of STAGE_NOISE
+} *nfc_pipeline_t;
+
+//========== Functions
+/**
+ * @brief Return the fields of the parameters a stage depends on directly
+ * 
+ * @param stage Stage of the pipeline
+ * @return unsigned int - Mask of nfc_field_t
+ */
+unsigned int nfc_stageDependencies(nfc_stage_t stage);
+
+/**
+ * @brief Create an empty pipeline
+ * 
+ * @param pipeline Created pipeline
+ * @return int - 0 if success, -1 otherwise
+ */
+int nfc_pipelineCreate(nfc_pipeline_t* pipeline);
+
+/**
+ * @brief Destroy a pipeline and its cached outputs
+ * 
+ * @param pipeline Pipeline to destroy
+ */
+void nfc_pipelineDestroy(nfc_pipeline_t pipeline);
+
+/**
+ * @brief Return the fields that differ from the parameters of the cached
+ *        outputs
+ * 
+ * @param pipeline Pipeline
+ * @param sigParam New parameters
+ * @return unsigned int - Mask of nfc_field_t
+ */
+unsigned int nfc_pipelineChanges(nfc_pipeline_t pipeline, nfc_sigParam_t* sigParam);
+
+/**
+ * @brief Mark a stage, and the ones after it, as out of date. Used to draw a
+ *        new noise with the same parameters.
+ * 
+ * @param pipeline Pipeline
+ * @param stage First stage to run again
+ */
+void nfc_pipelineInvalidate(nfc_pipeline_t pipeline, nfc_stage_t stage);
+
+/**
+ * @brief Generate a signal, running only the out of date stages
+ * 
+ * @param pipeline Pipeline
+ * @param sigParam Parameters of the signal
+ * @param signal Generated signal, owned by the pipeline and valid until the
+ *               next run or the destruction of the pipeline
+ * @return int - 0 if success, -1 otherwise
+ */
+int nfc_pipelineRun(nfc_pipeline_t pipeline, nfc_sigParam_t* sigParam, scatter_t* signal);
+
+#endif // PIPELINE_H
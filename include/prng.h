@@ -0,0 +1,50 @@
+/**
+ * @file prng.h
+ * @author OUSSET Gaël
+ * @brief Counter-based pseudo-random number generator. The functions are
+ *        inline so that the loops drawing noise can be vectorised.
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef PRNG_H
+#define PRNG_H
+
+#include <stdint.h>
+
+/**
+ * @brief Return a pseudo-random 64 bits value from a seed and a counter.
+ *        The same (seed, counter) pair always gives the same value, so any
+ *        element of a random sequence can be drawn without the previous ones.
+ * 
+ * @param seed Seed of the sequence
+ * @param counter Index of the value in the sequence
+ * @return uint64_t - Pseudo-random value
+ */
+static inline uint64_t prng_hash(uint64_t seed, uint64_t counter) {
+    //========== Variables declaration
+    uint64_t z;                                  // Mixed value
+
+    //========== SplitMix64 finalizer applied on the counter
+    z = seed + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Return a pseudo-random value uniformly distributed in [0, 1)
+ * 
+ * @param seed Seed of the sequence
+ * @param counter Index of the value in the sequence
+ * @return double - Pseudo-random value in [0, 1)
+ */
+static inline double prng_uniform(uint64_t seed, uint64_t counter) {
+    // Keep the 53 most significant bits to fill the mantissa
+    return (double)(prng_hash(seed, counter) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+#endif // PRNG_H
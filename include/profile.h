@@ -0,0 +1,212 @@
+/**
+ * @file profile.h
+ * @author OUSSET Gaël
+ * @brief Attribution of the work of the library to the pipeline stages and
+ *        timing of the stages
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "config.h"
+#include "logging.h"
+#include <stddef.h>
+#include <stdint.h>
+
+//========== Structures declarations
+/**
+ * @brief Stages the work of the library is attributed to
+ * 
+ */
+typedef enum {
+    PROF_OTHER,                                  // Outside of any stage
+    PROF_ENCODE,                                 // nfc_encodeData()
+    PROF_SUBCARRIER,                             // nfc_modulateSubCarrier()
+    PROF_ENVELOPE,                               // nfc_createEnvelope()
+    PROF_MODULATE,                               // nfc_modulate()
+    PROF_NOISE,                                  // nfc_addNoise()
+    PROF_FFT,                                    // fft_Compute(), fft_Iterative()
+    PROF_LCADC,                                  // LCADC()
+    PROF_DEMOD,                                  // demod_frame()
+    PROF_CSV,                                    // writeCSV()
+    NB_PROF_STAGES                               // Number of stages
+} prof_stage_t;
+
+/**
+ * @brief Hardware counters sampled around the stages
+ * 
+ */
+typedef enum {
+    PROF_CYCLES,                                 // CPU cycles
+    PROF_INSTRUCTIONS,                           // Retired instructions
+    PROF_L1D_MISSES,                             // L1 data cache read misses
+    PROF_LLC_MISSES,                             // Last level cache misses
+    PROF_BRANCH_MISSES,                          // Mispredicted branches
+    NB_PROF_COUNTERS                             // Number of counters
+} prof_counter_t;
+
+/**
+ * @brief Hardware counters opened by a thread, see prof_countersOpen
+ * 
+ */
+typedef struct prof_counters prof_counters_t;
+
+/**
+ * @brief Scope of a stage, restored when the function returns
+ * 
+ */
+typedef struct {
+    prof_stage_t stage;                          // Stage of the scope
+    prof_stage_t previous;                       // Stage before the scope
+#ifndef NO_PROFILING
+    const char*  name;                           // Function of the scope
+    uint64_t     start;                          // Time the scope was entered (ns), 0 if not timed
+    uint64_t     counters[NB_PROF_COUNTERS];    // Hardware counters when the scope was entered
+#endif
+} prof_scope_t;
+
+/**
+ * @brief Time spent in a stage and data it processed
+ * 
+ */
+typedef struct {
+    unsigned long nbCalls;                       // Number of timed calls
+    uint64_t      time;                          // Time spent in the stage (ns)
+    uint64_t      nbSamples;                     // Number of samples processed
+    uint64_t      nbBytes;                       // Number of bytes processed
+    uint64_t      counters[NB_PROF_COUNTERS];    // Hardware counters, see prof_countersOpen
+} prof_stats_t;
+
+//========== Macros
+/**
+ * @brief Attribute the rest of the enclosing function to a stage. The
+ *        previous stage is restored on every return path.
+ * 
+ * @param STAGE Stage of the function (prof_stage_t)
+ */
+#define PROFILE_STAGE(STAGE) \
+    prof_scope_t prof_scope __attribute__((cleanup(prof_leave))) = prof_enter(STAGE, __func__)
+
+/**
+ * @brief Count the samples and bytes processed by the current stage
+ * 
+ * @param NB_SAMPLES Number of samples processed
+ * @param NB_BYTES Number of bytes processed
+ */
+#ifdef NO_PROFILING
+    #define PROFILE_COUNT(NB_SAMPLES, NB_BYTES) ((void)0)
+#else
+    #define PROFILE_COUNT(NB_SAMPLES, NB_BYTES) prof_count(NB_SAMPLES, NB_BYTES)
+#endif
+
+//========== Functions
+/**
+ * @brief Return the name of a stage
+ * 
+ * @param stage Stage
+ * @return const char* - Name of the stage
+ */
+const char* prof_stageName(prof_stage_t stage);
+
+/**
+ * @brief Read the monotonic clock
+ * 
+ * @return uint64_t - Time (ns), never 0
+ */
+uint64_t prof_now(void);
+
+/**
+ * @brief Enter a stage in the current context, see PROFILE_STAGE
+ * 
+ * @param stage Stage to enter
+ * @param name Name of the function entering the stage, shown by the tracer
+ * @return prof_scope_t - Scope of the stage
+ */
+prof_scope_t prof_enter(prof_stage_t stage, const char* name);
+
+/**
+ * @brief Leave a stage in the current context, see PROFILE_STAGE
+ * 
+ * @param scope Scope of the stage
+ */
+void prof_leave(prof_scope_t* scope);
+
+/**
+ * @brief Count the samples and bytes processed by the current stage, see
+ *        PROFILE_COUNT
+ * 
+ * @param nbSamples Number of samples processed
+ * @param nbBytes Number of bytes processed
+ */
+void prof_count(size_t nbSamples, size_t nbBytes);
+
+/**
+ * @brief Return the timing of a stage in the current context. The time of
+ *        a stage includes the stages it calls, a stage calling itself is
+ *        timed once.
+ * 
+ * @param stage Stage
+ * @return prof_stats_t - Timing of the stage, zero if NO_PROFILING is defined
+ */
+prof_stats_t prof_stats(prof_stage_t stage);
+
+/**
+ * @brief Clear the timings of the current context
+ * 
+ */
+void prof_reset(void);
+
+/**
+ * @brief Open the hardware counters of the calling thread in the current
+ *        context. The threads it creates afterwards are counted once they
+ *        are joined. Counters the system does not permit are left out.
+ *        Linux only (perf_event_open).
+ * 
+ * @return int - 0 if at least one counter is opened, -1 otherwise
+ */
+int prof_countersOpen(void);
+
+/**
+ * @brief Close the hardware counters of the current context
+ * 
+ */
+void prof_countersClose(void);
+
+/**
+ * @brief Close hardware counters, used by nfc_contextDestroy
+ * 
+ * @param counters Counters to close, may be NULL
+ */
+void prof_countersDestroy(prof_counters_t* counters);
+
+/**
+ * @brief Tell whether a hardware counter is sampled in the current context
+ * 
+ * @param counter Counter
+ * @return int - 1 if the counter is sampled, 0 otherwise
+ */
+int prof_counterAvailable(prof_counter_t counter);
+
+/**
+ * @brief Print the time, samples/s and bytes/s of each stage of the current
+ *        context, and the IPC and misses per sample when hardware counters
+ *        are open
+ * 
+ * @param print_type Type of the messages
+ */
+void prof_report(print_type_t print_type);
+
+/**
+ * @brief Print the timings of the thread calling exit() when the program
+ *        ends
+ * 
+ * @return int - 0 if success, -1 otherwise
+ */
+int prof_reportAtExit(void);
+
+#endif // PROFILE_H
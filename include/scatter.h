@@ -34,6 +34,8 @@ typedef struct cloudPoint {
     point_t* points;                             // Array of points
     char*    xName;                              // Name of the X axis
     char*    yName;                              // Name of the Y axis
+    void*    mapping;                            // Memory mapping holding the points, NULL if allocated
+    size_t   mappingSize;                        // Size of the memory mapping (bytes)
 } *scatter_t;
 
 //========== Functions for scatter_t
@@ -67,6 +69,32 @@ int scatter_setName(scatter_t scatter, char* xName, char* yName);
  */
 int scatter_createWName(scatter_t* scatter, size_t size, char* xName, char* yName);
 
+/**
+ * @brief Create a cloud of points around existing points
+ * 
+ * @param scatter Pointer to the created cloud of points
+ * @param points Points allocated with nfc_malloc(), owned by the cloud of points on success
+ * @param size Number of points
+ * @return int - 0 if success, -1 otherwise
+ */
+int scatter_createFrom(scatter_t* scatter, point_t* points, size_t size);
+
+#ifndef _WIN32
+/**
+ * @brief Create a cloud of points around points of a memory mapping. The
+ *        points can be modified but not reallocated, the mapping is
+ *        unmapped by scatter_destroy().
+ * 
+ * @param scatter Pointer to the created cloud of points
+ * @param mapping Memory mapping, owned by the cloud of points on success
+ * @param mappingSize Size of the memory mapping (bytes)
+ * @param points Points, inside the mapping
+ * @param size Number of points
+ * @return int - 0 if success, -1 otherwise
+ */
+int scatter_createMapped(scatter_t* scatter, void* mapping, size_t mappingSize, point_t* points, size_t size);
+#endif
+
 /**
  * @brief Destroy a cloud of points
  * 
@@ -0,0 +1,135 @@
+/**
+ * @file sweep.h
+ * @author OUSSET Gaël
+ * @brief Header file for sweep.c, parameter sweeps sharing the stages of the
+ *        generation between the points of a grid
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * A grid is the cartesian product of the values of some fields of the
+ * parameters. Its points are visited with the axes of the earliest stages
+ * varying the slowest, so consecutive points share the outputs of the
+ * stages that do not depend on the inner axes: a noise sweep generates the
+ * clean signal once and only adds noise at each point. The visit is split
+ * into contiguous chunks run on all the cores, each one with its own
+ * nfc_pipeline_t, and the measures of each point are written as soon as
+ * the point is done.
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "nfcsig.h"
+#include "partial.h"
+#include "pipeline.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Maximum number of axes of a grid
+ */
+#define SWEEP_MAX_AXES 8
+
+//========== Structures declarations
+/**
+ * @brief Axis of a grid: values taken by a field of the parameters
+ * 
+ */
+typedef struct {
+    nfc_field_t   field;                         // Swept field, neither the data nor its size
+    const double* values;                        // Values of the field, rounded for the integer fields
+    size_t        nbValues;                      // Number of values
+} sweep_axis_t;
+
+/**
+ * @brief Grid of parameters
+ * 
+ */
+typedef struct {
+    nfc_sigParam_t base;                         // Parameters of the fields that are not swept
+    sweep_axis_t   axes[SWEEP_MAX_AXES];         // Axes of the grid, the last one varies the fastest in the indices
+    size_t         nbAxes;                       // Number of axes
+    uint64_t       seed;                         // Seed of the noise, drawn from prng_hash(seed, index) at each point
+} sweep_grid_t;
+
+/**
+ * @brief Measure of a point of a grid
+ * 
+ * @param user User pointer given to sweep_run()
+ * @param index Index of the point in the grid
+ * @param sigParam Parameters of the point
+ * @param signal Signal of the point, only valid during the call
+ * @param values Measures of the point, nbValues given to sweep_run()
+ * @return int - 0 if success, -1 to stop the sweep
+ */
+typedef int (*sweep_measure_t)(void* user, size_t index, nfc_sigParam_t* sigParam, scatter_t signal, double* values);
+
+//========== Functions
+/**
+ * @brief Return the name of a field, as written in the header of the
+ *        results
+ * 
+ * @param field Field of the parameters
+ * @return const char* - Name of the field, NULL if it cannot be swept
+ */
+const char* sweep_fieldName(nfc_field_t field);
+
+/**
+ * @brief Return the number of points of a grid
+ * 
+ * @param grid Grid
+ * @return size_t - Number of points
+ */
+size_t sweep_size(const sweep_grid_t* grid);
+
+/**
+ * @brief Compute the parameters of a point of a grid. The simulation time
+ *        is computed with nfc_autoSimTime() when it is null in the base and
+ *        not swept.
+ * 
+ * @param grid Grid
+ * @param index Index of the point
+ * @param sigParam Parameters of the point
+ * @return int - 0 if success, -1 otherwise
+ */
+int sweep_point(const sweep_grid_t* grid, size_t index, nfc_sigParam_t* sigParam);
+
+/**
+ * @brief Generate and measure every point of a grid, on all the cores. The
+ *        lines of the results are written in the order the points are
+ *        done: the index of the point, the value of each axis, then the
+ *        measures. The measures run in a context of the worker thread
+ *        forked from the current context, see nfc_contextFork().
+ * 
+ * @param grid Grid
+ * @param measure Measure of a point
+ * @param user User pointer given to the measure
+ * @param nbValues Number of measures of a point
+ * @param valueNames Names of the measures, for the header of the results
+ * @param results Destination of the results (CSV), NULL to only measure
+ * @param nbRuns Number of runs of each stage over all the points, NULL if not needed
+ * @return int - 0 if success, -1 otherwise
+ */
+int sweep_run(const sweep_grid_t* grid, sweep_measure_t measure, void* user, size_t nbValues, const char** valueNames, FILE* results, unsigned long* nbRuns);
+
+/**
+ * @brief Generate and measure the points of a shard of a grid, see
+ *        sweep_run(). The shards are contiguous ranges of the visit, so
+ *        each one keeps the sharing of the stages between its points.
+ * 
+ * @param grid Grid
+ * @param shard Shard of the visit
+ * @param measure Measure of a point
+ * @param user User pointer given to the measure
+ * @param nbValues Number of measures of a point
+ * @param valueNames Names of the measures, for the header of the results
+ * @param results Destination of the results (CSV), NULL to only measure
+ * @param nbRuns Number of runs of each stage over the points of the shard, NULL if not needed
+ * @return int - 0 if success, -1 otherwise
+ */
+int sweep_runShard(const sweep_grid_t* grid, const shard_t* shard, sweep_measure_t measure, void* user, size_t nbValues, const char** valueNames, FILE* results, unsigned long* nbRuns);
+
+#endif // SWEEP_H
@@ -0,0 +1,63 @@
+/**
+ * @file trace.h
+ * @author OUSSET Gaël
+ * @brief Trace of the execution of the library across threads, written as
+ *        trace-event JSON (chrome://tracing, Perfetto)
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "config.h"
+
+//========== Functions
+/**
+ * @brief Clear the recorded events and start recording. Every stage scope
+ *        (PROFILE_STAGE) and every chunk of parallel_for() is recorded.
+ *        Should not be called while other threads are running the library.
+ * 
+ */
+void trace_start(void);
+
+/**
+ * @brief Stop recording, the recorded events are kept
+ * 
+ */
+void trace_stop(void);
+
+/**
+ * @brief Record the beginning of a scope on the calling thread. Each thread
+ *        writes to its own ring buffer without lock, the oldest events are
+ *        overwritten after TRACE_BUFFER_SIZE events.
+ * 
+ * @param name Name of the scope, should live until the trace is written
+ * @param category Category of the scope, should live until the trace is written
+ */
+void trace_begin(const char* name, const char* category);
+
+/**
+ * @brief Record the end of a scope on the calling thread, see trace_begin
+ * 
+ * @param name Name of the scope
+ * @param category Category of the scope
+ */
+void trace_end(const char* name, const char* category);
+
+/**
+ * @brief Write the recorded events to a trace-event JSON file. Must only
+ *        be called once the traced threads have stopped running the library
+ *        (workers joined, or tracing stopped and their calls returned): the
+ *        buffers are read without lock. The ends of the scopes whose
+ *        beginning was overwritten in a full buffer are dropped.
+ * 
+ * @param filename Name of the file
+ * @return int - 0 if success, -1 otherwise
+ */
+int trace_write(const char* filename);
+
+#endif // TRACE_H
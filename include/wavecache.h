@@ -0,0 +1,134 @@
+/**
+ * @file wavecache.h
+ * @author OUSSET Gaël
+ * @brief Header file for wavecache.c, persistent on-disk cache of waveforms
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef WAVECACHE_H
+#define WAVECACHE_H
+
+#include "nfcsig.h"
+#include "scatter.h"
+#include <stdint.h>
+
+//========== Structures declarations
+/**
+ * @brief Kind of cached waveform
+ * 
+ */
+typedef enum {
+    CACHE_SIGNAL,                                // Signal from nfc_createSignal()
+    CACHE_SPECTRUM                               // Spectrum of the signal from fft_Compute()
+} cache_kind_t;
+
+/**
+ * @brief Waveform file of the cache
+ * 
+ */
+typedef struct {
+    uint64_t           key;                      // Key of the waveform
+    unsigned long long size;                     // Size of the file (bytes)
+    unsigned long long lastUse;                  // Use counter at the last read or write
+} cache_entry_t;
+
+/**
+ * @brief On-disk cache of waveforms. Each waveform is a file named after
+ *        the hash of the parameters that produced it. The directory is
+ *        scanned once when the cache is opened, then the files and their
+ *        total size are followed in memory: files written in the directory
+ *        by another process are only counted once they are read.
+ * 
+ */
+typedef struct wavecache {
+    char*              dir;                      // Directory of the cache
+    unsigned long long maxSize;                  // Maximum size of the cache (bytes)
+    unsigned long long size;                     // Size of the waveform files (bytes)
+    cache_entry_t*     entries;                  // Waveform files
+    size_t             nbEntries;                // Number of waveform files
+    size_t             capacity;                 // Number of allocated entries
+    unsigned long long clock;                    // Use counter, the lowest entry is the least recently used
+    unsigned long      nbHits;                   // Number of waveforms read from the cache
+    unsigned long      nbMisses;                 // Number of waveforms computed
+} *wavecache_t;
+
+//========== Functions
+/**
+ * @brief Return the key of a waveform: a hash of all the parameters, the
+ *        data, the kind of waveform and the version of the library
+ * 
+ * @param sigParam Parameters of the signal
+ * @param kind Kind of waveform
+ * @return uint64_t - Key of the waveform
+ */
+uint64_t cache_key(nfc_sigParam_t* sigParam, cache_kind_t kind);
+
+/**
+ * @brief Open a cache, the directory must exist. Its waveform files are
+ *        measured and the least recently used are evicted if it is too big.
+ * 
+ * @param dir Directory of the cache
+ * @param maxSize Maximum size of the cache (bytes)
+ * @param cache Opened cache
+ * @return int - 0 if success, -1 otherwise
+ */
+int cache_open(char* dir, unsigned long long maxSize, wavecache_t* cache);
+
+/**
+ * @brief Close a cache, the files are kept
+ * 
+ * @param cache Cache to close
+ */
+void cache_close(wavecache_t cache);
+
+/**
+ * @brief Read a waveform from the cache. The file is privately
+ *        memory-mapped and the cloud of points uses the mapping (see
+ *        scatter_createMapped()), its points are read from the disk when
+ *        accessed. On Windows the file is read into a new cloud of points.
+ * 
+ * @param cache Cache
+ * @param key Key of the waveform
+ * @param scatter Read waveform
+ * @return int - 0 if found, 1 if not in the cache, -1 on error
+ */
+int cache_load(wavecache_t cache, uint64_t key, scatter_t* scatter);
+
+/**
+ * @brief Write a waveform in the cache, then evict the least recently used
+ *        waveforms if the cache is too big
+ * 
+ * @param cache Cache
+ * @param key Key of the waveform
+ * @param scatter Waveform to write
+ * @return int - 0 if success, -1 otherwise
+ */
+int cache_store(wavecache_t cache, uint64_t key, scatter_t scatter);
+
+/**
+ * @brief Read a signal from the cache, or generate and store it.
+ *        Noisy signals are random and are never cached.
+ * 
+ * @param cache Cache, NULL to always generate the signal
+ * @param sigParam Parameters of the signal
+ * @param signal Signal (amplitude vs time in ns)
+ * @return int - 0 if success, -1 otherwise
+ */
+int cache_signal(wavecache_t cache, nfc_sigParam_t* sigParam, scatter_t* signal);
+
+/**
+ * @brief Read the spectrum of a signal from the cache, or compute and store
+ *        it. Spectra of noisy signals are never cached.
+ * 
+ * @param cache Cache, NULL to always compute the spectrum
+ * @param sigParam Parameters of the signal
+ * @param spectrum Spectrum of the signal (amplitude vs frequency in Hz)
+ * @return int - 0 if success, -1 otherwise
+ */
+int cache_spectrum(wavecache_t cache, nfc_sigParam_t* sigParam, scatter_t* spectrum);
+
+#endif // WAVECACHE_H
@@ -11,118 +11,191 @@
  */
 
 #include "nfcsim.h"
+#include "assert.h"
+#include "wavecache.h"
 #include <string.h>
 
 /**
- * @brief Main function
+ * @brief Averaged modes
  * 
- * @param argc Number of arguments
- * @param argv Arguments
- * @return int - 0 if success
  */
-int main(/*int argc, char *argv[]*/) {
-    scatter_t signal;
-    scatter_t spectres[4][256];
-    scatter_t avgSpectres[4];
+static const struct {
+    nfc_standard_t   standard;                   // NFC standard
+    nfc_dataTransm_t dataTransm;                 // Data transmission mode
+    char*            name;                       // Name of the mode, as written in the CSV file
+    const char*      entry;                      // Entry of the sum of the spectra in the partial results
+} modes[] = {
+    {NFC_A, PCD,  "NFC-A PCD",  "A_PCD"},
+    {NFC_A, PICC, "NFC-A PICC", "A_PICC"},
+    {NFC_B, PCD,  "NFC-B PCD",  "B_PCD"},
+    {NFC_B, PICC, "NFC-B PICC", "B_PICC"}
+};
 
-    for (size_t i = 0; i < 4; i=i+1) {
-        scatter_create(&avgSpectres[i], NB_POINTS);
-        for (size_t j = 0; j < NB_POINTS; j=j+1) {
-            scatter_setX(avgSpectres[i], j, 0);
-            scatter_setY(avgSpectres[i], j, 0);
-        }
-    }
+/**
+ * @brief Compute the spectrum of a standard signal, reading it from the
+ *        waveform cache if possible
+ * 
+ * @param cache Waveform cache, NULL to always compute the spectrum
+ * @param byte Byte to encode
+ * @param standard NFC standard to use (A or B)
+ * @param dataTransm Data transmission mode (PCD or PICC)
+ * @param spectrum Spectrum of the signal
+ * @return int - 0 if success, -1 otherwise
+ */
+static int computeSpectrum(wavecache_t cache, char* byte, nfc_standard_t standard, nfc_dataTransm_t dataTransm, scatter_t* spectrum) {
+    nfc_sigParam_t sigParam;
+
+    if (nfc_standardParam(byte, 1, standard, dataTransm, BIT_RATE, 0, NB_POINTS, &sigParam))
+        return -1;
+
+    return cache_spectrum(cache, &sigParam, spectrum);
+}
 
-    for (size_t i = 0; i < 256; i=i+1) {
-        PRINT(NORM, "Processing byte %d\n", i);
+/**
+ * @brief Sum the spectra of the bytes of a shard, for each mode, in
+ *        partial results
+ * 
+ * @param cache Waveform cache, NULL to always compute the spectra
+ * @param shard Shard of the 256 bytes
+ * @param partial Results of the shard
+ * @return int - 0 if success, -1 otherwise
+ */
+static int sumSpectra(wavecache_t cache, const shard_t* shard, partial_t partial) {
+    partial_entry_t* entry;
+    scatter_t spectrum;
+    size_t first;
+    size_t last;
+
+    // The entries are created first, creating one moves the others
+    if (partial_entry(partial, "spectra", PARTIAL_COUNTS, 1, &entry) ||
+        partial_entry(partial, "frequency", PARTIAL_VALUES, NB_POINTS, &entry))
+        return -1;
+    for (size_t m = 0; m < 4; m=m+1)
+        if (partial_entry(partial, modes[m].entry, PARTIAL_SUMS, NB_POINTS, &entry))
+            return -1;
+
+    shard_range(shard, 256, &first, &last);
+    for (size_t i = first; i < last; i=i+1) {
+        PRINT(NORM, "Processing byte %d", i);
         char byte[] = {(char)i};
-        nfc_standardSignal(
-            byte,
-            1,
-            NFC_A,
-            PCD,
-            BIT_RATE,
-            0,
-            NB_POINTS,
-            &signal
-        );
-        fft_Compute(signal, &spectres[0][i]);
-        scatter_destroy(signal);
-
-        nfc_standardSignal(
-            byte,
-            1,
-            NFC_A,
-            PICC,
-            BIT_RATE,
-            0,
-            NB_POINTS,
-            &signal
-        );
-        fft_Compute(signal, &spectres[1][i]);
-        scatter_destroy(signal);
-
-        nfc_standardSignal(
-            byte,
-            1,
-            NFC_B,
-            PCD,
-            BIT_RATE,
-            0,
-            NB_POINTS,
-            &signal
-        );
-        fft_Compute(signal, &spectres[2][i]);
-        scatter_destroy(signal);
-
-        nfc_standardSignal(
-            byte,
-            1,
-            NFC_B,
-            PICC,
-            BIT_RATE,
-            0,
-            NB_POINTS,
-            &signal
-        );
-        fft_Compute(signal, &spectres[3][i]);
-        scatter_destroy(signal);
-
-        for (size_t j = 0; j < 4; j=j+1) {
-            for (size_t k = 0; k < NB_POINTS; k=k+1) {
-                scatter_setY(
-                    avgSpectres[j],
-                    k,
-                    scatter_getY(avgSpectres[j], k) + scatter_getY(spectres[j][i], k)
-                );
-            }
+
+        for (size_t m = 0; m < 4; m=m+1) {
+            if (computeSpectrum(cache, byte, modes[m].standard, modes[m].dataTransm, &spectrum))
+                return -1;
+
+            entry = partial_find(partial, "frequency");
+            for (size_t k = 0; k < NB_POINTS; k=k+1)
+                entry->values[k] = scatter_getX(spectrum, k);
+            entry = partial_find(partial, modes[m].entry);
+            for (size_t k = 0; k < NB_POINTS; k=k+1)
+                partial_sumAdd(&entry->sums[k], scatter_getY(spectrum, k));
+            scatter_destroy(spectrum);
         }
+        partial_find(partial, "spectra")->counts[0] += 1;
     }
 
-    scatter_setName(avgSpectres[0], "Frequency (Hz)", "NFC-A PCD");
-    scatter_setName(avgSpectres[1], "Frequency (Hz)", "NFC-A PICC");
-    scatter_setName(avgSpectres[2], "Frequency (Hz)", "NFC-B PCD");
-    scatter_setName(avgSpectres[3], "Frequency (Hz)", "NFC-B PICC");
+    return 0;
+}
+
+/**
+ * @brief Average the spectra of complete results and write them as a CSV
+ *        file
+ * 
+ * @param partial Results of all the shards
+ * @param filename CSV file of the averaged spectra
+ * @return int - 0 if success, -1 otherwise
+ */
+static int writeAverage(partial_t partial, char* filename) {
+    scatter_t avgSpectres[4];
+    partial_entry_t* count = partial_find(partial, "spectra");
+    partial_entry_t* frequency = partial_find(partial, "frequency");
+    partial_entry_t* sum;
+    int status;
+
+    assert(partial_complete(partial), "Spectra of some shards are missing", -1);
+    assert(count && count->kind == PARTIAL_COUNTS && count->counts[0], "No spectrum in the results", -1);
+    assert(frequency && frequency->size == NB_POINTS, "No frequency in the results", -1);
 
     for (size_t j = 0; j < 4; j=j+1) {
+        sum = partial_find(partial, modes[j].entry);
+        assert(sum && sum->kind == PARTIAL_SUMS && sum->size == NB_POINTS, "No %s spectrum in the results", -1, modes[j].name);
+        scatter_create(&avgSpectres[j], NB_POINTS);
+        scatter_setName(avgSpectres[j], "Frequency (Hz)", modes[j].name);
         for (size_t k = 0; k < NB_POINTS; k=k+1) {
-            scatter_setX(
-                avgSpectres[j],
-                k,
-                scatter_getX(spectres[j][0], k)
-            );
-            scatter_setY(
-                avgSpectres[j],
-                k,
-                scatter_getY(avgSpectres[j], k) / 256
-            );
+            scatter_setX(avgSpectres[j], k, (int)frequency->values[k]);
+            scatter_setY(avgSpectres[j], k, partial_sumValue(&sum->sums[k]) / (double)count->counts[0]);
         }
     }
 
-    writeCSV(avgSpectres, 4, "..\\res\\average spectre.csv");
+    status = writeCSV(avgSpectres, 4, filename);
 
-    for (size_t i = 0; i < 4; i=i+1)
-        scatter_destroy(avgSpectres[i]);
+    for (size_t j = 0; j < 4; j=j+1)
+        scatter_destroy(avgSpectres[j]);
 
-    return 0;
-}
\ No newline at end of file
+    return status;
+}
+
+/**
+ * @brief Main function. The 256 bytes can be split with "--shard i/N",
+ *        each shard writing the sums of its spectra with "--partial FILE",
+ *        and "--merge FILE..." averages the sums of all the shards.
+ * 
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int - 0 if success
+ */
+int main(int argc, char* argv[]) {
+    shard_t shard = {0, 1};                      // Shard of the bytes
+    char* partialFile = NULL;                    // Partial results of the shard, NULL to average
+    char* output = "..\\res\\average spectre.csv"; // Averaged spectra
+    int merge = 0;                               // Index of the first file to merge, 0 to compute
+    partial_t partial;                           // Sums of the spectra
+    char config[64];                             // Configuration of the spectra
+    wavecache_t cache = NULL;                     // Optional waveform cache
+    char* cacheDir = getenv("NFCSIM_CACHE_DIR");
+    int status;
+
+    for (int i = 1; i + 1 < argc && !merge; i=i+2) {
+        if (!strcmp(argv[i], "--shard")) {
+            if (shard_parse(argv[i+1], &shard))
+                return -1;
+        } else if (!strcmp(argv[i], "--partial"))
+            partialFile = argv[i+1];
+        else if (!strcmp(argv[i], "--output"))
+            output = argv[i+1];
+        else if (!strcmp(argv[i], "--merge"))
+            merge = i + 1;
+        else {
+            PRINT(ERR, "Usage: %s [--output FILE] [--shard i/N --partial FILE] [--merge FILE...]", argv[0]);
+            return -1;
+        }
+    }
+
+    if (merge) {
+        if (partial_readAll((const char**)argv + merge, (size_t)(argc - merge), &partial))
+            return -1;
+        status = writeAverage(partial, output);
+        partial_destroy(partial);
+        return status;
+    }
+    assert(partialFile || shard.count == 1, "A shard writes its sums with --partial", -1);
+
+    if (cacheDir && cache_open(cacheDir, CACHE_MAX_SIZE, &cache))
+        PRINT(WARN, "Cannot open the waveform cache, computing every spectrum");
+
+    snprintf(config, sizeof(config), "points %d bitRate %d", NB_POINTS, BIT_RATE);
+    if (partial_create("avgSpectre", config, &shard, &partial)) {
+        if (cache)
+            cache_close(cache);
+        return -1;
+    }
+    status = sumSpectra(cache, &shard, partial);
+    if (!status)
+        status = partialFile ? partial_write(partial, partialFile) : writeAverage(partial, output);
+
+    if (cache)
+        cache_close(cache);
+    partial_destroy(partial);
+
+    return status;
+}
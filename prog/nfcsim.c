@@ -10,6 +10,7 @@
  */
 
 #include "nfcsim.h"
+#include <stdlib.h>
 #include <string.h>
 
 /**
@@ -26,6 +27,13 @@ int main(/*int argc, char *argv[]*/) {
     scatter_t signals[8];                         // NFC signal and its FFT
     double levels[] = {-0.9, -0.6, 0.6, 0.9};     // Levels for the LCADC
 
+    //========== Report the time spent in each stage
+    prof_reportAtExit();
+    if (getenv("NFCSIM_COUNTERS"))
+        prof_countersOpen();
+    if (getenv("NFCSIM_TRACE"))
+        trace_start();
+
     //========== Generate NFC signals
     if (!nfc_standardSignal(
         data,
@@ -101,6 +109,12 @@ int main(/*int argc, char *argv[]*/) {
         return -1;
     }
 
+    //========== Write the trace of the execution
+    if (getenv("NFCSIM_TRACE")) {
+        trace_stop();
+        trace_write(getenv("NFCSIM_TRACE"));
+    }
+
     //========== Free memory
     scatter_destroy(signals[0]);
     scatter_destroy(signals[1]);
@@ -0,0 +1,639 @@
+/**
+ * @file nfcsim_bench.c
+ * @author OUSSET Gaël
+ * @brief Benchmark of each stage of the generation, of the end-to-end
+ *        generation, of the FFT, of the LCADC and of the CSV export
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "nfcsim.h"
+#include "assert.h"
+#include "context.h"
+#include "parallel.h"
+#include "cpu.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Points generated for each bit of the payload. The payload grows with the
+ * number of points so the transition of the envelope keeps the same
+ * number of points at every size.
+ */
+#define BENCH_POINTS_PER_BIT 1024
+
+/**
+ * Noise level of the benchmarked signals
+ */
+#define BENCH_NOISE_LEVEL 0.1
+
+/**
+ * Growth of the time of a run when the number of points doubles, used to
+ * skip the sizes that would exceed the budget. Quadratic kernels are
+ * stopped early, linear ones get one size of margin.
+ */
+#define BENCH_GROWTH 4
+
+/**
+ * Name of the CSV file written by the benchmark, removed afterwards
+ */
+#define BENCH_CSV_FILE "nfcsim_bench.csv"
+
+//========== Structures declarations
+/**
+ * @brief Options of the benchmark
+ * 
+ */
+typedef struct {
+    unsigned int minLog2;                        // Smallest number of points (log2)
+    unsigned int maxLog2;                        // Largest number of points (log2)
+    unsigned int csvMaxLog2;                     // Largest number of points exported to CSV (log2)
+    unsigned int warmup;                         // Number of runs before the measures
+    unsigned int reps;                           // Number of measured runs
+    double       budget;                         // Maximum expected time of a run (s)
+    const char*  json;                           // JSON output file, NULL for none
+} bench_options_t;
+
+/**
+ * @brief Inputs of the benchmarks for a mode and a size
+ * 
+ */
+typedef struct {
+    nfc_standard_t   standard;                   // NFC standard
+    nfc_dataTransm_t dataTransm;                 // Data transmission mode
+    nfc_sigParam_t   sigParam;                   // Parameters of the signal
+    char*            encoded;                    // Encoded data
+    size_t           encodedSize;                // Size of the encoded data
+    char*            subModulated;               // Sub-modulated data
+    size_t           subModulatedSize;           // Size of the sub-modulated data
+    scatter_t        envelope;                   // Envelope of the signal
+    scatter_t        signal;                     // Modulated noisy signal
+    scatter_t        work;                       // Output of the in-place benchmarks
+} bench_case_t;
+
+/**
+ * @brief Run a benchmark once
+ * 
+ * @param c Inputs of the benchmark
+ * @param time Time of the measured part (ns)
+ * @return int - 0 if success, -1 otherwise
+ */
+typedef int (*bench_run_t)(bench_case_t* c, uint64_t* time);
+
+/**
+ * @brief Modes of the standard signals
+ * 
+ */
+static const struct {
+    nfc_standard_t   standard;                   // NFC standard
+    nfc_dataTransm_t dataTransm;                 // Data transmission mode
+    const char*      name;                       // Name of the mode
+} bench_modes[] = {
+    {NFC_A, PCD,  "NFC-A PCD"},
+    {NFC_A, PICC, "NFC-A PICC"},
+    {NFC_B, PCD,  "NFC-B PCD"},
+    {NFC_B, PICC, "NFC-B PICC"}
+};
+
+/**
+ * @brief Levels of the benchmarked LCADC
+ * 
+ */
+static double bench_levels[] = {-0.9, -0.6, 0.6, 0.9};
+
+/**
+ * Number of configurations of the benchmarked LCADC batch, with 1 to 8
+ * uniform levels and a skip of 0 to 7
+ */
+#define BENCH_NB_LCADC_CONFIGS 64
+
+//========== Benchmarks
+/**
+ * @brief Benchmark nfc_encodeData(), see bench_run_t
+ * 
+ */
+static int bench_encode(bench_case_t* c, uint64_t* time) {
+    char*    encoded;
+    size_t   encodedSize;
+    uint64_t start = prof_now();
+
+    if (nfc_encodeData(&c->sigParam, &encoded, &encodedSize))
+        return -1;
+    *time = prof_now() - start;
+    nfc_free(encoded);
+    return 0;
+}
+
+/**
+ * @brief Benchmark nfc_modulateSubCarrier(), see bench_run_t
+ * 
+ */
+static int bench_subCarrier(bench_case_t* c, uint64_t* time) {
+    char*    subModulated;
+    size_t   subModulatedSize;
+    uint64_t start = prof_now();
+
+    if (nfc_modulateSubCarrier(c->encoded, c->encodedSize, &c->sigParam, &subModulated, &subModulatedSize))
+        return -1;
+    *time = prof_now() - start;
+    nfc_free(subModulated);
+    return 0;
+}
+
+/**
+ * @brief Benchmark nfc_createEnvelope(), see bench_run_t
+ * 
+ */
+static int bench_envelope(bench_case_t* c, uint64_t* time) {
+    scatter_t envelope;
+    uint64_t  start = prof_now();
+
+    if (nfc_createEnvelope(c->subModulated, c->subModulatedSize, &c->sigParam, &envelope))
+        return -1;
+    *time = prof_now() - start;
+    scatter_destroy(envelope);
+    return 0;
+}
+
+/**
+ * @brief Benchmark nfc_modulateInto(), see bench_run_t
+ * 
+ */
+static int bench_modulate(bench_case_t* c, uint64_t* time) {
+    uint64_t start = prof_now();
+
+    if (nfc_modulateInto(c->envelope, &c->sigParam, c->work))
+        return -1;
+    *time = prof_now() - start;
+    return 0;
+}
+
+/**
+ * @brief Benchmark nfc_addNoiseInto(), see bench_run_t
+ * 
+ */
+static int bench_noise(bench_case_t* c, uint64_t* time) {
+    uint64_t start = prof_now();
+
+    if (nfc_addNoiseInto(c->signal, &c->sigParam, c->work))
+        return -1;
+    *time = prof_now() - start;
+    return 0;
+}
+
+/**
+ * @brief Benchmark nfc_standardSignal(), see bench_run_t
+ * 
+ */
+static int bench_signal(bench_case_t* c, uint64_t* time) {
+    scatter_t signal;
+    uint64_t  start = prof_now();
+
+    if (nfc_standardSignal(
+        c->sigParam.data,
+        c->sigParam.dataSize,
+        c->standard,
+        c->dataTransm,
+        c->sigParam.bitRate,
+        c->sigParam.noiseLevel,
+        c->sigParam.numberOfPoints,
+        &signal
+    ))
+        return -1;
+    *time = prof_now() - start;
+    scatter_destroy(signal);
+    return 0;
+}
+
+/**
+ * @brief Benchmark fft_Compute(), see bench_run_t
+ * 
+ */
+static int bench_fft(bench_case_t* c, uint64_t* time) {
+    scatter_t spectrum;
+    uint64_t  start = prof_now();
+
+    if (fft_Compute(c->signal, &spectrum))
+        return -1;
+    *time = prof_now() - start;
+    scatter_destroy(spectrum);
+    return 0;
+}
+
+/**
+ * @brief Benchmark LCADC(), see bench_run_t
+ * 
+ */
+static int bench_lcadc(bench_case_t* c, uint64_t* time) {
+    scatter_t samples;
+    uint64_t  start = prof_now();
+
+    if (LCADC(c->signal, bench_levels, sizeof(bench_levels) / sizeof(*bench_levels), 0, &samples))
+        return -1;
+    *time = prof_now() - start;
+    scatter_destroy(samples);
+    return 0;
+}
+
+/**
+ * @brief Benchmark LCADC_batch() without keeping the samples, see
+ *        bench_run_t
+ * 
+ */
+static int bench_lcadcBatch(bench_case_t* c, uint64_t* time) {
+    static double  levels[8][8];
+    LCADC_config_t configs[BENCH_NB_LCADC_CONFIGS];
+    LCADC_result_t results[BENCH_NB_LCADC_CONFIGS];
+    uint64_t       start;
+
+    for (unsigned int n = 0; n < 8; n=n+1) {
+        for (unsigned int l = 0; l <= n; l=l+1)
+            levels[n][l] = -1 + 2 * ((double)l + 1) / ((double)n + 2);
+        for (unsigned int skip = 0; skip < 8; skip=skip+1)
+            configs[8*n + skip] = (LCADC_config_t){levels[n], n + 1, skip};
+    }
+
+    start = prof_now();
+    if (LCADC_batch(c->signal, configs, BENCH_NB_LCADC_CONFIGS, 0, results))
+        return -1;
+    *time = prof_now() - start;
+    return 0;
+}
+
+/**
+ * @brief Benchmark demod_frame(), the receiver is created outside of the
+ *        measure, see bench_run_t
+ * 
+ */
+static int bench_demod(bench_case_t* c, uint64_t* time) {
+    demod_t  demod;
+    char*    data;
+    uint64_t start;
+    int      status = -1;
+
+    if (demod_create(&c->sigParam, c->signal->size, &demod))
+        return -1;
+    data = malloc(c->sigParam.dataSize);
+    if (data) {
+        start  = prof_now();
+        status = demod_frame(demod, c->signal, data);
+        *time  = prof_now() - start;
+        free(data);
+    }
+    demod_destroy(demod);
+    return status;
+}
+
+/**
+ * @brief Benchmark writeCSV(), see bench_run_t
+ * 
+ */
+static int bench_csv(bench_case_t* c, uint64_t* time) {
+    uint64_t start = prof_now();
+
+    if (writeCSV(&c->signal, 1, BENCH_CSV_FILE))
+        return -1;
+    *time = prof_now() - start;
+    return 0;
+}
+
+/**
+ * @brief Benchmarks, in the order they are run
+ * 
+ */
+static const struct {
+    const char* name;                            // Name of the benchmark
+    bench_run_t run;                             // Benchmark
+    int         allModes;                        // 1 if run for every mode, 0 for the first one
+    int         isCSV;                           // 1 if limited to csvMaxLog2
+} bench_list[] = {
+    {"encode",      bench_encode,     1, 0},
+    {"subcarrier",  bench_subCarrier, 1, 0},
+    {"envelope",    bench_envelope,   1, 0},
+    {"modulate",    bench_modulate,   1, 0},
+    {"noise",       bench_noise,      1, 0},
+    {"signal",      bench_signal,     1, 0},
+    {"fft",         bench_fft,        0, 0},
+    {"lcadc",       bench_lcadc,      1, 0},
+    {"lcadc_batch", bench_lcadcBatch, 0, 0},
+    {"demod",       bench_demod,      1, 0},
+    {"csv",         bench_csv,        0, 1}
+};
+
+/**
+ * Number of benchmarks
+ */
+#define NB_BENCHS (sizeof(bench_list) / sizeof(*bench_list))
+
+//========== Measures
+/**
+ * @brief Compare two times for qsort
+ * 
+ * @param a First time
+ * @param b Second time
+ * @return int - Order of the times
+ */
+static int bench_compare(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Return a percentile of sorted times
+ * 
+ * @param times Sorted times
+ * @param nbTimes Number of times
+ * @param percent Percentile (0-100)
+ * @return uint64_t - Time at the percentile (ns)
+ */
+static uint64_t bench_percentile(uint64_t* times, unsigned int nbTimes, unsigned int percent) {
+    return times[(size_t)(nbTimes - 1) * percent / 100];
+}
+
+/**
+ * @brief Run a benchmark, print its statistics and append them to the JSON
+ *        output
+ * 
+ * @param options Options of the benchmark
+ * @param json JSON output, NULL for none
+ * @param name Name of the benchmark
+ * @param mode Name of the mode
+ * @param log2 Number of points (log2)
+ * @param run Benchmark to run
+ * @param c Inputs of the benchmark
+ * @param median Median time of the runs (s)
+ * @return int - 0 if success, -1 otherwise
+ */
+static int bench_measure(
+    bench_options_t* options,
+    FILE* json,
+    const char* name,
+    const char* mode,
+    unsigned int log2,
+    bench_run_t run,
+    bench_case_t* c,
+    double* median
+) {
+    //========== Variables declaration
+    static int first = 1;                        // 1 before the first JSON result
+    uint64_t*  times;                            // Measured times (ns)
+    uint64_t   time;                             // Time of a warmup run (ns)
+
+    times = malloc(options->reps * sizeof(*times));
+    assert(times, "Failed to allocate memory for the measures", -1);
+
+    //========== Run the benchmark
+    for (unsigned int i = 0; i < options->warmup; i=i+1) {
+        if (run(c, &time)) {
+            free(times);
+            return -1;
+        }
+    }
+    for (unsigned int i = 0; i < options->reps; i=i+1) {
+        if (run(c, &times[i])) {
+            free(times);
+            return -1;
+        }
+    }
+    qsort(times, options->reps, sizeof(*times), bench_compare);
+    *median = (double)bench_percentile(times, options->reps, 50) * 1e-9;
+
+    //========== Report the statistics
+    PRINT(
+        NORM,
+        "%-11s %-10s 2^%-3u %12.3f %12.3f %12.3f %12.3f %14.4g",
+        name, mode, log2,
+        (double)times[0] * 1e-3,
+        *median * 1e6,
+        (double)bench_percentile(times, options->reps, 90) * 1e-3,
+        (double)times[options->reps - 1] * 1e-3,
+        *median > 0 ? (double)(1ULL << log2) / *median : 0.0
+    );
+    if (json) {
+        fprintf(
+            json,
+            "%s\n    {\"bench\":\"%s\",\"mode\":\"%s\",\"log2\":%u,\"points\":%llu,"
+            "\"min_ns\":%llu,\"median_ns\":%llu,\"p90_ns\":%llu,\"max_ns\":%llu,"
+            "\"samples_per_s\":%.6g}",
+            first ? "" : ",",
+            name, mode, log2, 1ULL << log2,
+            (unsigned long long)times[0],
+            (unsigned long long)bench_percentile(times, options->reps, 50),
+            (unsigned long long)bench_percentile(times, options->reps, 90),
+            (unsigned long long)times[options->reps - 1],
+            *median > 0 ? (double)(1ULL << log2) / *median : 0.0
+        );
+        first = 0;
+    }
+
+    free(times);
+    return 0;
+}
+
+//========== Inputs
+/**
+ * @brief Prepare the inputs of the benchmarks for a mode and a size
+ * 
+ * @param mode Index of the mode
+ * @param log2 Number of points (log2)
+ * @param data Payload, large enough for the size
+ * @param c Inputs to prepare
+ * @return int - 0 if success, -1 otherwise
+ */
+static int bench_prepare(size_t mode, unsigned int log2, char* data, bench_case_t* c) {
+    //========== Variables declaration
+    unsigned int nbPoints = 1U << log2;          // Number of points
+    size_t       size;                           // Size of the payload (bytes)
+
+    memset(c, 0, sizeof(*c));
+    size = nbPoints / (8 * BENCH_POINTS_PER_BIT);
+    if (!size)
+        size = 1;
+
+    c->standard   = bench_modes[mode].standard;
+    c->dataTransm = bench_modes[mode].dataTransm;
+    assert(
+        !nfc_standardParam(data, size, c->standard, c->dataTransm, BIT_RATE, BENCH_NOISE_LEVEL, nbPoints, &c->sigParam),
+        "Failed to prepare the parameters of the signal",
+        -1
+    );
+
+    //========== Run the stages once to get their inputs
+    if (nfc_encodeData(&c->sigParam, &c->encoded, &c->encodedSize))
+        return -1;
+    if (nfc_modulateSubCarrier(c->encoded, c->encodedSize, &c->sigParam, &c->subModulated, &c->subModulatedSize))
+        return -1;
+    if (nfc_createEnvelope(c->subModulated, c->subModulatedSize, &c->sigParam, &c->envelope))
+        return -1;
+    if (nfc_createSignal(&c->sigParam, &c->signal))
+        return -1;
+    if (scatter_create(&c->work, nbPoints))
+        return -1;
+
+    return 0;
+}
+
+/**
+ * @brief Free the inputs of the benchmarks
+ * 
+ * @param c Inputs to free
+ */
+static void bench_release(bench_case_t* c) {
+    nfc_free(c->encoded);
+    nfc_free(c->subModulated);
+    if (c->envelope)
+        scatter_destroy(c->envelope);
+    if (c->signal)
+        scatter_destroy(c->signal);
+    if (c->work)
+        scatter_destroy(c->work);
+}
+
+/**
+ * @brief Print the usage of the benchmark
+ * 
+ * @param program Name of the program
+ */
+static void bench_usage(const char* program) {
+    PRINT(
+        NORM,
+        "Usage: %s [--min LOG2] [--max LOG2] [--csv-max LOG2] [--warmup N] [--reps N] [--budget SECONDS] [--json FILE]",
+        program
+    );
+}
+
+/**
+ * @brief Main function
+ * 
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int - 0 if success
+ */
+int main(int argc, char* argv[]) {
+    //========== Variable declaration
+    bench_options_t options = {10, 24, 20, 1, 5, 10, NULL}; // Options of the benchmark
+    nfc_context_t   context;                     // Context silencing the library
+    FILE*           json = NULL;                 // JSON output
+    char*           data;                        // Payload of the signals
+    bench_case_t    c;                           // Inputs of the benchmarks
+    unsigned int*   option;                      // Numeric option being parsed
+    double          medians[NB_BENCHS] = {0};    // Median time of each benchmark at the last size (s)
+    double          median;                      // Median time of a benchmark (s)
+    int             status = 0;                  // Status of the benchmark
+
+    //========== Parse the arguments
+    for (int i = 1; i < argc; i=i+1) {
+        option = NULL;
+        if (!strcmp(argv[i], "--min"))
+            option = &options.minLog2;
+        else if (!strcmp(argv[i], "--max"))
+            option = &options.maxLog2;
+        else if (!strcmp(argv[i], "--csv-max"))
+            option = &options.csvMaxLog2;
+        else if (!strcmp(argv[i], "--warmup"))
+            option = &options.warmup;
+        else if (!strcmp(argv[i], "--reps"))
+            option = &options.reps;
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+            i = i + 1;
+            options.json = argv[i];
+            continue;
+        } else if (!strcmp(argv[i], "--budget") && i + 1 < argc) {
+            i = i + 1;
+            options.budget = strtod(argv[i], NULL);
+            continue;
+        } else {
+            bench_usage(argv[0]);
+            return -1;
+        }
+        if (i + 1 >= argc) {
+            bench_usage(argv[0]);
+            return -1;
+        }
+        i = i + 1;
+        *option = (unsigned int)strtoul(argv[i], NULL, 10);
+    }
+    assert(options.reps, "At least one measured run is needed", -1);
+    assert(
+        options.minLog2 <= options.maxLog2 && options.maxLog2 <= 30,
+        "Invalid range of sizes",
+        -1
+    );
+
+    //========== Prepare the benchmark
+    // Only the errors of the library are printed
+    assert(!nfc_contextCreate(&context), "Failed to create the context", -1);
+    nfc_contextSetLog(context, NULL, NULL, ERR);
+    nfc_contextBind(context);
+
+    data = malloc((1U << options.maxLog2) / (8 * BENCH_POINTS_PER_BIT) + 1);
+    assert(data, "Failed to allocate memory for the payload", -1);
+    for (size_t i = 0; i < (1U << options.maxLog2) / (8 * BENCH_POINTS_PER_BIT) + 1; i=i+1)
+        data[i] = (char)(i * 37 + 11);
+
+    if (options.json) {
+        json = fopen(options.json, "w");
+        assert(json, "Cannot open file %s", -1, options.json);
+        fprintf(
+            json,
+            "{\n  \"version\":\"%s\",\"threads\":%u,\"cpu\":\"%s\",\"warmup\":%u,\"reps\":%u,\n  \"results\":[",
+            NFCSIM_VERSION, parallel_nbThreads(), cpu_tierName(cpu_tier()), options.warmup, options.reps
+        );
+    }
+
+    //========== Run the benchmarks
+    PRINT(NORM, "CPU kernels: %s", cpu_tierName(cpu_tier()));
+    PRINT(
+        NORM,
+        "%-11s %-10s %-5s %12s %12s %12s %12s %14s",
+        "Bench", "Mode", "Size", "Min (us)", "Median (us)", "P90 (us)", "Max (us)", "Samples/s"
+    );
+    for (unsigned int log2 = options.minLog2; log2 <= options.maxLog2 && !status; log2=log2+1) {
+        for (size_t mode = 0; mode < sizeof(bench_modes) / sizeof(*bench_modes) && !status; mode=mode+1) {
+            if (bench_prepare(mode, log2, data, &c)) {
+                PRINT(ERR, "Failed to prepare the %s signal of 2^%u points", bench_modes[mode].name, log2);
+                bench_release(&c);
+                status = -1;
+                break;
+            }
+
+            for (size_t b = 0; b < NB_BENCHS && !status; b=b+1) {
+                if (mode && !bench_list[b].allModes)
+                    continue;
+                if (bench_list[b].isCSV && log2 > options.csvMaxLog2)
+                    continue;
+                // Skip the sizes a slow kernel would take too long to run
+                if (medians[b] * BENCH_GROWTH > options.budget) {
+                    if (!mode)
+                        PRINT(NORM, "%-11s %-10s 2^%-3u skipped, over the budget of %g s",
+                              bench_list[b].name, bench_modes[mode].name, log2, options.budget);
+                    continue;
+                }
+                status = bench_measure(&options, json, bench_list[b].name, bench_modes[mode].name, log2, bench_list[b].run, &c, &median);
+                if (!mode)
+                    medians[b] = median;
+            }
+
+            bench_release(&c);
+        }
+    }
+    remove(BENCH_CSV_FILE);
+
+    //========== Free memory
+    if (json) {
+        fprintf(json, "\n  ]\n}\n");
+        fclose(json);
+    }
+    free(data);
+    nfc_contextBind(NULL);
+    nfc_contextDestroy(context);
+
+    return status;
+}
@@ -0,0 +1,349 @@
+/**
+ * @file nfcsim_ber.c
+ * @author OUSSET Gaël
+ * @brief Bit and frame error rates of each mode against the noise level
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "nfcsim.h"
+#include "assert.h"
+#include "context.h"
+#include "parallel.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Maximum number of noise levels of a curve
+ */
+#define BER_MAX_NOISE_LEVELS 1024
+
+//========== Structures declarations
+/**
+ * @brief Options of the program
+ * 
+ */
+typedef struct {
+    double       noiseMin;                       // First noise level
+    double       noiseMax;                       // Last noise level
+    unsigned int nbNoiseLevels;                  // Number of noise levels
+    unsigned int dataSize;                       // Size of the payload of a frame (bytes)
+    unsigned int pointsPerBit;                   // Points per bit, 3 per period of the carrier at least
+    unsigned int maxTrials;                      // Maximum number of frames per noise level
+    unsigned int minErrors;                      // Bit errors needed before stopping early
+    double       precision;                      // Relative half width of the interval to stop early
+    unsigned int seed;                           // Seed of the run
+    const char*  csv;                            // Prefix of the CSV files, NULL for none
+    shard_t      shard;                          // Shard of the (mode, noise level) pairs run
+    const char*  partial;                        // Partial result file of the shard, NULL to print the results
+} ber_options_t;
+
+/**
+ * @brief Counters of a (mode, noise level) pair, as the entries of the
+ *        partial results
+ * 
+ */
+static const char* ber_counters[] = {"frames", "frameErrors", "bits", "bitErrors", "converged"};
+
+/**
+ * @brief Simulated modes
+ * 
+ */
+static const struct {
+    nfc_standard_t   standard;                   // NFC standard
+    nfc_dataTransm_t dataTransm;                 // Data transmission mode
+    const char*      name;                       // Name of the mode
+    const char*      fileName;                   // Suffix of the CSV file of the mode
+} ber_modes[] = {
+    {NFC_A, PCD,  "NFC-A PCD",  "A_PCD"},
+    {NFC_A, PICC, "NFC-A PICC", "A_PICC"},
+    {NFC_B, PCD,  "NFC-B PCD",  "B_PCD"},
+    {NFC_B, PICC, "NFC-B PICC", "B_PICC"}
+};
+
+/**
+ * @brief Print the usage of the program
+ * 
+ * @param program Name of the program
+ */
+static void ber_usage(const char* program) {
+    PRINT(
+        NORM,
+        "Usage: %s [--noise-min LEVEL] [--noise-max LEVEL] [--steps N] [--size BYTES] [--points-per-bit N] "
+        "[--trials N] [--min-errors N] [--precision RATIO] [--seed N] [--csv PREFIX] [--shard i/N] [--partial FILE]",
+        program
+    );
+    PRINT(NORM, "       %s [--csv PREFIX] --merge FILE...", program);
+}
+
+/**
+ * @brief Run the (mode, noise level) pairs of a shard, the pairs of a mode
+ *        following each other, and count their errors in partial results
+ * 
+ * @param options Options of the program
+ * @param partial Results of the shard
+ * @return int - 0 if success, -1 otherwise
+ */
+static int ber_shard(const ber_options_t* options, partial_t partial) {
+    //========== Variables declaration
+    ber_config_t     config;                     // Parameters of a run
+    double           noiseLevels[BER_MAX_NOISE_LEVELS]; // Noise levels of the curves
+    ber_result_t     results[BER_MAX_NOISE_LEVELS]; // Results of the levels of a mode in the shard
+    partial_entry_t* entry;                      // Entry of the results
+    size_t           nbModes = sizeof(ber_modes) / sizeof(*ber_modes); // Number of modes
+    size_t           first;                      // First pair of the shard
+    size_t           last;                       // Pair after the last one of the shard
+    size_t           low;                        // First level of a mode in the shard
+    size_t           high;                       // Level after the last one of a mode in the shard
+    uint64_t         counters[5];                // Counters of a pair
+
+    for (unsigned int l = 0; l < options->nbNoiseLevels; l=l+1)
+        noiseLevels[l] = options->nbNoiseLevels == 1 ? options->noiseMin :
+            options->noiseMin + (options->noiseMax - options->noiseMin) * l / (options->nbNoiseLevels - 1);
+
+    //========== Entries, the counters of all the pairs
+    if (partial_entry(partial, "noiseLevels", PARTIAL_VALUES, options->nbNoiseLevels, &entry))
+        return -1;
+    memcpy(entry->values, noiseLevels, options->nbNoiseLevels * sizeof(double));
+    for (size_t c = 0; c < sizeof(ber_counters) / sizeof(*ber_counters); c=c+1)
+        if (partial_entry(partial, ber_counters[c], PARTIAL_COUNTS, nbModes * options->nbNoiseLevels, &entry))
+            return -1;
+
+    config.bitRate        = BIT_RATE;
+    config.dataSize       = options->dataSize;
+    config.numberOfPoints = options->dataSize * 8 * options->pointsPerBit;
+    config.maxTrials      = options->maxTrials;
+    config.minErrors      = options->minErrors;
+    config.precision      = options->precision;
+    config.seed           = options->seed;
+
+    //========== Run the levels of each mode in the shard
+    // A level draws its frames from its own value, whatever the other levels of the run
+    shard_range(&options->shard, nbModes * options->nbNoiseLevels, &first, &last);
+    PRINT(
+        NORM, "Threads: %u, frames of %u bytes, %u points, pairs %zu to %zu of %zu",
+        parallel_nbThreads(), options->dataSize, config.numberOfPoints, first, last, nbModes * options->nbNoiseLevels
+    );
+    for (size_t mode = 0; mode < nbModes; mode=mode+1) {
+        if (last <= mode * options->nbNoiseLevels || first >= (mode + 1) * options->nbNoiseLevels)
+            continue;
+        low  = first > mode * options->nbNoiseLevels ? first - mode * options->nbNoiseLevels : 0;
+        high = last < (mode + 1) * options->nbNoiseLevels ? last - mode * options->nbNoiseLevels : options->nbNoiseLevels;
+
+        config.standard      = ber_modes[mode].standard;
+        config.dataTransm    = ber_modes[mode].dataTransm;
+        config.noiseLevels   = noiseLevels + low;
+        config.nbNoiseLevels = high - low;
+        if (ber_run(&config, results)) {
+            PRINT(ERR, "Failed to run the %s mode", ber_modes[mode].name);
+            return -1;
+        }
+
+        for (size_t l = low; l < high; l=l+1) {
+            counters[0] = results[l-low].nbFrames;
+            counters[1] = results[l-low].nbFrameErrors;
+            counters[2] = results[l-low].nbBits;
+            counters[3] = results[l-low].nbBitErrors;
+            counters[4] = (uint64_t)results[l-low].converged;
+            for (size_t c = 0; c < sizeof(ber_counters) / sizeof(*ber_counters); c=c+1)
+                partial_find(partial, ber_counters[c])->counts[mode * options->nbNoiseLevels + l] = counters[c];
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Print the curves of complete results and write them as CSV files
+ * 
+ * @param partial Results of all the shards
+ * @param csv Prefix of the CSV files, NULL for none
+ * @return int - 0 if success, -1 otherwise
+ */
+static int ber_print(partial_t partial, const char* csv) {
+    //========== Variables declaration
+    ber_result_t     results[BER_MAX_NOISE_LEVELS]; // Results of a mode
+    partial_entry_t* levels;                     // Noise levels of the curves
+    partial_entry_t* counters[5];                // Counters of the pairs
+    size_t           nbModes = sizeof(ber_modes) / sizeof(*ber_modes); // Number of modes
+    ber_result_t*    r;                          // Result of a level
+    size_t           pair;                       // Index of a pair
+    char             fileName[256];              // Name of a CSV file
+    FILE*            file;                       // CSV file of a mode
+    int              status  = 0;                // Status of the writes
+
+    //========== Check arguments
+    assert(partial_complete(partial), "Results of some shards are missing", -1);
+    levels = partial_find(partial, "noiseLevels");
+    assert(levels && levels->kind == PARTIAL_VALUES && levels->size <= BER_MAX_NOISE_LEVELS, "No noise levels in the results", -1);
+    for (size_t c = 0; c < sizeof(ber_counters) / sizeof(*ber_counters); c=c+1) {
+        counters[c] = partial_find(partial, ber_counters[c]);
+        assert(
+            counters[c] && counters[c]->kind == PARTIAL_COUNTS && counters[c]->size == nbModes * levels->size,
+            "No %s in the results", -1, ber_counters[c]
+        );
+    }
+
+    for (size_t mode = 0; mode < nbModes && !status; mode=mode+1) {
+        //========== Rates of the merged counters
+        for (size_t l = 0; l < levels->size; l=l+1) {
+            r                = &results[l];
+            pair             = mode * levels->size + l;
+            r->noiseLevel    = levels->values[l];
+            r->nbFrames      = counters[0]->counts[pair];
+            r->nbFrameErrors = counters[1]->counts[pair];
+            r->nbBits        = counters[2]->counts[pair];
+            r->nbBitErrors   = counters[3]->counts[pair];
+            r->converged     = (int)counters[4]->counts[pair];
+            ber_interval(r->nbBitErrors, r->nbBits, &r->ber, &r->berLow, &r->berHigh);
+            ber_interval(r->nbFrameErrors, r->nbFrames, &r->fer, &r->ferLow, &r->ferHigh);
+        }
+
+        PRINT(NORM, "");
+        PRINT(NORM, "===== %s =====", ber_modes[mode].name);
+        PRINT(
+            NORM, "%8s %8s %12s %12s %12s %12s %12s %12s",
+            "Noise", "Frames", "BER", "BER low", "BER high", "FER", "FER low", "FER high"
+        );
+        for (size_t l = 0; l < levels->size; l=l+1)
+            PRINT(
+                NORM, "%8.4g %8llu %12.4e %12.4e %12.4e %12.4e %12.4e %12.4e%s",
+                results[l].noiseLevel, (unsigned long long)results[l].nbFrames,
+                results[l].ber, results[l].berLow, results[l].berHigh,
+                results[l].fer, results[l].ferLow, results[l].ferHigh,
+                results[l].converged ? "" : " *"
+            );
+
+        if (csv) {
+            snprintf(fileName, sizeof(fileName), "%s_%s.csv", csv, ber_modes[mode].fileName);
+            file = fopen(fileName, "w");
+            assert(file, "Cannot open file %s", -1, fileName);
+            status = ber_writeTable(file, results, levels->size);
+            fclose(file);
+        }
+    }
+    PRINT(NORM, "");
+    PRINT(NORM, "* maximum number of trials reached before the interval converged");
+
+    return status;
+}
+
+/**
+ * @brief Main function
+ * 
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int - 0 if success
+ */
+int main(int argc, char* argv[]) {
+    //========== Variable declaration
+    ber_options_t options = {0, 1, 11, 8, 512, 10000, 100, 0.1, 1, NULL, {0, 1}, NULL}; // Options of the program
+    nfc_context_t context;                       // Context silencing the library
+    partial_t     partial;                       // Results of the run
+    char          config[PARTIAL_MAX_NAME];      // Configuration of the run
+    unsigned int* option;                        // Numeric option being parsed
+    double*       real;                          // Real option being parsed
+    int           merge  = 0;                    // Index of the first file to merge, 0 to run
+    int           status = 0;                    // Status of the program
+
+    //========== Parse the arguments
+    for (int i = 1; i < argc && !merge; i=i+1) {
+        option = NULL;
+        real   = NULL;
+        if (!strcmp(argv[i], "--noise-min"))
+            real = &options.noiseMin;
+        else if (!strcmp(argv[i], "--noise-max"))
+            real = &options.noiseMax;
+        else if (!strcmp(argv[i], "--precision"))
+            real = &options.precision;
+        else if (!strcmp(argv[i], "--steps"))
+            option = &options.nbNoiseLevels;
+        else if (!strcmp(argv[i], "--size"))
+            option = &options.dataSize;
+        else if (!strcmp(argv[i], "--points-per-bit"))
+            option = &options.pointsPerBit;
+        else if (!strcmp(argv[i], "--trials"))
+            option = &options.maxTrials;
+        else if (!strcmp(argv[i], "--min-errors"))
+            option = &options.minErrors;
+        else if (!strcmp(argv[i], "--seed"))
+            option = &options.seed;
+        else if (!strcmp(argv[i], "--csv") && i + 1 < argc) {
+            i = i + 1;
+            options.csv = argv[i];
+            continue;
+        } else if (!strcmp(argv[i], "--partial") && i + 1 < argc) {
+            i = i + 1;
+            options.partial = argv[i];
+            continue;
+        } else if (!strcmp(argv[i], "--shard") && i + 1 < argc) {
+            i = i + 1;
+            if (shard_parse(argv[i], &options.shard))
+                return -1;
+            continue;
+        } else if (!strcmp(argv[i], "--merge") && i + 1 < argc) {
+            merge = i + 1;
+            continue;
+        } else {
+            ber_usage(argv[0]);
+            return -1;
+        }
+        if (i + 1 >= argc) {
+            ber_usage(argv[0]);
+            return -1;
+        }
+        i = i + 1;
+        if (real)
+            *real = strtod(argv[i], NULL);
+        else
+            *option = (unsigned int)strtoul(argv[i], NULL, 10);
+    }
+
+    //========== Merge the results of the shards
+    if (merge) {
+        if (partial_readAll((const char**)argv + merge, (size_t)(argc - merge), &partial))
+            return -1;
+        status = ber_print(partial, options.csv);
+        partial_destroy(partial);
+        return status;
+    }
+
+    assert(
+        options.nbNoiseLevels && options.nbNoiseLevels <= BER_MAX_NOISE_LEVELS,
+        "Between 1 and %d noise levels are needed", -1, BER_MAX_NOISE_LEVELS
+    );
+    assert(options.dataSize && options.pointsPerBit, "Empty frames", -1);
+    assert(options.maxTrials, "At least one trial is needed", -1);
+    assert(options.partial || options.shard.count == 1, "A shard writes its results with --partial", -1);
+
+    //========== Run the shard
+    // The shards of a run share all the options but the shard and the file
+    snprintf(
+        config, sizeof(config), "noise %.17g %.17g %u size %u points-per-bit %u trials %u min-errors %u precision %.17g seed %u",
+        options.noiseMin, options.noiseMax, options.nbNoiseLevels, options.dataSize, options.pointsPerBit,
+        options.maxTrials, options.minErrors, options.precision, options.seed
+    );
+    if (partial_create("nfcsim_ber", config, &options.shard, &partial))
+        return -1;
+
+    // Only the errors of the library are printed
+    assert(!nfc_contextCreate(&context), "Failed to create the context", -1);
+    nfc_contextSetLog(context, NULL, NULL, ERR);
+    nfc_contextBind(context);
+    status = ber_shard(&options, partial);
+    nfc_contextBind(NULL);
+    nfc_contextDestroy(context);
+
+    if (!status)
+        status = options.partial ? partial_write(partial, options.partial) : ber_print(partial, options.csv);
+
+    //========== Free memory
+    partial_destroy(partial);
+
+    return status;
+}
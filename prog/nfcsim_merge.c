@@ -0,0 +1,52 @@
+/**
+ * @file nfcsim_merge.c
+ * @author OUSSET Gaël
+ * @brief Merge the partial result files of shards of a run into one, to
+ *        gather the shards in steps or check them before the final merge
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "nfcsim.h"
+#include <stdio.h>
+
+/**
+ * @brief Main function
+ * 
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int - 0 if success
+ */
+int main(int argc, char* argv[]) {
+    //========== Variable declaration
+    partial_t    partial;                        // Merged results
+    unsigned int nbCovered = 0;                  // Number of shards covered by the results
+    int          status;                         // Status of the program
+
+    if (argc < 3) {
+        PRINT(NORM, "Usage: %s OUTPUT INPUT...", argv[0]);
+        return -1;
+    }
+
+    //========== Merge the files
+    if (partial_readAll((const char**)argv + 2, (size_t)(argc - 2), &partial))
+        return -1;
+    status = partial_write(partial, argv[1]);
+
+    if (!status) {
+        for (unsigned int s = 0; s < partial->nbShards; s=s+1)
+            nbCovered = nbCovered + partial->shards[s];
+        PRINT(
+            NORM, "%s: %u of %u shards of %s%s", argv[1], nbCovered, partial->nbShards, partial->tool,
+            partial_complete(partial) ? ", complete" : ""
+        );
+    }
+
+    //========== Free memory
+    partial_destroy(partial);
+
+    return status;
+}
@@ -0,0 +1,413 @@
+/**
+ * @file nfcsim_sweep.c
+ * @author OUSSET Gaël
+ * @brief Sweep of the parameters of a mode, decoding the signal of each
+ *        point of the grid
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "nfcsim.h"
+#include "assert.h"
+#include "context.h"
+#include "parallel.h"
+#include "prng.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Maximum number of values of an axis
+ */
+#define SWEEP_MAX_VALUES 4096
+
+/**
+ * Number of measures of a point
+ */
+#define SWEEP_NB_MEASURES 3
+
+//========== Structures declarations
+/**
+ * @brief Options of the program
+ * 
+ */
+typedef struct {
+    size_t       mode;                           // Index of the mode in sweep_modes
+    unsigned int dataSize;                       // Size of the payload (bytes)
+    unsigned int pointsPerBit;                   // Points per bit, 3 per period of the carrier at least
+    unsigned int seed;                           // Seed of the payload and of the noise
+    const char*  output;                         // CSV file of the results
+    shard_t      shard;                          // Shard of the visit of the grid
+    const char*  partial;                        // Partial result file of the shard, NULL to write the CSV file
+} sweep_options_t;
+
+/**
+ * @brief Arguments of the measures, keeping the measures of the points
+ *        for the partial results
+ * 
+ */
+typedef struct {
+    const char*    data;                         // Sent payload
+    double*        measures;                     // Measures of each point, NULL if not kept
+    unsigned char* done;                         // 1 for each measured point
+} sweep_user_t;
+
+/**
+ * @brief Modes of the signals
+ * 
+ */
+static const struct {
+    nfc_standard_t   standard;                   // NFC standard
+    nfc_dataTransm_t dataTransm;                 // Data transmission mode
+    const char*      name;                       // Name of the mode, as given to --mode
+} sweep_modes[] = {
+    {NFC_A, PCD,  "A_PCD"},
+    {NFC_A, PICC, "A_PICC"},
+    {NFC_B, PCD,  "B_PCD"},
+    {NFC_B, PICC, "B_PICC"}
+};
+
+/**
+ * @brief Names of the measures of a point
+ * 
+ */
+static const char* sweep_measureNames[SWEEP_NB_MEASURES] = {"rms", "bitErrors", "margin"};
+
+/**
+ * @brief Measure a point: RMS of the signal, wrong bits of the decoded
+ *        payload and margin of the receiver, see sweep_measure_t
+ * 
+ * @param user Arguments of the measures (sweep_user_t)
+ * @param index Index of the point
+ * @param sigParam Parameters of the point
+ * @param signal Signal of the point
+ * @param values Measures of the point
+ * @return int - 0 if success, -1 otherwise
+ */
+static int sweep_measure(void* user, size_t index, nfc_sigParam_t* sigParam, scatter_t signal, double* values) {
+    //========== Variables declaration
+    sweep_user_t* args    = (sweep_user_t*)user; // Arguments of the measures
+    const char*   data    = args->data;          // Sent payload
+    char*         decoded = NULL;                // Decoded payload
+    demod_t       demod;                         // Receiver of the point
+    double        energy  = 0;                   // Sum of the squared amplitudes
+
+    for (size_t i = 0; i < signal->size; i=i+1)
+        energy = energy + signal->points[i].y * signal->points[i].y;
+    values[0] = sqrt(energy / (double)signal->size);
+
+    //========== Decode the signal
+    if (demod_create(sigParam, signal->size, &demod))
+        return -1;
+    decoded = nfc_malloc(sigParam->dataSize);
+    if (!decoded || demod_frame(demod, signal, decoded)) {
+        nfc_free(decoded);
+        demod_destroy(demod);
+        return -1;
+    }
+    values[1] = 0;
+    for (size_t b = 0; b < 8 * sigParam->dataSize; b=b+1)
+        values[1] = values[1] + (((data[b/8] ^ decoded[b/8]) >> (b%8)) & 0x01);
+    values[2] = demod->margin;
+
+    // Each point is measured by a single worker
+    if (args->measures) {
+        memcpy(args->measures + index * SWEEP_NB_MEASURES, values, SWEEP_NB_MEASURES * sizeof(double));
+        args->done[index] = 1;
+    }
+
+    nfc_free(decoded);
+    demod_destroy(demod);
+    return 0;
+}
+
+/**
+ * @brief Print the usage of the program
+ * 
+ * @param program Name of the program
+ */
+static void sweep_usage(const char* program) {
+    PRINT(
+        NORM,
+        "Usage: %s [--mode A_PCD|A_PICC|B_PCD|B_PICC] [--sweep FIELD MIN MAX STEPS]... [--size BYTES] "
+        "[--points-per-bit N] [--seed N] [--output FILE] [--shard i/N --partial FILE]",
+        program
+    );
+    PRINT(NORM, "       %s [--output FILE] --merge FILE...", program);
+    PRINT(NORM, "Fields: bitRate, subCarrierFreq, carrierFreq, modulationIndex, noiseLevel, numberOfPoints");
+}
+
+/**
+ * @brief Add the measured points of a shard to partial results, a row per
+ *        point: its index, the value of each axis, then its measures
+ * 
+ * @param grid Grid of the sweep
+ * @param args Measures of the points
+ * @param partial Results of the shard
+ * @return int - 0 if success, -1 otherwise
+ */
+static int sweep_rows(const sweep_grid_t* grid, const sweep_user_t* args, partial_t partial) {
+    //========== Variables declaration
+    partial_entry_t* entry;                      // Rows of the points
+    const char*      columns[1 + SWEEP_MAX_AXES + SWEEP_NB_MEASURES]; // Names of the columns
+    double           row[1 + SWEEP_MAX_AXES + SWEEP_NB_MEASURES]; // Row of a point
+    size_t           nbColumns = 1 + grid->nbAxes + SWEEP_NB_MEASURES; // Number of columns
+    size_t           rest;                       // Index of a point, divided by the sizes of the faster axes
+
+    columns[0] = "index";
+    for (size_t a = 0; a < grid->nbAxes; a=a+1)
+        columns[1+a] = sweep_fieldName(grid->axes[a].field);
+    for (size_t v = 0; v < SWEEP_NB_MEASURES; v=v+1)
+        columns[1+grid->nbAxes+v] = sweep_measureNames[v];
+    if (partial_entry(partial, "points", PARTIAL_ROWS, nbColumns, &entry) || partial_setColumns(entry, columns))
+        return -1;
+
+    for (size_t i = 0; i < sweep_size(grid); i=i+1) {
+        if (!args->done[i])
+            continue;
+        row[0] = (double)i;
+        rest   = i;
+        for (size_t a = grid->nbAxes; a > 0; a=a-1) {
+            row[a] = grid->axes[a-1].values[rest % grid->axes[a-1].nbValues];
+            rest   = rest / grid->axes[a-1].nbValues;
+        }
+        memcpy(row + 1 + grid->nbAxes, args->measures + i * SWEEP_NB_MEASURES, SWEEP_NB_MEASURES * sizeof(double));
+        if (partial_addRow(entry, row))
+            return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Merge the partial results of all the shards of a sweep and write
+ *        the points as a CSV file, sorted on their index
+ * 
+ * @param filenames Partial result files
+ * @param nbFiles Number of files
+ * @param output CSV file of the results
+ * @return int - 0 if success, -1 otherwise
+ */
+static int sweep_merge(const char** filenames, size_t nbFiles, const char* output) {
+    //========== Variables declaration
+    partial_t        partial;                    // Results of all the shards
+    partial_entry_t* entry;                      // Rows of the points
+    FILE*            file;                       // CSV file of the results
+    int              status = 0;                 // Status of the merge
+
+    if (partial_readAll(filenames, nbFiles, &partial))
+        return -1;
+    entry = partial_find(partial, "points");
+    if (!partial_complete(partial) || !entry || entry->kind != PARTIAL_ROWS) {
+        PRINT(ERR, "Points of some shards are missing");
+        partial_destroy(partial);
+        return -1;
+    }
+
+    file = fopen(output, "w");
+    if (!file) {
+        PRINT(ERR, "Cannot open file %s", output);
+        partial_destroy(partial);
+        return -1;
+    }
+    fprintf(file, "index");
+    for (size_t c = 1; c < entry->size; c=c+1)
+        fprintf(file, "%c%s", CSV_SEPARATOR, entry->columns[c] ? entry->columns[c] : "value");
+    fprintf(file, "\n");
+    for (size_t r = 0; r < entry->nbRows; r=r+1) {
+        fprintf(file, "%zu", (size_t)entry->values[r * entry->size]);
+        for (size_t c = 1; c < entry->size; c=c+1)
+            fprintf(file, "%c%.17g", CSV_SEPARATOR, entry->values[r * entry->size + c]);
+        fprintf(file, "\n");
+    }
+    if (ferror(file)) {
+        PRINT(ERR, "Failed to write the results of the sweep");
+        status = -1;
+    }
+    fclose(file);
+    PRINT(NORM, "Merged %zu points from %zu files", entry->nbRows, nbFiles);
+
+    partial_destroy(partial);
+    return status;
+}
+
+/**
+ * @brief Main function
+ * 
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int - 0 if success
+ */
+int main(int argc, char* argv[]) {
+    //========== Variable declaration
+    sweep_options_t options = {0, 8, 512, 1, "nfcsim_sweep.csv", {0, 1}, NULL}; // Options of the program
+    nfc_context_t   context;                     // Context silencing the library
+    sweep_grid_t    grid;                        // Grid of the sweep
+    double*         values[SWEEP_MAX_AXES];      // Values of the axes
+    double          bounds[2];                   // First and last value of an axis
+    unsigned int    nbSteps;                     // Number of values of an axis
+    nfc_field_t     field;                       // Field of an axis
+    char*           data;                        // Payload of the signals
+    sweep_user_t    args = {NULL, NULL, NULL};   // Arguments of the measures
+    FILE*           output = NULL;               // Results of the sweep, NULL for partial results
+    partial_t       partial = NULL;              // Partial results of the shard
+    char            config[PARTIAL_MAX_NAME];    // Configuration of the sweep
+    int             length;                      // Length of the configuration
+    int             merge = 0;                   // Index of the first file to merge, 0 to sweep
+    unsigned long   nbRuns[NB_STAGES];           // Number of runs of each stage
+    int             status = 0;                  // Status of the program
+
+    grid.nbAxes = 0;
+
+    //========== Parse the arguments
+    for (int i = 1; i < argc && !status; i=i+1) {
+        if (!strcmp(argv[i], "--sweep") && i + 4 < argc && grid.nbAxes < SWEEP_MAX_AXES) {
+            field = 0;
+            for (unsigned int f = FIELD_BIT_RATE; f <= FIELD_NUMBER_OF_POINTS; f=f<<1)
+                if (sweep_fieldName((nfc_field_t)f) && !strcmp(sweep_fieldName((nfc_field_t)f), argv[i+1]))
+                    field = (nfc_field_t)f;
+            bounds[0] = strtod(argv[i+2], NULL);
+            bounds[1] = strtod(argv[i+3], NULL);
+            nbSteps   = (unsigned int)strtoul(argv[i+4], NULL, 10);
+            if (!field || !nbSteps || nbSteps > SWEEP_MAX_VALUES) {
+                sweep_usage(argv[0]);
+                status = -1;
+                break;
+            }
+            values[grid.nbAxes] = malloc(nbSteps * sizeof(double));
+            assert(values[grid.nbAxes], "Failed to allocate memory for the axes", -1);
+            for (unsigned int s = 0; s < nbSteps; s=s+1)
+                values[grid.nbAxes][s] = nbSteps == 1 ? bounds[0] :
+                    bounds[0] + (bounds[1] - bounds[0]) * s / (nbSteps - 1);
+            grid.axes[grid.nbAxes] = (sweep_axis_t){field, values[grid.nbAxes], nbSteps};
+            grid.nbAxes            = grid.nbAxes + 1;
+            i = i + 4;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            sweep_usage(argv[0]);
+            status = -1;
+            break;
+        }
+        if (!strcmp(argv[i], "--mode")) {
+            options.mode = sizeof(sweep_modes) / sizeof(*sweep_modes);
+            for (size_t m = 0; m < sizeof(sweep_modes) / sizeof(*sweep_modes); m=m+1)
+                if (!strcmp(sweep_modes[m].name, argv[i+1]))
+                    options.mode = m;
+            if (options.mode == sizeof(sweep_modes) / sizeof(*sweep_modes)) {
+                sweep_usage(argv[0]);
+                status = -1;
+            }
+        } else if (!strcmp(argv[i], "--size"))
+            options.dataSize = (unsigned int)strtoul(argv[i+1], NULL, 10);
+        else if (!strcmp(argv[i], "--points-per-bit"))
+            options.pointsPerBit = (unsigned int)strtoul(argv[i+1], NULL, 10);
+        else if (!strcmp(argv[i], "--seed"))
+            options.seed = (unsigned int)strtoul(argv[i+1], NULL, 10);
+        else if (!strcmp(argv[i], "--output"))
+            options.output = argv[i+1];
+        else if (!strcmp(argv[i], "--partial"))
+            options.partial = argv[i+1];
+        else if (!strcmp(argv[i], "--shard"))
+            status = shard_parse(argv[i+1], &options.shard);
+        else if (!strcmp(argv[i], "--merge")) {
+            merge = i + 1;
+            break;
+        } else {
+            sweep_usage(argv[0]);
+            status = -1;
+        }
+        i = i + 1;
+    }
+    if (!status && merge)
+        status = sweep_merge((const char**)argv + merge, (size_t)(argc - merge), options.output);
+    if (!status && !merge && (!options.dataSize || !options.pointsPerBit)) {
+        PRINT(ERR, "Empty frames");
+        status = -1;
+    }
+    if (!status && !merge && !options.partial && options.shard.count != 1) {
+        PRINT(ERR, "A shard writes its results with --partial");
+        status = -1;
+    }
+
+    //========== Prepare the sweep
+    // Only the errors of the library are printed
+    if (!status && !merge) {
+        assert(!nfc_contextCreate(&context), "Failed to create the context", -1);
+        nfc_contextSetLog(context, NULL, NULL, ERR);
+        nfc_contextBind(context);
+
+        data = malloc(options.dataSize);
+        assert(data, "Failed to allocate memory for the payload", -1);
+        for (size_t i = 0; i < options.dataSize; i=i+1)
+            data[i] = (char)(prng_hash(options.seed, i) >> 56);
+        grid.seed = options.seed;
+
+        status = nfc_standardParam(
+            data, options.dataSize, sweep_modes[options.mode].standard, sweep_modes[options.mode].dataTransm,
+            BIT_RATE, 0, options.dataSize * 8 * options.pointsPerBit, &grid.base
+        );
+        // The simulation time follows the swept bit rate
+        grid.base.simDuration = 0;
+
+        //========== Run the shard of the sweep
+        // The shards of a sweep share all the options but the shard and the file
+        length = snprintf(
+            config, sizeof(config), "mode %s size %u points-per-bit %u seed %u",
+            sweep_modes[options.mode].name, options.dataSize, options.pointsPerBit, options.seed
+        );
+        for (size_t a = 0; a < grid.nbAxes && length > 0 && (size_t)length < sizeof(config); a=a+1)
+            length = length + snprintf(
+                config + length, sizeof(config) - (size_t)length, " sweep %s %.17g %.17g %zu", sweep_fieldName(grid.axes[a].field),
+                grid.axes[a].values[0], grid.axes[a].values[grid.axes[a].nbValues - 1], grid.axes[a].nbValues
+            );
+        args.data = data;
+        if (!status && options.partial) {
+            args.measures = malloc(sweep_size(&grid) * SWEEP_NB_MEASURES * sizeof(double));
+            args.done     = calloc(sweep_size(&grid), 1);
+            if (!args.measures || !args.done || partial_create("nfcsim_sweep", config, &options.shard, &partial))
+                status = -1;
+        } else if (!status) {
+            output = fopen(options.output, "w");
+            if (!output) {
+                PRINT(ERR, "Cannot open file %s", options.output);
+                status = -1;
+            }
+        }
+        if (!status) {
+            PRINT(
+                NORM, "Sweeping shard %u/%u of %zu points of the %s mode on %u threads", options.shard.index, options.shard.count,
+                sweep_size(&grid), sweep_modes[options.mode].name, parallel_nbThreads()
+            );
+            status = sweep_runShard(&grid, &options.shard, sweep_measure, &args, SWEEP_NB_MEASURES, sweep_measureNames, output, nbRuns);
+        }
+        if (output)
+            fclose(output);
+        if (!status && partial)
+            status = sweep_rows(&grid, &args, partial) || partial_write(partial, options.partial);
+        if (!status)
+            PRINT(
+                NORM, "Runs of the stages: encode %lu, sub-carrier %lu, envelope %lu, modulate %lu, noise %lu",
+                nbRuns[STAGE_ENCODE], nbRuns[STAGE_SUBCARRIER], nbRuns[STAGE_ENVELOPE], nbRuns[STAGE_MODULATE], nbRuns[STAGE_NOISE]
+            );
+
+        if (partial)
+            partial_destroy(partial);
+        free(args.measures);
+        free(args.done);
+        free(data);
+        nfc_contextBind(NULL);
+        nfc_contextDestroy(context);
+    }
+
+    //========== Free memory
+    for (size_t a = 0; a < grid.nbAxes; a=a+1)
+        free(values[a]);
+
+    return status;
+}
@@ -12,9 +12,12 @@
 #include "CSV.h"
 #include "logging.h"
 #include "assert.h"
+#include "profile.h"
 #include <stdio.h>
 
 int writeCSV(scatter_t* scatters, size_t nbScatters, char* filename) {
+    PROFILE_STAGE(PROF_CSV);
+
     PRINT(INFO, "Writing %ld cloud(s) of points to file \"%s\"", nbScatters, filename);
 
     //========== Variables declaration
@@ -62,6 +65,7 @@ int writeCSV(scatter_t* scatters, size_t nbScatters, char* filename) {
     }
 
     //========== Closing the file
+    PROFILE_COUNT(nbLines * nbScatters, (size_t)ftell(file));
     fclose(file);
     PRINT(SUCC, "Cloud(s) of points written to file \"%s\"", filename);
     
@@ -12,10 +12,23 @@
 #include "FFT.h"
 #include "logging.h"
 #include "assert.h"
+#include "context.h"
+#include "cpu.h"
 #include <stdlib.h>
 #include <math.h>
 #include <complex.h>
 
+/**
+ * Oversampling of the grid of the non-uniform FFT
+ */
+#define NUFFT_OVERSAMPLING 2
+
+/**
+ * Number of grid points spread on each side of a sample by the non-uniform
+ * FFT, 12 gives a relative error around 1e-12
+ */
+#define NUFFT_SPREAD 12
+
 double fft_getAvgSamplingRate(scatter_t timeSerie) {
     //========== Variables declaration
     double avgSamplingRate = 0;
@@ -37,16 +50,15 @@ double fft_getAvgSamplingRate(scatter_t timeSerie) {
 }
 
 int fft_Iterative(scatter_t in, scatter_t out) {
+    PROFILE_STAGE(PROF_FFT);
+
     //========== Variables declaration
     int j = 0;
     int bit;
     double temp;
-    double angle;
-    complex double wlen;
-    complex double w;
-    complex double u;
-    complex double t;
-    complex double* X;
+    complex double* X;                           // Values, then n/2 twiddle factors
+    nfc_context_t context = nfc_contextGet();    // Context holding the scratch memory
+    char ownX;                                   // 1 if X is not the scratch memory
 
     //========== Check variables
     assert(in, "Input cloud of points cannot be NULL", -1);
@@ -66,7 +78,10 @@ int fft_Iterative(scatter_t in, scatter_t out) {
         -1
     );
 
-    X = malloc(in->size * sizeof(complex double));
+    X    = nfc_contextScratch(context, (in->size + in->size/2) * sizeof(complex double));
+    ownX = !X;
+    if (ownX)
+        X = nfc_malloc((in->size + in->size/2) * sizeof(complex double));
     assert(X, "Failed to allocate memory for the complex cloud of points", -1);
 
     for (size_t i = 0; i < in->size; i=i+1)
@@ -88,30 +103,20 @@ int fft_Iterative(scatter_t in, scatter_t out) {
     }
     
     //========== FFT
-    for (int len = 2; (size_t)len <= in->size; len=len<<1) {
-        angle = -2.0 * M_PI / len;
-        wlen = cexp(I * angle);
-        for (int i = 0; (size_t)i < in->size; i=i+len) {
-            w = 1.0;
-            for (j = 0; j < len / 2; j=j+1) {
-                u = X[i + j];
-                t = w * X[i+j+len/2];
-                X[i+j]       = u + t;
-                X[i+j+len/2] = u - t;
-                w = w * wlen;
-            }
-        }
-    }
+    cpu_kernels()->butterflies(X, X + in->size, in->size);
 
     //========== Set the output cloud of points
-    for (size_t i = 0; i < in->size; i=i+1)
-        scatter_setY(out, i, cabs(X[i]));
+    cpu_kernels()->magnitude(X, out->points, in->size);
 
-    free(X);
+    if (ownX)
+        nfc_free(X);
+    PROFILE_COUNT(in->size, in->size * sizeof(point_t));
     return 0;
 }
 
 int fft_Compute(scatter_t timeSerie, scatter_t* freqSerie) {
+    PROFILE_STAGE(PROF_FFT);
+
     //========== Variable declaration
     double AvgSamplingRate;
 
@@ -152,4 +157,124 @@ int fft_Compute(scatter_t timeSerie, scatter_t* freqSerie) {
 
     PRINT(SUCC, "FFT successfully applied");
     return 0;
-}
\ No newline at end of file
+}
+
+int fft_NonUniform(scatter_t timeSerie, double fStart, double fStep, size_t nbFrequencies, scatter_t* freqSerie) {
+    PROFILE_STAGE(PROF_FFT);
+
+    //========== Variables declaration
+    size_t          n    = 0;                    // Number of samples
+    size_t          half = nbFrequencies / 2;    // Frequencies below the center of the grid
+    size_t          size = 1;                    // Size of the grid, power of 2
+    double          h;                           // Step of the grid (rad)
+    double          tau;                         // Variance of the Gaussian kernel
+    double          E3[NUFFT_SPREAD + 1];        // Gaussian kernel on the grid points
+    double          period;                      // Average sampling period (ns)
+    double          weight;                      // Weight of a sample
+    double          phase;                       // Phase of a sample, in turns
+    complex double  c;                           // Weighted and shifted sample
+    double          x;                           // Position of a sample on the grid (rad)
+    size_t          m0;                          // Grid point before the sample
+    double          xi;                          // Distance from the grid point to the sample
+    double          E1;                          // Kernel at the grid point before the sample
+    double          E2;                          // Ratio of the kernel between grid points
+    double          up;                          // Powers of E2
+    double          down;                        // Powers of 1/E2
+    complex double* X;                           // Grid, then size/2 twiddle factors
+    complex double  swap;                        // Swapped value of the bit-reversal
+    double          k;                           // Frequency index, from the center of the grid
+    int             j    = 0;                    // Bit-reversed index
+    int             bit;                         // Bit of the bit-reversal
+
+    //========== Check arguments
+    assert(timeSerie, "Time serie cannot be NULL", -1);
+    assert(timeSerie->points, "Time serie cannot be NULL", -1);
+    assert(timeSerie->size, "Time serie size cannot be null", -1);
+    assert(nbFrequencies, "Number of frequencies cannot be null", -1);
+    assert(fStep > 0, "Frequency step must be positive", -1);
+    n = timeSerie->size;
+
+    //========== Grid and Gaussian kernel
+    while (size < NUFFT_OVERSAMPLING * nbFrequencies || size < 2 * NUFFT_SPREAD)
+        size = size << 1;
+    h   = 2 * M_PI / (double)size;
+    // Kernel of Greengard and Lee for size/NUFFT_OVERSAMPLING frequencies, at least nbFrequencies
+    tau = M_PI * NUFFT_SPREAD * NUFFT_OVERSAMPLING /
+          ((double)size * (double)size * (NUFFT_OVERSAMPLING - 0.5));
+    for (int l = 0; l <= NUFFT_SPREAD; l=l+1)
+        E3[l] = exp(-pow((double)l * h, 2) / (4 * tau));
+
+    X = nfc_calloc(size + size/2, sizeof(complex double));
+    assert(X, "Failed to allocate memory for the grid", -1);
+
+    //========== Spread the samples on the grid
+    period = n > 1 ? (double)(timeSerie->points[n-1].x - timeSerie->points[0].x) / (double)(n - 1) : 0;
+    for (size_t i = 0; i < n; i=i+1) {
+        //----- Time the sample stands for
+        if (n == 1 || period <= 0)
+            weight = 1;
+        else if (i == 0)
+            weight = (double)(timeSerie->points[1].x - timeSerie->points[0].x) / period;
+        else if (i == n - 1)
+            weight = (double)(timeSerie->points[n-1].x - timeSerie->points[n-2].x) / period;
+        else
+            weight = (double)(timeSerie->points[i+1].x - timeSerie->points[i-1].x) / (2 * period);
+
+        //----- Shift the first frequency to the center of the grid
+        phase = (fStart + (double)half * fStep) * (double)timeSerie->points[i].x * 1e-9;
+        c     = weight * timeSerie->points[i].y * cexp(-2 * M_PI * I * (phase - floor(phase)));
+
+        //----- Gaussian gridding: E1 * E2^l * E3[l] on the grid point m0 + l
+        x    = fStep * (double)timeSerie->points[i].x * 1e-9;
+        x    = 2 * M_PI * (x - floor(x));
+        m0   = (size_t)(x / h);
+        xi   = x - (double)m0 * h;
+        m0   = m0 % size;
+        E1   = exp(-xi * xi / (4 * tau));
+        E2   = exp(xi * h / (2 * tau));
+        up   = E1;
+        down = E1 / E2;
+        for (int l = 0; l < NUFFT_SPREAD; l=l+1) {
+            X[(m0 + (size_t)l) % size]                 += c * up * E3[l];
+            X[(m0 + size - (size_t)l - 1) % size]      += c * down * E3[l+1];
+            up   = up * E2;
+            down = down / E2;
+        }
+    }
+
+    //========== FFT of the grid
+    for (int i = 1; (size_t)i < size; i=i+1) {
+        bit = (int)size >> 1;
+        while (j >= bit) {
+            j = j - bit;
+            bit = bit >> 1;
+        }
+        j = j + bit;
+        if (i < j) {
+            swap = X[i];
+            X[i] = X[j];
+            X[j] = swap;
+        }
+    }
+    cpu_kernels()->butterflies(X, X + size, size);
+
+    //========== Deconvolve the kernel
+    if (scatter_create(freqSerie, nbFrequencies)) {
+        PRINT(ERR, "Failed to allocate memory for the frequency serie");
+        nfc_free(X);
+        return -1;
+    }
+    for (size_t i = 0; i < nbFrequencies; i=i+1) {
+        k = (double)i - (double)half;
+        scatter_setX(*freqSerie, i, (int)lround(fStart + (double)i * fStep));
+        scatter_setY(
+            *freqSerie, i,
+            sqrt(M_PI / tau) * exp(k * k * tau) / (double)size *
+            cabs(X[(i + size - half) % size])
+        );
+    }
+
+    nfc_free(X);
+    PROFILE_COUNT(n, n * sizeof(point_t));
+    return 0;
+}
@@ -0,0 +1,224 @@
+/**
+ * @file ber.c
+ * @author OUSSET Gaël
+ * @brief Monte-Carlo bit error rate of the modes
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "ber.h"
+#include "CSV.h"
+#include "demod.h"
+#include "logging.h"
+#include "assert.h"
+#include "context.h"
+#include "parallel.h"
+#include "prng.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+//========== Structures declarations
+/**
+ * @brief Arguments shared by the chunks of a round of trials
+ * 
+ */
+typedef struct {
+    const ber_config_t* config;                  // Parameters of the run
+    double              noiseLevel;              // Noise level of the round
+    uint64_t            levelSeed;               // Seed of the noise level
+    uint64_t            firstTrial;              // Number of the first trial of the round
+    uint64_t            bitErrors[BER_ROUND_SIZE]; // Wrong bits of each trial of the round
+    int                 status;                  // -1 if a chunk failed
+} ber_task_t;
+
+//========== Functions
+void ber_interval(uint64_t nbErrors, uint64_t nbTrials, double* rate, double* low, double* high) {
+    //========== Variables declaration
+    double n;                                    // Number of trials
+    double z2;                                   // Square of the quantile
+    double centre;                               // Centre of the interval
+    double half;                                 // Half width of the interval
+
+    if (!nbTrials) {
+        *rate = 0;
+        *low  = 0;
+        *high = 1;
+        return;
+    }
+
+    n      = (double)nbTrials;
+    z2     = BER_Z * BER_Z;
+    *rate  = (double)nbErrors / n;
+    centre = (*rate + z2 / (2 * n)) / (1 + z2 / n);
+    half   = BER_Z * sqrt(*rate * (1 - *rate) / n + z2 / (4 * n * n)) / (1 + z2 / n);
+    *low   = fmax(centre - half, 0);
+    *high  = fmin(centre + half, 1);
+}
+
+/**
+ * @brief Run the trials [first, last) of a round, see parallel_task_t. The
+ *        chunk draws its noise in its own context, forked from the caller.
+ * 
+ * @param arg Arguments of the round (ber_task_t)
+ * @param first First trial of the chunk in the round
+ * @param last Trial after the last one of the chunk
+ */
+static void ber_chunk(void* arg, size_t first, size_t last) {
+    //========== Variables declaration
+    ber_task_t*         task     = (ber_task_t*)arg; // Arguments of the round
+    const ber_config_t* config   = task->config; // Parameters of the run
+    nfc_context_t       previous = nfc_contextGet(); // Context of the thread before the chunk
+    nfc_context_t       context  = NULL;         // Context of the trials
+    nfc_sigParam_t      sigParam;                // Parameters of the frames
+    demod_t             demod    = NULL;         // Receiver of the frames
+    char*               data     = NULL;         // Payload of a trial
+    char*               decoded  = NULL;         // Decoded payload of a trial
+    scatter_t           signal;                  // Frame of a trial
+    uint64_t            trialSeed;               // Seed of a trial
+    uint64_t            dataSeed;                // Seed of the payload of a trial
+    uint64_t            errors;                  // Wrong bits of a trial
+
+    //========== Create the context of the chunk
+    if (nfc_contextFork(&context)) {
+        task->status = -1;
+        return;
+    }
+    nfc_contextBind(context);
+
+    // The payload is printed as a string while generating the frame
+    data    = nfc_calloc(config->dataSize + 1, 1);
+    decoded = nfc_malloc(config->dataSize);
+    if (!data || !decoded) {
+        PRINT(ERR, "Failed to allocate memory for the payloads");
+        goto fail;
+    }
+    if (nfc_standardParam(
+            data, config->dataSize, config->standard, config->dataTransm, config->bitRate,
+            task->noiseLevel, config->numberOfPoints, &sigParam
+        ) ||
+        demod_create(&sigParam, config->numberOfPoints, &demod))
+        goto fail;
+
+    //========== Run the trials
+    for (size_t t = first; t < last; t=t+1) {
+        trialSeed = prng_hash(task->levelSeed, task->firstTrial + t);
+        dataSeed  = prng_hash(trialSeed, 0);
+        for (size_t i = 0; i < config->dataSize; i=i+1)
+            data[i] = (char)(prng_hash(dataSeed, i) >> 56);
+        nfc_contextSeed(context, prng_hash(trialSeed, 1));
+
+        if (nfc_createSignal(&sigParam, &signal))
+            goto fail;
+        if (demod_frame(demod, signal, decoded)) {
+            scatter_destroy(signal);
+            goto fail;
+        }
+        scatter_destroy(signal);
+
+        errors = 0;
+        for (size_t b = 0; b < 8 * config->dataSize; b=b+1)
+            errors = errors + (((data[b/8] ^ decoded[b/8]) >> (b%8)) & 0x01);
+        task->bitErrors[t] = errors;
+    }
+    goto end;
+
+fail:
+    task->status = -1;
+end:
+    if (demod)
+        demod_destroy(demod);
+    nfc_free(data);
+    nfc_free(decoded);
+    nfc_contextBind(previous);
+    nfc_contextDestroy(context);
+}
+
+int ber_run(const ber_config_t* config, ber_result_t* results) {
+    //========== Variables declaration
+    ber_task_t    task;                          // Arguments of the rounds
+    ber_result_t* r;                             // Result of the noise level
+    uint64_t      nbTrials;                      // Number of trials of a round
+    uint64_t      bits;                          // Bits of the noise level
+
+    //========== Check arguments
+    assert(config, "Configuration cannot be NULL", -1);
+    assert(results, "Results cannot be NULL", -1);
+    assert(config->noiseLevels || !config->nbNoiseLevels, "Noise levels cannot be NULL", -1);
+    assert(config->dataSize, "Size of the payload cannot be null", -1);
+    assert(config->numberOfPoints, "Number of points cannot be null", -1);
+    assert(config->maxTrials, "Maximum number of trials cannot be null", -1);
+
+    task.config = config;
+
+    for (size_t l = 0; l < config->nbNoiseLevels; l=l+1) {
+        //----- Seed of the noise level, independent of the other levels
+        r = &results[l];
+        memset(r, 0, sizeof(*r));
+        r->noiseLevel = config->noiseLevels[l];
+        memcpy(&bits, &r->noiseLevel, sizeof(bits));
+        task.noiseLevel = r->noiseLevel;
+        task.levelSeed  = prng_hash(config->seed, bits);
+
+        //----- Rounds of trials until the interval is narrow enough
+        while (r->nbFrames < config->maxTrials && !r->converged) {
+            nbTrials        = config->maxTrials - r->nbFrames;
+            nbTrials        = nbTrials < BER_ROUND_SIZE ? nbTrials : BER_ROUND_SIZE;
+            task.firstTrial = r->nbFrames;
+            task.status     = 0;
+            if (parallel_for(nbTrials, 1, ber_chunk, &task) || task.status) {
+                PRINT(ERR, "Failed to run the trials at the noise level %g", r->noiseLevel);
+                return -1;
+            }
+
+            for (size_t t = 0; t < nbTrials; t=t+1) {
+                r->nbBitErrors   = r->nbBitErrors + task.bitErrors[t];
+                r->nbFrameErrors = r->nbFrameErrors + (task.bitErrors[t] != 0);
+            }
+            r->nbFrames = r->nbFrames + nbTrials;
+            r->nbBits   = r->nbFrames * 8 * config->dataSize;
+
+            ber_interval(r->nbBitErrors, r->nbBits, &r->ber, &r->berLow, &r->berHigh);
+            r->converged = r->nbBitErrors && r->nbBitErrors >= config->minErrors &&
+                           (r->berHigh - r->berLow) / 2 <= config->precision * r->ber;
+        }
+        ber_interval(r->nbFrameErrors, r->nbFrames, &r->fer, &r->ferLow, &r->ferHigh);
+
+        PRINT(
+            INFO, "Noise level %g: %llu frames, BER %g [%g, %g], FER %g",
+            r->noiseLevel, (unsigned long long)r->nbFrames, r->ber, r->berLow, r->berHigh, r->fer
+        );
+    }
+
+    return 0;
+}
+
+int ber_writeTable(FILE* file, const ber_result_t* results, size_t nbResults) {
+    //========== Check arguments
+    assert(file, "File cannot be NULL", -1);
+    assert(results || !nbResults, "Results cannot be NULL", -1);
+
+    //========== Write the table
+    fprintf(
+        file, "Noise%cFrames%cFrame errors%cBits%cBit errors%cBER%cBER low%cBER high%cFER%cFER low%cFER high%cConverged\n",
+        CSV_SEPARATOR, CSV_SEPARATOR, CSV_SEPARATOR, CSV_SEPARATOR, CSV_SEPARATOR, CSV_SEPARATOR,
+        CSV_SEPARATOR, CSV_SEPARATOR, CSV_SEPARATOR, CSV_SEPARATOR, CSV_SEPARATOR
+    );
+    for (size_t i = 0; i < nbResults; i=i+1)
+        fprintf(
+            file, "%g%c%llu%c%llu%c%llu%c%llu%c%.6e%c%.6e%c%.6e%c%.6e%c%.6e%c%.6e%c%d\n",
+            results[i].noiseLevel, CSV_SEPARATOR,
+            (unsigned long long)results[i].nbFrames, CSV_SEPARATOR,
+            (unsigned long long)results[i].nbFrameErrors, CSV_SEPARATOR,
+            (unsigned long long)results[i].nbBits, CSV_SEPARATOR,
+            (unsigned long long)results[i].nbBitErrors, CSV_SEPARATOR,
+            results[i].ber, CSV_SEPARATOR, results[i].berLow, CSV_SEPARATOR, results[i].berHigh, CSV_SEPARATOR,
+            results[i].fer, CSV_SEPARATOR, results[i].ferLow, CSV_SEPARATOR, results[i].ferHigh, CSV_SEPARATOR,
+            results[i].converged
+        );
+
+    return ferror(file) ? -1 : 0;
+}
@@ -0,0 +1,422 @@
+/**
+ * @file context.c
+ * @author OUSSET Gaël
+ * @brief Execution context of the library: random generator, logging,
+ *        allocator and scratch memory
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "context.h"
+#include "prng.h"
+#include "assert.h"
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Seed of the random generator of a new context
+ */
+#define DEFAULT_SEED 0x6E666373696DULL
+
+/**
+ * @brief Header placed before the blocks given by nfc_malloc(), keeps the
+ *        alignment of the allocator. A block may be freed in another context
+ *        than the one it comes from, so it keeps its allocator.
+ * 
+ */
+typedef union {
+    struct {
+        size_t          size;                    // Size asked for the block
+        prof_stage_t    stage;                   // Stage that allocated the block
+        nfc_allocator_t allocator;               // Allocator of the block
+    } info;
+    max_align_t align;                           // Alignment of the block
+} nfc_blockHeader_t;
+
+//========== Standard allocator
+/**
+ * @brief Allocate a block with malloc()
+ * 
+ * @param user Unused
+ * @param size Size of the block
+ * @return void* - Allocated block
+ */
+static void* nfc_stdAlloc(void* user, size_t size) {
+    (void)user;
+    return malloc(size);
+}
+
+/**
+ * @brief Resize a block with realloc()
+ * 
+ * @param user Unused
+ * @param ptr Block to resize
+ * @param size New size of the block
+ * @return void* - Resized block
+ */
+static void* nfc_stdRealloc(void* user, void* ptr, size_t size) {
+    (void)user;
+    return realloc(ptr, size);
+}
+
+/**
+ * @brief Free a block with free()
+ * 
+ * @param user Unused
+ * @param ptr Block to free
+ */
+static void nfc_stdFree(void* user, void* ptr) {
+    (void)user;
+    free(ptr);
+}
+
+//========== Contexts of the threads
+/**
+ * @brief Context used by a thread when none is bound. Each thread has its
+ *        own, so unbound threads never share state.
+ * 
+ */
+static _Thread_local struct nfc_context nfc_defaultContext = {
+    DEFAULT_SEED,
+    0,
+    NULL,
+    NULL,
+    VERBOSITY,
+    {nfc_stdAlloc, nfc_stdRealloc, nfc_stdFree, NULL},
+    NULL,
+    0,
+    PTHREAD_MUTEX_INITIALIZER,
+    {{0}},
+    {0},
+    {{0}},
+    NULL,
+    NULL
+};
+
+/**
+ * @brief Context bound to the thread, NULL if none
+ * 
+ */
+static _Thread_local nfc_context_t nfc_boundContext = NULL;
+
+/**
+ * @brief 1 if the bound context belongs to another thread, see
+ *        nfc_contextShare()
+ * 
+ */
+static _Thread_local int nfc_boundShared = 0;
+
+/**
+ * @brief Stage run by the thread
+ * 
+ */
+static _Thread_local prof_stage_t nfc_stage = PROF_OTHER;
+
+int nfc_contextCreate(nfc_context_t* context) {
+    *context = malloc(sizeof(**context));
+    assert(*context, "Failed to allocate memory for the context", -1);
+
+    (*context)->seed        = DEFAULT_SEED;
+    (*context)->counter     = 0;
+    (*context)->logSink     = NULL;
+    (*context)->logUser     = NULL;
+    (*context)->verbosity   = VERBOSITY;
+    (*context)->scratch     = NULL;
+    (*context)->scratchSize = 0;
+    memset((*context)->memStats, 0, sizeof((*context)->memStats));
+    memset(&(*context)->memTotal, 0, sizeof((*context)->memTotal));
+    memset((*context)->profStats, 0, sizeof((*context)->profStats));
+    (*context)->counters    = NULL;
+    (*context)->parent      = NULL;
+    nfc_contextSetAllocator(*context, NULL);
+    if (pthread_mutex_init(&(*context)->lock, NULL)) {
+        free(*context);
+        PRINT(ERR, "Failed to create the lock of the context");
+        return -1;
+    }
+
+    return 0;
+}
+
+int nfc_contextFork(nfc_context_t* context) {
+    //========== Variables declaration
+    nfc_context_t parent = nfc_contextGet();     // Context of the thread
+
+    if (nfc_contextCreate(context))
+        return -1;
+    nfc_contextSetLog(*context, parent->logSink, parent->logUser, parent->verbosity);
+    nfc_contextSetAllocator(*context, &parent->allocator);
+    (*context)->parent = parent;
+
+    return 0;
+}
+
+/**
+ * @brief Add the memory used by a stage of a context to another one
+ * 
+ * @param stats Memory used by the stage in the receiving context
+ * @param other Memory used by the stage in the other context
+ */
+static void nfc_statsMerge(nfc_memStats_t* stats, const nfc_memStats_t* other) {
+    stats->bytes     = stats->bytes + other->bytes;
+    stats->peak      = stats->peak > other->peak ? stats->peak : other->peak;
+    stats->peak      = stats->peak > stats->bytes ? stats->peak : stats->bytes;
+    stats->total     = stats->total + other->total;
+    stats->nbAlloc   = stats->nbAlloc + other->nbAlloc;
+    stats->nbRealloc = stats->nbRealloc + other->nbRealloc;
+    stats->nbFree    = stats->nbFree + other->nbFree;
+}
+
+void nfc_contextDestroy(nfc_context_t context) {
+    //========== Variables declaration
+    prof_stats_t* to;                            // Timing of a stage in the parent
+    prof_stats_t* from;                          // Timing of a stage in the context
+
+    // The pending messages may use the sink of the context
+    printFlush();
+
+    //========== Give the statistics to the parent
+    if (context->parent) {
+        pthread_mutex_lock(&context->parent->lock);
+        for (int stage = 0; stage < NB_PROF_STAGES; stage=stage+1) {
+            nfc_statsMerge(&context->parent->memStats[stage], &context->memStats[stage]);
+            to            = &context->parent->profStats[stage];
+            from          = &context->profStats[stage];
+            to->nbCalls   = to->nbCalls + from->nbCalls;
+            to->time      = to->time + from->time;
+            to->nbSamples = to->nbSamples + from->nbSamples;
+            to->nbBytes   = to->nbBytes + from->nbBytes;
+            for (int i = 0; i < NB_PROF_COUNTERS; i=i+1)
+                to->counters[i] = to->counters[i] + from->counters[i];
+        }
+        nfc_statsMerge(&context->parent->memTotal, &context->memTotal);
+        pthread_mutex_unlock(&context->parent->lock);
+    }
+
+    prof_countersDestroy(context->counters);
+    if (context->scratch)
+        context->allocator.free(context->allocator.user, context->scratch);
+    pthread_mutex_destroy(&context->lock);
+    free(context);
+}
+
+void nfc_contextBind(nfc_context_t context) {
+    nfc_boundContext = context;
+    nfc_boundShared  = 0;
+}
+
+void nfc_contextShare(nfc_context_t context) {
+    nfc_boundContext = context;
+    nfc_boundShared  = 1;
+}
+
+nfc_context_t nfc_contextGet(void) {
+    return nfc_boundContext ? nfc_boundContext : &nfc_defaultContext;
+}
+
+void nfc_contextSeed(nfc_context_t context, uint64_t seed) {
+    context->seed    = seed;
+    context->counter = 0;
+}
+
+void nfc_contextSetLog(nfc_context_t context, nfc_logSink_t sink, void* user, int verbosity) {
+    printFlush();
+    context->logSink   = sink;
+    context->logUser   = user;
+    context->verbosity = verbosity;
+}
+
+void nfc_contextSetAllocator(nfc_context_t context, nfc_allocator_t* allocator) {
+    if (allocator) {
+        context->allocator = *allocator;
+        return;
+    }
+    context->allocator.alloc   = nfc_stdAlloc;
+    context->allocator.realloc = nfc_stdRealloc;
+    context->allocator.free    = nfc_stdFree;
+    context->allocator.user    = NULL;
+}
+
+double nfc_contextRandom(nfc_context_t context) {
+    return prng_uniform(context->seed, nfc_contextDraw(context, 1));
+}
+
+uint64_t nfc_contextDraw(nfc_context_t context, uint64_t nbValues) {
+    return atomic_fetch_add_explicit(&context->counter, nbValues, memory_order_relaxed);
+}
+
+prof_stage_t nfc_contextStage(void) {
+    return nfc_stage;
+}
+
+void nfc_contextSetStage(prof_stage_t stage) {
+    nfc_stage = stage;
+}
+
+void* nfc_contextScratch(nfc_context_t context, size_t size) {
+    //========== Variables declaration
+    void* scratch;                               // Grown scratch memory
+
+    // Default contexts live as long as their thread, they keep no memory,
+    // and the scratch memory of a shared context is used by its thread
+    if (context == &nfc_defaultContext || (nfc_boundShared && context == nfc_boundContext))
+        return NULL;
+    if (size <= context->scratchSize)
+        return context->scratch;
+
+    scratch = context->allocator.realloc(context->allocator.user, context->scratch, size);
+    if (!scratch)
+        return NULL;
+    context->scratch     = scratch;
+    context->scratchSize = size;
+
+    return scratch;
+}
+
+nfc_memStats_t nfc_contextMemStats(nfc_context_t context, prof_stage_t stage) {
+    if (stage >= NB_PROF_STAGES)
+        return context->memTotal;
+    return context->memStats[stage];
+}
+
+void nfc_contextMemReport(nfc_context_t context, print_type_t print_type) {
+    //========== Variables declaration
+    nfc_memStats_t stats;                        // Memory used by a stage
+    int            i;                            // Loop index
+
+    PRINT(print_type, "%-12s %14s %14s %14s %10s %10s %10s",
+          "Stage", "Current (B)", "Peak (B)", "Total (B)", "Allocs", "Reallocs", "Frees");
+    for (i=0; i<=NB_PROF_STAGES; i=i+1) {
+        stats = nfc_contextMemStats(context, (prof_stage_t)i);
+        if (i < NB_PROF_STAGES && !stats.nbAlloc && !stats.nbRealloc && !stats.nbFree)
+            continue;
+        PRINT(print_type, "%-12s %14llu %14llu %14llu %10lu %10lu %10lu",
+              i < NB_PROF_STAGES ? prof_stageName((prof_stage_t)i) : "all",
+              stats.bytes, stats.peak, stats.total,
+              stats.nbAlloc, stats.nbRealloc, stats.nbFree);
+    }
+}
+
+//========== Allocation accounting
+/**
+ * @brief Count bytes allocated by a stage
+ * 
+ * @param stats Memory used by the stage
+ * @param size Number of bytes allocated
+ */
+static void nfc_statsAdd(nfc_memStats_t* stats, size_t size) {
+    stats->bytes = stats->bytes + size;
+    stats->total = stats->total + size;
+    if (stats->bytes > stats->peak)
+        stats->peak = stats->bytes;
+}
+
+/**
+ * @brief Count bytes released from a stage. A block may be freed in another
+ *        context than the one it comes from, so the count saturates at 0.
+ * 
+ * @param stats Memory used by the stage
+ * @param size Number of bytes released
+ */
+static void nfc_statsRemove(nfc_memStats_t* stats, size_t size) {
+    stats->bytes = stats->bytes > size ? stats->bytes - size : 0;
+}
+
+//========== Allocation through the current context
+void* nfc_malloc(size_t size) {
+    //========== Variables declaration
+    nfc_context_t      context = nfc_contextGet(); // Context of the thread
+    nfc_blockHeader_t* header;                   // Header of the block
+
+    if (size > (size_t)-1 - sizeof(nfc_blockHeader_t))
+        return NULL;
+    header = context->allocator.alloc(context->allocator.user, sizeof(nfc_blockHeader_t) + size);
+    if (!header)
+        return NULL;
+    header->info.size      = size;
+    header->info.stage     = nfc_stage;
+    header->info.allocator = context->allocator;
+
+    pthread_mutex_lock(&context->lock);
+    nfc_statsAdd(&context->memStats[nfc_stage], size);
+    nfc_statsAdd(&context->memTotal, size);
+    context->memStats[nfc_stage].nbAlloc = context->memStats[nfc_stage].nbAlloc + 1;
+    context->memTotal.nbAlloc            = context->memTotal.nbAlloc + 1;
+    pthread_mutex_unlock(&context->lock);
+
+    return header + 1;
+}
+
+void* nfc_calloc(size_t nb, size_t size) {
+    //========== Variables declaration
+    unsigned char* ptr;                          // Allocated block
+
+    if (size && nb > (size_t)-1 / size)
+        return NULL;
+    ptr = nfc_malloc(nb * size);
+    if (ptr)
+        memset(ptr, 0, nb * size);
+
+    return ptr;
+}
+
+void* nfc_realloc(void* ptr, size_t size) {
+    //========== Variables declaration
+    nfc_context_t      context = nfc_contextGet(); // Context of the thread
+    nfc_blockHeader_t* header;                   // Header of the block
+    size_t             oldSize;                  // Size of the block before the call
+    prof_stage_t       oldStage;                 // Stage of the block before the call
+    nfc_allocator_t    allocator;                // Allocator of the block
+
+    if (!ptr)
+        return nfc_malloc(size);
+    if (size > (size_t)-1 - sizeof(nfc_blockHeader_t))
+        return NULL;
+
+    header    = (nfc_blockHeader_t*)ptr - 1;
+    oldSize   = header->info.size;
+    oldStage  = header->info.stage;
+    allocator = header->info.allocator;
+    // The block stays with the allocator that created it
+    header    = allocator.realloc(allocator.user, header, sizeof(nfc_blockHeader_t) + size);
+    if (!header)
+        return NULL;
+    // The block now belongs to the stage that resized it
+    header->info.size  = size;
+    header->info.stage = nfc_stage;
+
+    pthread_mutex_lock(&context->lock);
+    nfc_statsRemove(&context->memStats[oldStage], oldSize);
+    nfc_statsRemove(&context->memTotal, oldSize);
+    nfc_statsAdd(&context->memStats[nfc_stage], size);
+    nfc_statsAdd(&context->memTotal, size);
+    context->memStats[nfc_stage].nbRealloc = context->memStats[nfc_stage].nbRealloc + 1;
+    context->memTotal.nbRealloc            = context->memTotal.nbRealloc + 1;
+    pthread_mutex_unlock(&context->lock);
+
+    return header + 1;
+}
+
+void nfc_free(void* ptr) {
+    //========== Variables declaration
+    nfc_context_t      context = nfc_contextGet(); // Context of the thread
+    nfc_blockHeader_t* header;                   // Header of the block
+
+    if (!ptr)
+        return;
+
+    header = (nfc_blockHeader_t*)ptr - 1;
+    pthread_mutex_lock(&context->lock);
+    nfc_statsRemove(&context->memStats[header->info.stage], header->info.size);
+    nfc_statsRemove(&context->memTotal, header->info.size);
+    context->memStats[header->info.stage].nbFree = context->memStats[header->info.stage].nbFree + 1;
+    context->memTotal.nbFree                     = context->memTotal.nbFree + 1;
+    pthread_mutex_unlock(&context->lock);
+
+    header->info.allocator.free(header->info.allocator.user, header);
+}
@@ -0,0 +1,556 @@
+/**
+ * @file cpu.c
+ * @author OUSSET Gaël
+ * @brief Runtime dispatch of the hot kernels on the features of the CPU
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * The generic tier runs the scalar bodies below, bit-exact with the scalar
+ * code. The AVX2 and AVX-512 tiers are written with the intrinsics of their
+ * width in cpu_vector.h, included once per tier with the target attribute of
+ * the tier. Their carrier runs every point through the vector sine, the last
+ * ones in a padded register, so that a point never depends on where a call
+ * starts (chunks of parallel_for()).
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "cpu.h"
+#include "context.h"
+#include "logging.h"
+#include "prng.h"
+#include <math.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define CPU_X86
+    #include <immintrin.h>
+#endif
+
+/**
+ * Number of points processed per block by the envelope and crossing kernels,
+ * small enough for the block to stay in the L1 cache
+ */
+#define CPU_BLOCK 512
+
+//----- Sine of the vector tiers, see cpu_sin_*() in cpu_vector.h
+#define CPU_SIN_SHIFT 6755399441055744.0         // 1.5*2^52, rounds to an integer
+#define CPU_SIN_2OPI  6.36619772367581382433e-01 // 2/pi
+#define CPU_SIN_PIO2A 1.5707855224609375e+00     // pi/2 in 17-bit parts, exact
+#define CPU_SIN_PIO2B 1.0804273188114166e-05     //   products with a quadrant
+#define CPU_SIN_PIO2C 6.0770943832721970e-11     //   below 2^36
+#define CPU_SIN_PIO2D 6.1232339957367660e-17     // Rest of pi/2
+#define CPU_SIN_S1    -1.66666666666666324348e-01
+#define CPU_SIN_S2    8.33333333332248946124e-03
+#define CPU_SIN_S3    -1.98412698298579493134e-04
+#define CPU_SIN_S4    2.75573137070700676789e-06
+#define CPU_SIN_S5    -2.50507602534068634195e-08
+#define CPU_SIN_S6    1.58969099521155010221e-10
+#define CPU_SIN_C1    4.16666666666666019037e-02
+#define CPU_SIN_C2    -1.38888888888741095749e-03
+#define CPU_SIN_C3    2.48015872894767294178e-05
+#define CPU_SIN_C4    -2.75573143513906633035e-07
+#define CPU_SIN_C5    2.08757232129817482790e-09
+#define CPU_SIN_C6    -1.13596475577881948265e-11
+
+#define CPU_INLINE static inline __attribute__((always_inline))
+
+// The vector kernels read and write the y of the points as every other double
+_Static_assert(
+    sizeof(point_t) == 2 * sizeof(double) && offsetof(point_t, y) == sizeof(double),
+    "point_t should be an int padded to a double, then a double"
+);
+
+/**
+ * @brief Average the full windows of n points of the envelope
+ * 
+ * @param levels Levels of the points, from transTime-1 points before the first one
+ * @param transTime Number of points of a window
+ * @param points First point
+ * @param n Number of points
+ */
+typedef void (*cpu_windows_t)(const double* levels, size_t transTime, point_t* points, size_t n);
+
+//========== Kernel bodies
+/**
+ * @brief Return the level of the symbol covering the point j of the envelope
+ * 
+ * @param env Parameters of the envelope
+ * @param j Index of the point
+ * @return double - Level of the symbol
+ */
+CPU_INLINE double cpu_envelopeLevel(const cpu_envelope_t* env, size_t j) {
+    //========== Variables declaration
+    int    x = (int)((unsigned long long)j * env->simDuration / env->numberOfPoints);
+    size_t symbol = (size_t)x / env->symbolDuration;
+
+    // Required to avoid overflow when having rounding errors
+    if (symbol >= env->nbSymbols)
+        symbol = env->nbSymbols - 1;
+    // Symbols are 0 or 1, no branch on their value
+    return env->levels[(int)env->symbols[symbol]];
+}
+
+/**
+ * @brief Average the levels of the window of the point i, without buffer.
+ *        Used for the first points, whose window is not full.
+ * 
+ * @param env Parameters of the envelope
+ * @param i Index of the point
+ * @return double - Level of the envelope
+ */
+CPU_INLINE double cpu_envelopePoint(const cpu_envelope_t* env, size_t i) {
+    //========== Variables declaration
+    double       y          = 0;                 // Sum of the levels of the window
+    unsigned int avgCounter = 0;                 // Number of points of the window
+
+    for (size_t j = i + 1 > env->transTime ? i + 1 - env->transTime : 0; j <= i && env->transTime; j=j+1) {
+        y          = y + cpu_envelopeLevel(env, j);
+        avgCounter = avgCounter + 1;
+    }
+
+    return y / (double)avgCounter;
+}
+
+/**
+ * @brief Average the full windows of n points, see cpu_windows_t. The
+ *        windows of a block are summed offset by offset so that the inner
+ *        loop runs over independent points. Each window is still summed in
+ *        the order of its points, as the scalar version.
+ * 
+ */
+CPU_INLINE void cpu_windowsBody(const double* levels, size_t transTime, point_t* points, size_t n) {
+    //========== Variables declaration
+    size_t end;                                  // Point after the last one of a block
+
+    for (size_t block = 0; block < n; block=block+CPU_BLOCK) {
+        end = block + CPU_BLOCK < n ? block + CPU_BLOCK : n;
+        for (size_t i = block; i < end; i=i+1)
+            points[i].y = 0;
+        for (size_t k = 0; k < transTime; k=k+1)
+            for (size_t i = block; i < end; i=i+1)
+                points[i].y = points[i].y + levels[i + k];
+        for (size_t i = block; i < end; i=i+1)
+            points[i].y = points[i].y / (double)transTime;
+    }
+}
+
+/**
+ * @brief Generate the points [first, last) of the envelope, see
+ *        cpu_kernels_t. The levels of the windows are computed once in a
+ *        buffer, then the full windows are averaged by the windows kernel of
+ *        the tier.
+ * 
+ * @param windows Average of the full windows of the tier
+ */
+CPU_INLINE void cpu_envelopeBody(const cpu_envelope_t* env, point_t* points, size_t first, size_t last, cpu_windows_t windows) {
+    //========== Variables declaration
+    size_t  transTime = env->transTime;          // Number of points of a window
+    size_t  start;                               // First point with a full window
+    double* levels;                              // Levels of the points [start-transTime+1, last)
+
+    for (size_t i = first; i < last; i=i+1)
+        points[i].x = (int)((unsigned long long)i * env->simDuration / env->numberOfPoints);
+
+    //========== Points whose window is not full
+    start = transTime && first + 1 < transTime ? transTime - 1 : first;
+    if (!transTime || start > last)
+        start = last;
+    for (size_t i = first; i < start; i=i+1)
+        points[i].y = cpu_envelopePoint(env, i);
+    if (start == last)
+        return;
+
+    //========== Points with a full window
+    levels = nfc_malloc((last - start + transTime - 1) * sizeof(*levels));
+    if (!levels) {
+        for (size_t i = start; i < last; i=i+1)
+            points[i].y = cpu_envelopePoint(env, i);
+        return;
+    }
+    for (size_t j = start + 1 - transTime; j < last; j=j+1)
+        levels[j - (start + 1 - transTime)] = cpu_envelopeLevel(env, j);
+    windows(levels, transTime, points + start, last - start);
+
+    nfc_free(levels);
+}
+
+/**
+ * @brief Multiply the points by the carrier, see cpu_kernels_t
+ * 
+ */
+CPU_INLINE void cpu_carrierBody(const point_t* in, point_t* out, size_t n, unsigned int carrierFreq) {
+    for (size_t i = 0; i < n; i=i+1) {
+        out[i].x = in[i].x;
+        out[i].y = in[i].y *
+                   sin(
+                       (double)2 *
+                       (double)M_PI *
+                       (double)carrierFreq *
+                       (double)(in[i].x) / (double)1e9
+                   );
+    }
+}
+
+/**
+ * @brief Add noise to the points, see cpu_kernels_t
+ * 
+ */
+CPU_INLINE void cpu_noiseBody(const point_t* in, point_t* out, size_t n, double noiseLevel, uint64_t seed, uint64_t counter) {
+    for (size_t i = 0; i < n; i=i+1) {
+        out[i].x = in[i].x;
+        out[i].y = in[i].y + noiseLevel * (prng_uniform(seed, counter + i) - 0.5);
+    }
+}
+
+/**
+ * @brief Compute the twiddle factors of a stage of the FFT, with the same
+ *        recurrence as the scalar version
+ * 
+ * @param twiddles Twiddle factors, half values
+ * @param half Half the size of the groups of the stage
+ */
+CPU_INLINE void cpu_twiddlesBody(complex double* twiddles, size_t half) {
+    //========== Variables declaration
+    complex double wlen = cexp(I * (-2.0 * M_PI / (double)(2 * half)));  // Twiddle factor of the stage
+
+    twiddles[0] = 1.0;
+    for (size_t k = 1; k < half; k=k+1)
+        twiddles[k] = twiddles[k-1] * wlen;
+}
+
+/**
+ * @brief Apply the butterflies of a stage of the FFT, once its twiddle
+ *        factors are computed, so that the butterflies of a group are
+ *        independent
+ * 
+ * @param x Real and imaginary parts of the n values
+ * @param w Real and imaginary parts of the twiddle factors of the stage
+ * @param n Number of values
+ * @param half Half the size of the groups of the stage
+ */
+CPU_INLINE void cpu_stageBody(double* x, const double* w, size_t n, size_t half) {
+    //========== Variables declaration
+    double tr;                                   // Real part of the odd value times the twiddle
+    double ti;                                   // Imaginary part of the odd value times the twiddle
+    double ur;                                   // Real part of the even value
+    double ui;                                   // Imaginary part of the even value
+
+    for (size_t i = 0; i < n; i=i+2*half) {
+        for (size_t k = 0; k < half; k=k+1) {
+            tr = w[2*k] * x[2*(i+k+half)]   - w[2*k+1] * x[2*(i+k+half)+1];
+            ti = w[2*k] * x[2*(i+k+half)+1] + w[2*k+1] * x[2*(i+k+half)];
+            ur = x[2*(i+k)];
+            ui = x[2*(i+k)+1];
+            x[2*(i+k)]          = ur + tr;
+            x[2*(i+k)+1]        = ui + ti;
+            x[2*(i+k+half)]     = ur - tr;
+            x[2*(i+k+half)+1]   = ui - ti;
+        }
+    }
+}
+
+/**
+ * @brief Write the magnitudes of X as the square root of their squared
+ *        norm, see cpu_kernels_t. Used by the vector tiers, the generic one
+ *        keeps cabs().
+ * 
+ */
+CPU_INLINE void cpu_magnitudeBody(const complex double* X, point_t* out, size_t n) {
+    const double* x = (const double*)X;          // Real and imaginary parts of X
+
+    for (size_t i = 0; i < n; i=i+1)
+        out[i].y = sqrt(x[2*i] * x[2*i] + x[2*i+1] * x[2*i+1]);
+}
+
+/**
+ * @brief Rank the points [first-1, last) among the sorted levels. The rank
+ *        of a point starts from the one of the previous point, so a point
+ *        only visits the levels between them.
+ * 
+ * @param points Points
+ * @param first First step, its first point is first-1
+ * @param last Step after the last one
+ * @param levels Sorted levels
+ * @param nbLevels Number of levels
+ * @param below Number of levels below each point
+ * @param upTo Number of levels below or equal to each point
+ */
+CPU_INLINE void cpu_ranksBody(const point_t* points, size_t first, size_t last, const double* levels, unsigned int nbLevels, int* below, int* upTo) {
+    //========== Variables declaration
+    size_t rank  = 0;                            // Number of levels below the point
+    size_t equal;                                // Number of levels below or equal to the point
+    size_t high  = nbLevels;                     // Bisection of the rank of the first point
+    size_t middle;                               // Middle of the bisection
+    double y     = points[first-1].y;            // Value of the point
+
+    while (rank < high) {
+        middle = rank + (high - rank) / 2;
+        if (levels[middle] < y)
+            rank = middle + 1;
+        else
+            high = middle;
+    }
+
+    for (size_t j = first - 1; j < last; j=j+1) {
+        y = points[j].y;
+        while (rank < nbLevels && levels[rank] < y)
+            rank = rank + 1;
+        while (rank > 0 && levels[rank-1] >= y)
+            rank = rank - 1;
+        for (equal = rank; equal < nbLevels && levels[equal] == y; equal=equal+1);
+        below[j - first + 1] = (int)rank;
+        upTo[j - first + 1]  = (int)equal;
+    }
+}
+
+/**
+ * @brief Write the steps crossing a level among n, from the ranks of their
+ *        points, and return how many there are. The step i, between the
+ *        points i and i+1 of the ranks, crosses a level when a point has
+ *        more levels below it than the other has below or equal to it.
+ * 
+ * @param below Number of levels below each point, n+1 values
+ * @param upTo Number of levels below or equal to each point, n+1 values
+ * @param first Index of the first step
+ * @param n Number of steps
+ * @param indices Indices of the crossing steps
+ * @return size_t - Number of crossing steps
+ */
+typedef size_t (*cpu_steps_t)(const int* below, const int* upTo, size_t first, size_t n, size_t* indices);
+
+/**
+ * @brief Find the crossing steps from the ranks of their points, see
+ *        cpu_steps_t. Branchless, the index is always written.
+ * 
+ */
+CPU_INLINE size_t cpu_stepsBody(const int* below, const int* upTo, size_t first, size_t n, size_t* indices) {
+    //========== Variables declaration
+    size_t count = 0;                            // Number of crossing steps
+
+    for (size_t i = 0; i < n; i=i+1) {
+        indices[count] = first + i;
+        count          = count + (size_t)((below[i+1] > upTo[i]) | (below[i] > upTo[i+1]));
+    }
+
+    return count;
+}
+
+/**
+ * @brief Find the steps crossing a level, see cpu_kernels_t. The points of
+ *        a block are ranked among the sorted levels, then the steps are
+ *        compared by the steps kernel of the tier, so a block costs its
+ *        points and the levels crossed rather than its points times the
+ *        levels.
+ * 
+ * @param steps Comparison of the ranks of the tier
+ */
+CPU_INLINE size_t cpu_crossingsBody(const point_t* points, size_t first, size_t last, const double* levels, unsigned int nbLevels, size_t* indices, cpu_steps_t steps) {
+    //========== Variables declaration
+    int    below[CPU_BLOCK + 1];                 // Number of levels below the points of the block
+    int    upTo[CPU_BLOCK + 1];                  // Number of levels below or equal to the points of the block
+    size_t end;                                  // Step after the last one of the block
+    size_t count = 0;                            // Number of crossing steps
+
+    for (size_t block = first; block < last; block=block+CPU_BLOCK) {
+        end = block + CPU_BLOCK < last ? block + CPU_BLOCK : last;
+        cpu_ranksBody(points, block, end, levels, nbLevels, below, upTo);
+        count = count + steps(below, upTo, block, end - block, indices + count);
+    }
+
+    return count;
+}
+
+//========== Generic tier
+/**
+ * @brief Windows kernel of the generic tier, see cpu_windows_t
+ * 
+ */
+static void cpu_envelopeWindows_GENERIC(const double* levels, size_t transTime, point_t* points, size_t n) {
+    cpu_windowsBody(levels, transTime, points, n);
+}
+
+/**
+ * @brief Envelope kernel of the generic tier, see cpu_kernels_t
+ * 
+ */
+static void cpu_envelope_GENERIC(const cpu_envelope_t* env, point_t* points, size_t first, size_t last) {
+    cpu_envelopeBody(env, points, first, last, cpu_envelopeWindows_GENERIC);
+}
+
+/**
+ * @brief Carrier kernel of the generic tier, see cpu_kernels_t
+ * 
+ */
+static void cpu_carrier_GENERIC(const point_t* in, point_t* out, size_t n, unsigned int carrierFreq) {
+    cpu_carrierBody(in, out, n, carrierFreq);
+}
+
+/**
+ * @brief Noise kernel of the generic tier, see cpu_kernels_t
+ * 
+ */
+static void cpu_noise_GENERIC(const point_t* in, point_t* out, size_t n, double noiseLevel, uint64_t seed, uint64_t counter) {
+    cpu_noiseBody(in, out, n, noiseLevel, seed, counter);
+}
+
+/**
+ * @brief Butterflies kernel of the generic tier, see cpu_kernels_t
+ * 
+ */
+static void cpu_butterflies_GENERIC(complex double* X, complex double* twiddles, size_t n) {
+    for (size_t half = 1; half < n; half=half<<1) {
+        cpu_twiddlesBody(twiddles, half);
+        cpu_stageBody((double*)X, (const double*)twiddles, n, half);
+    }
+}
+
+/**
+ * @brief Magnitude kernel of the generic tier, see cpu_kernels_t. Keeps
+ *        cabs() so that its results are those of the scalar version.
+ * 
+ */
+static void cpu_magnitude_GENERIC(const complex double* X, point_t* out, size_t n) {
+    for (size_t i = 0; i < n; i=i+1)
+        out[i].y = cabs(X[i]);
+}
+
+/**
+ * @brief Steps kernel of the generic tier, see cpu_steps_t
+ * 
+ */
+static size_t cpu_crossingsCompare_GENERIC(const int* below, const int* upTo, size_t first, size_t n, size_t* indices) {
+    return cpu_stepsBody(below, upTo, first, n, indices);
+}
+
+/**
+ * @brief Crossings kernel of the generic tier, see cpu_kernels_t
+ * 
+ */
+static size_t cpu_crossings_GENERIC(const point_t* points, size_t first, size_t last, const double* levels, unsigned int nbLevels, size_t* indices) {
+    return cpu_crossingsBody(points, first, last, levels, nbLevels, indices, cpu_crossingsCompare_GENERIC);
+}
+
+static const cpu_kernels_t cpu_kernels_GENERIC = {
+    cpu_envelope_GENERIC,
+    cpu_carrier_GENERIC,
+    cpu_noise_GENERIC,
+    cpu_butterflies_GENERIC,
+    cpu_magnitude_GENERIC,
+    cpu_crossings_GENERIC
+};
+
+//========== Vector tiers
+#define CPU_PASTE_(NAME, TIER) NAME##_##TIER
+#define CPU_PASTE(NAME, TIER)  CPU_PASTE_(NAME, TIER)
+
+#ifdef CPU_X86
+    #define CPU_TIER   AVX2
+    #define CPU_WIDTH  4
+    #define CPU_TARGET __attribute__((target("avx2,fma")))
+    #include "cpu_vector.h"
+    #undef CPU_TIER
+    #undef CPU_WIDTH
+    #undef CPU_TARGET
+
+    #define CPU_TIER   AVX512
+    #define CPU_WIDTH  8
+    #define CPU_TARGET __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma")))
+    #include "cpu_vector.h"
+    #undef CPU_TIER
+    #undef CPU_WIDTH
+    #undef CPU_TARGET
+#endif
+
+//----- Dispatch tables, indexed by cpu_tier_t
+static const cpu_kernels_t* cpu_tierKernels[] = {
+    [CPU_GENERIC] = &cpu_kernels_GENERIC,
+#ifdef CPU_X86
+    [CPU_AVX2]    = &cpu_kernels_AVX2,
+    [CPU_AVX512]  = &cpu_kernels_AVX512
+#else
+    [CPU_AVX2]    = &cpu_kernels_GENERIC,
+    [CPU_AVX512]  = &cpu_kernels_GENERIC
+#endif
+};
+static const char* cpu_tierNames[] = {
+    [CPU_GENERIC] = "generic",
+    [CPU_AVX2]    = "avx2",
+    [CPU_AVX512]  = "avx512"
+};
+
+//========== Detection
+static pthread_once_t       cpu_once      = PTHREAD_ONCE_INIT;
+static cpu_tier_t           cpu_supported = CPU_GENERIC;   // Best supported tier
+static cpu_tier_t           cpu_current   = CPU_GENERIC;   // Current tier
+static const cpu_kernels_t* cpu_bound     = &cpu_kernels_GENERIC;
+
+/**
+ * @brief Detect the features of the CPU and bind the kernels of the best
+ *        tier, or of the tier forced by NFCSIM_CPU
+ * 
+ */
+static void cpu_init(void) {
+    //========== Variables declaration
+    const char* forced = getenv("NFCSIM_CPU");   // Tier forced by the environment
+    cpu_tier_t  tier;                            // Tier to bind
+
+    //========== Detect the CPU
+#ifdef CPU_X86
+    // The checks include the support of the registers by the OS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+        cpu_supported = CPU_AVX512;
+    else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        cpu_supported = CPU_AVX2;
+#endif
+    tier = cpu_supported;
+
+    //========== Tier forced by the environment
+    if (forced && *forced) {
+        for (tier = CPU_GENERIC; tier < NB_CPU_TIERS && strcmp(forced, cpu_tierNames[tier]); tier=tier+1);
+        if (tier == NB_CPU_TIERS) {
+            PRINT(WARN, "Unknown CPU tier \"%s\" in NFCSIM_CPU, using %s", forced, cpu_tierNames[cpu_supported]);
+            tier = cpu_supported;
+        } else if (tier > cpu_supported) {
+            PRINT(WARN, "CPU tier %s is not supported, using %s", forced, cpu_tierNames[cpu_supported]);
+            tier = cpu_supported;
+        }
+    }
+
+    cpu_current = tier;
+    cpu_bound   = cpu_tierKernels[tier];
+    PRINT(INFO, "CPU kernels: %s (best supported: %s)", cpu_tierNames[tier], cpu_tierNames[cpu_supported]);
+}
+
+const cpu_kernels_t* cpu_kernels(void) {
+    pthread_once(&cpu_once, cpu_init);
+    return cpu_bound;
+}
+
+cpu_tier_t cpu_tier(void) {
+    pthread_once(&cpu_once, cpu_init);
+    return cpu_current;
+}
+
+cpu_tier_t cpu_supportedTier(void) {
+    pthread_once(&cpu_once, cpu_init);
+    return cpu_supported;
+}
+
+int cpu_setTier(cpu_tier_t tier) {
+    pthread_once(&cpu_once, cpu_init);
+    if (tier >= NB_CPU_TIERS || tier > cpu_supported)
+        return -1;
+
+    cpu_current = tier;
+    cpu_bound   = cpu_tierKernels[tier];
+    return 0;
+}
+
+const char* cpu_tierName(cpu_tier_t tier) {
+    return tier < NB_CPU_TIERS ? cpu_tierNames[tier] : "unknown";
+}
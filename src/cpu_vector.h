@@ -0,0 +1,472 @@
+/**
+ * @file cpu_vector.h
+ * @author OUSSET Gaël
+ * @brief Kernels of a vector tier, included by cpu.c once per tier
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * cpu.c defines CPU_TIER (suffix of the names), CPU_WIDTH (doubles per
+ * register, 4 for AVX2 and 8 for AVX-512) and CPU_TARGET (target attribute
+ * of the tier) before including this file. The kernels are written once with
+ * the macros below, which map to the intrinsics of the width, and end with
+ * the scalar bodies of cpu.c on the points left after the last full
+ * register. There is no include guard on purpose.
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#define CPU_NAME(NAME) CPU_PASTE(NAME, CPU_TIER)
+
+//========== Intrinsics of the width
+#if CPU_WIDTH == 4
+    #define VD                  __m256d
+    #define VI                  __m256i
+    #define VD_SET1(a)          _mm256_set1_pd(a)
+    #define VI_SET1(a)          _mm256_set1_epi64x((long long)(a))
+    #define VD_LOAD(p)          _mm256_loadu_pd(p)
+    #define VD_STORE(p, a)      _mm256_storeu_pd(p, a)
+    #define VD_STOREODD(p, a)   _mm256_maskstore_pd(p, _mm256_set_epi64x(-1, 0, -1, 0), a)
+    #define VD_ADD(a, b)        _mm256_add_pd(a, b)
+    #define VD_SUB(a, b)        _mm256_sub_pd(a, b)
+    #define VD_MUL(a, b)        _mm256_mul_pd(a, b)
+    #define VD_DIV(a, b)        _mm256_div_pd(a, b)
+    #define VD_SQRT(a)          _mm256_sqrt_pd(a)
+    #define VD_FMADD(a, b, c)   _mm256_fmadd_pd(a, b, c)
+    #define VD_FNMADD(a, b, c)  _mm256_fnmadd_pd(a, b, c)
+    #define VD_FMADDSUB(a, b, c) _mm256_fmaddsub_pd(a, b, c)
+    #define VD_DUPEVEN(a)       _mm256_movedup_pd(a)
+    #define VD_DUPODD(a)        _mm256_permute_pd(a, 0xF)
+    #define VD_SWAPPAIRS(a)     _mm256_permute_pd(a, 0x5)
+    #define VD_AS_VI(a)         _mm256_castpd_si256(a)
+    #define VI_AS_VD(a)         _mm256_castsi256_pd(a)
+    #define VI_ADD(a, b)        _mm256_add_epi64(a, b)
+    #define VI_SUB(a, b)        _mm256_sub_epi64(a, b)
+    #define VI_AND(a, b)        _mm256_and_si256(a, b)
+    #define VI_ANDNOT(a, b)     _mm256_andnot_si256(a, b)
+    #define VI_OR(a, b)         _mm256_or_si256(a, b)
+    #define VI_XOR(a, b)        _mm256_xor_si256(a, b)
+    #define VI_SRL(a, n)        _mm256_srli_epi64(a, n)
+    #define VI_SLL(a, n)        _mm256_slli_epi64(a, n)
+    #define VI32_LOAD(p)        _mm256_loadu_si256((const __m256i*)(p))
+    #define VI32_CROSSINGS(b, u) (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256( \
+                                     _mm256_cmpgt_epi32(VI32_LOAD((b) + 1), VI32_LOAD(u)),               \
+                                     _mm256_cmpgt_epi32(VI32_LOAD(b), VI32_LOAD((u) + 1))                \
+                                 )))
+
+// AVX2 has no 64-bit multiplication, the SplitMix64 hash built from 32-bit
+// products was slower than the scalar one, so the noise of the tier is scalar
+
+/**
+ * @brief Load the y of CPU_WIDTH points, the odd lanes of their registers
+ * 
+ * @param p First point
+ * @return VD - Values of the points
+ */
+CPU_INLINE CPU_TARGET VD CPU_NAME(cpu_loadY)(const point_t* p) {
+    //========== Variables declaration
+    VD a = _mm256_loadu_pd((const double*)p);       // Points 0 and 1
+    VD b = _mm256_loadu_pd((const double*)(p + 2)); // Points 2 and 3
+
+    // y0 y2 y1 y3, then in order
+    return _mm256_permute4x64_pd(_mm256_unpackhi_pd(a, b), 0xD8);
+}
+
+/**
+ * @brief Load the x of CPU_WIDTH points as doubles, the low 32 bits of the
+ *        even lanes of their registers
+ * 
+ * @param p First point
+ * @return VD - Times of the points
+ */
+CPU_INLINE CPU_TARGET VD CPU_NAME(cpu_loadX)(const point_t* p) {
+    //========== Variables declaration
+    VD a = _mm256_loadu_pd((const double*)p);       // Points 0 and 1
+    VD b = _mm256_loadu_pd((const double*)(p + 2)); // Points 2 and 3
+
+    // x0 x2 x1 x3 in the even 32-bit slots, then in order
+    return _mm256_cvtepi32_pd(_mm256_castsi256_si128(_mm256_permutevar8x32_epi32(
+        _mm256_castpd_si256(_mm256_unpacklo_pd(a, b)), _mm256_setr_epi32(0, 4, 2, 6, 0, 4, 2, 6)
+    )));
+}
+
+/**
+ * @brief Store CPU_WIDTH points with the x of in and the values y
+ * 
+ * @param in Points whose x are kept, can be out
+ * @param out Points written
+ * @param y Values of the points
+ */
+CPU_INLINE CPU_TARGET void CPU_NAME(cpu_storeY)(const point_t* in, point_t* out, VD y) {
+    //========== Variables declaration
+    VD a = _mm256_loadu_pd((const double*)in);       // Points 0 and 1
+    VD b = _mm256_loadu_pd((const double*)(in + 2)); // Points 2 and 3
+
+    _mm256_storeu_pd((double*)out,       _mm256_blend_pd(a, _mm256_permute4x64_pd(y, 0x50), 0xA));
+    _mm256_storeu_pd((double*)(out + 2), _mm256_blend_pd(b, _mm256_permute4x64_pd(y, 0xFA), 0xA));
+}
+#elif CPU_WIDTH == 8
+    #define VD                  __m512d
+    #define VI                  __m512i
+    #define VD_SET1(a)          _mm512_set1_pd(a)
+    #define VI_SET1(a)          _mm512_set1_epi64((long long)(a))
+    #define VI_IOTA()           _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0)
+    #define VD_LOAD(p)          _mm512_loadu_pd(p)
+    #define VD_STORE(p, a)      _mm512_storeu_pd(p, a)
+    #define VD_STOREODD(p, a)   _mm512_mask_storeu_pd(p, 0xAA, a)
+    #define VD_ADD(a, b)        _mm512_add_pd(a, b)
+    #define VD_SUB(a, b)        _mm512_sub_pd(a, b)
+    #define VD_MUL(a, b)        _mm512_mul_pd(a, b)
+    #define VD_DIV(a, b)        _mm512_div_pd(a, b)
+    #define VD_SQRT(a)          _mm512_sqrt_pd(a)
+    #define VD_FMADD(a, b, c)   _mm512_fmadd_pd(a, b, c)
+    #define VD_FNMADD(a, b, c)  _mm512_fnmadd_pd(a, b, c)
+    #define VD_FMADDSUB(a, b, c) _mm512_fmaddsub_pd(a, b, c)
+    #define VD_DUPEVEN(a)       _mm512_movedup_pd(a)
+    #define VD_DUPODD(a)        _mm512_permute_pd(a, 0xFF)
+    #define VD_SWAPPAIRS(a)     _mm512_permute_pd(a, 0x55)
+    #define VD_AS_VI(a)         _mm512_castpd_si512(a)
+    #define VI_AS_VD(a)         _mm512_castsi512_pd(a)
+    #define VI_ADD(a, b)        _mm512_add_epi64(a, b)
+    #define VI_SUB(a, b)        _mm512_sub_epi64(a, b)
+    #define VI_AND(a, b)        _mm512_and_si512(a, b)
+    #define VI_ANDNOT(a, b)     _mm512_andnot_si512(a, b)
+    #define VI_OR(a, b)         _mm512_or_si512(a, b)
+    #define VI_XOR(a, b)        _mm512_xor_si512(a, b)
+    #define VI_SRL(a, n)        _mm512_srli_epi64(a, n)
+    #define VI_SLL(a, n)        _mm512_slli_epi64(a, n)
+    #define VI32_LOAD(p)        _mm512_loadu_si512(p)
+    #define VI32_CROSSINGS(b, u) (unsigned int)(                                                     \
+                                     _mm512_cmpgt_epi32_mask(VI32_LOAD((b) + 1), VI32_LOAD(u)) |     \
+                                     _mm512_cmpgt_epi32_mask(VI32_LOAD(b), VI32_LOAD((u) + 1))       \
+                                 )
+    #define VI_MUL(a, b)        _mm512_mullo_epi64(a, b)
+    #define VI_TODOUBLE(a)      _mm512_cvtepu64_pd(a)
+
+/**
+ * @brief Load the y of CPU_WIDTH points, the odd lanes of their registers
+ * 
+ * @param p First point
+ * @return VD - Values of the points
+ */
+CPU_INLINE CPU_TARGET VD CPU_NAME(cpu_loadY)(const point_t* p) {
+    return _mm512_permutex2var_pd(
+        _mm512_loadu_pd((const double*)p), _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15),
+        _mm512_loadu_pd((const double*)(p + 4))
+    );
+}
+
+/**
+ * @brief Load the x of CPU_WIDTH points as doubles, the low 32 bits of the
+ *        even lanes of their registers
+ * 
+ * @param p First point
+ * @return VD - Times of the points
+ */
+CPU_INLINE CPU_TARGET VD CPU_NAME(cpu_loadX)(const point_t* p) {
+    return _mm512_cvtepi32_pd(_mm512_cvtepi64_epi32(_mm512_castpd_si512(_mm512_permutex2var_pd(
+        _mm512_loadu_pd((const double*)p), _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14),
+        _mm512_loadu_pd((const double*)(p + 4))
+    ))));
+}
+
+/**
+ * @brief Store CPU_WIDTH points with the x of in and the values y
+ * 
+ * @param in Points whose x are kept, can be out
+ * @param out Points written
+ * @param y Values of the points
+ */
+CPU_INLINE CPU_TARGET void CPU_NAME(cpu_storeY)(const point_t* in, point_t* out, VD y) {
+    //========== Variables declaration
+    VD a = _mm512_loadu_pd((const double*)in);       // Points 0 to 3
+    VD b = _mm512_loadu_pd((const double*)(in + 4)); // Points 4 to 7
+
+    _mm512_storeu_pd((double*)out,       _mm512_mask_blend_pd(0xAA, a, _mm512_permutexvar_pd(_mm512_setr_epi64(0, 0, 1, 1, 2, 2, 3, 3), y)));
+    _mm512_storeu_pd((double*)(out + 4), _mm512_mask_blend_pd(0xAA, b, _mm512_permutexvar_pd(_mm512_setr_epi64(4, 4, 5, 5, 6, 6, 7, 7), y)));
+}
+#else
+    #error "CPU_WIDTH should be 4 or 8"
+#endif
+
+//========== Sine
+/**
+ * @brief Sine of CPU_WIDTH phases, within an ulp or two of sin(). The phase
+ *        is reduced to [-pi/4, pi/4] by the nearest multiple of pi/2, split
+ *        in 17-bit parts whose products are exact up to 2^36 times pi/2
+ *        (1e11 rad, above the phase of any carrier at an int time in ns),
+ *        then the polynomials of fdlibm give the sine or the cosine of the
+ *        quadrant. The multiply-adds are fused explicitly, so the result of
+ *        a lane only depends on its phase.
+ * 
+ * @param phase Phases (rad)
+ * @return VD - Sines of the phases
+ */
+CPU_INLINE CPU_TARGET VD CPU_NAME(cpu_sin)(VD phase) {
+    //========== Variables declaration
+    VD shifted  = VD_FMADD(phase, VD_SET1(CPU_SIN_2OPI), VD_SET1(CPU_SIN_SHIFT)); // Nearest multiple of pi/2, plus 1.5*2^52
+    VD quadrant = VD_SUB(shifted, VD_SET1(CPU_SIN_SHIFT)); // Nearest multiple of pi/2
+    VI bits     = VD_AS_VI(shifted);             // Quadrant in the low bits of the mantissa
+    VD r;                                        // Reduced phase
+    VD z;                                        // Square of the reduced phase
+    VD s;                                        // Sine of the reduced phase
+    VD c;                                        // Cosine of the reduced phase
+    VD hz;                                       // Half of z
+    VD w;                                        // 1 - hz
+    VI odd;                                      // All ones in the odd quadrants
+
+    //========== Reduction
+    r = VD_FNMADD(quadrant, VD_SET1(CPU_SIN_PIO2A), phase);
+    r = VD_FNMADD(quadrant, VD_SET1(CPU_SIN_PIO2B), r);
+    r = VD_FNMADD(quadrant, VD_SET1(CPU_SIN_PIO2C), r);
+    r = VD_FNMADD(quadrant, VD_SET1(CPU_SIN_PIO2D), r);
+    z = VD_MUL(r, r);
+
+    //========== Sine and cosine of the reduced phase
+    s = VD_FMADD(z, VD_SET1(CPU_SIN_S6), VD_SET1(CPU_SIN_S5));
+    s = VD_FMADD(z, s, VD_SET1(CPU_SIN_S4));
+    s = VD_FMADD(z, s, VD_SET1(CPU_SIN_S3));
+    s = VD_FMADD(z, s, VD_SET1(CPU_SIN_S2));
+    s = VD_FMADD(z, s, VD_SET1(CPU_SIN_S1));
+    s = VD_FMADD(VD_MUL(z, r), s, r);
+
+    c  = VD_FMADD(z, VD_SET1(CPU_SIN_C6), VD_SET1(CPU_SIN_C5));
+    c  = VD_FMADD(z, c, VD_SET1(CPU_SIN_C4));
+    c  = VD_FMADD(z, c, VD_SET1(CPU_SIN_C3));
+    c  = VD_FMADD(z, c, VD_SET1(CPU_SIN_C2));
+    c  = VD_FMADD(z, c, VD_SET1(CPU_SIN_C1));
+    c  = VD_MUL(z, c);
+    hz = VD_MUL(z, VD_SET1(0.5));
+    w  = VD_SUB(VD_SET1(1.0), hz);
+    c  = VD_ADD(w, VD_FMADD(z, c, VD_SUB(VD_SUB(VD_SET1(1.0), w), hz)));
+
+    //========== Quadrant: sin, cos, -sin, -cos
+    odd = VI_SUB(VI_SET1(0), VI_AND(bits, VI_SET1(1)));
+    return VI_AS_VD(VI_XOR(
+        VI_OR(VI_ANDNOT(odd, VD_AS_VI(s)), VI_AND(odd, VD_AS_VI(c))),
+        VI_SLL(VI_AND(bits, VI_SET1(2)), 62)
+    ));
+}
+
+//========== Kernels
+/**
+ * @brief Average the full windows of n points, see cpu_windows_t. Each
+ *        register sums the windows of CPU_WIDTH points in the order of
+ *        their points, as the scalar version.
+ * 
+ */
+static CPU_TARGET void CPU_NAME(cpu_envelopeWindows)(const double* levels, size_t transTime, point_t* points, size_t n) {
+    //========== Variables declaration
+    VD     count = VD_SET1((double)transTime);   // Number of points of a window
+    VD     sum;                                  // Sums of the windows
+    size_t i;                                    // Index of the first point of a register
+
+    for (i = 0; i + CPU_WIDTH <= n; i=i+CPU_WIDTH) {
+        sum = VD_SET1(0);
+        for (size_t k = 0; k < transTime; k=k+1)
+            sum = VD_ADD(sum, VD_LOAD(levels + i + k));
+        CPU_NAME(cpu_storeY)(points + i, points + i, VD_DIV(sum, count));
+    }
+    cpu_windowsBody(levels + i, transTime, points + i, n - i);
+}
+
+/**
+ * @brief Generate the points [first, last) of the envelope, see
+ *        cpu_kernels_t
+ * 
+ */
+static CPU_TARGET void CPU_NAME(cpu_envelope)(const cpu_envelope_t* env, point_t* points, size_t first, size_t last) {
+    cpu_envelopeBody(env, points, first, last, CPU_NAME(cpu_envelopeWindows));
+}
+
+/**
+ * @brief Multiply the points by the carrier, see cpu_kernels_t. The phase
+ *        is computed as in the scalar version and the last points go
+ *        through a padded register, so every point gets cpu_sin().
+ * 
+ */
+static CPU_TARGET void CPU_NAME(cpu_carrier)(const point_t* in, point_t* out, size_t n, unsigned int carrierFreq) {
+    //========== Variables declaration
+    VD      pulsation = VD_SET1((double)2 * (double)M_PI * (double)carrierFreq);  // Pulsation of the carrier (rad/s)
+    VD      phase;                               // Phases of the points (rad)
+    point_t tail[CPU_WIDTH] = {{0, 0}};          // Last points, padded
+    size_t  i;                                   // Index of the first point of a register
+
+    for (i = 0; i + CPU_WIDTH <= n; i=i+CPU_WIDTH) {
+        phase = VD_DIV(VD_MUL(pulsation, CPU_NAME(cpu_loadX)(in + i)), VD_SET1(1e9));
+        CPU_NAME(cpu_storeY)(in + i, out + i, VD_MUL(CPU_NAME(cpu_loadY)(in + i), CPU_NAME(cpu_sin)(phase)));
+    }
+    if (i < n) {
+        memcpy(tail, in + i, (n - i) * sizeof(point_t));
+        phase = VD_DIV(VD_MUL(pulsation, CPU_NAME(cpu_loadX)(tail)), VD_SET1(1e9));
+        CPU_NAME(cpu_storeY)(tail, tail, VD_MUL(CPU_NAME(cpu_loadY)(tail), CPU_NAME(cpu_sin)(phase)));
+        memcpy(out + i, tail, (n - i) * sizeof(point_t));
+    }
+}
+
+/**
+ * @brief Add noise to the points, see cpu_kernels_t. With a 64-bit
+ *        multiplication, the SplitMix64 hash of prng_uniform() runs on the
+ *        counters of CPU_WIDTH points at once, so the noise is the same as
+ *        the scalar version.
+ * 
+ */
+static CPU_TARGET void CPU_NAME(cpu_noise)(const point_t* in, point_t* out, size_t n, double noiseLevel, uint64_t seed, uint64_t counter) {
+#ifdef VI_MUL
+    //========== Variables declaration
+    VI     z;                                    // Hashes of the counters
+    VD     u;                                    // Uniform draws in [0, 1)
+    size_t i;                                    // Index of the first point of a register
+
+    for (i = 0; i + CPU_WIDTH <= n; i=i+CPU_WIDTH) {
+        //----- SplitMix64 finalizer, see prng_hash()
+        z = VI_ADD(VI_SET1(counter + i + 1), VI_IOTA());
+        z = VI_ADD(VI_SET1(seed), VI_MUL(z, VI_SET1(0x9E3779B97F4A7C15ULL)));
+        z = VI_MUL(VI_XOR(z, VI_SRL(z, 30)), VI_SET1(0xBF58476D1CE4E5B9ULL));
+        z = VI_MUL(VI_XOR(z, VI_SRL(z, 27)), VI_SET1(0x94D049BB133111EBULL));
+        z = VI_XOR(z, VI_SRL(z, 31));
+
+        //----- 53 most significant bits, see prng_uniform()
+        u = VD_MUL(VI_TODOUBLE(VI_SRL(z, 11)), VD_SET1(1.0 / 9007199254740992.0));
+        CPU_NAME(cpu_storeY)(
+            in + i, out + i,
+            VD_ADD(CPU_NAME(cpu_loadY)(in + i), VD_MUL(VD_SET1(noiseLevel), VD_SUB(u, VD_SET1(0.5))))
+        );
+    }
+    cpu_noiseBody(in + i, out + i, n - i, noiseLevel, seed, counter + i);
+#else
+    cpu_noiseBody(in, out, n, noiseLevel, seed, counter);
+#endif
+}
+
+/**
+ * @brief Apply the butterflies of the FFT, see cpu_kernels_t. A register
+ *        holds CPU_WIDTH/2 complex values, the stages with smaller groups
+ *        are scalar.
+ * 
+ */
+static CPU_TARGET void CPU_NAME(cpu_butterflies)(complex double* X, complex double* twiddles, size_t n) {
+    //========== Variables declaration
+    double* x = (double*)X;                      // Real and imaginary parts of X
+    double* w = (double*)twiddles;               // Real and imaginary parts of the twiddles
+    VD      tw;                                  // Twiddle factors
+    VD      odd;                                 // Odd values
+    VD      even;                                // Even values
+    VD      t;                                   // Odd values times the twiddle factors
+
+    for (size_t half = 1; half < n; half=half<<1) {
+        cpu_twiddlesBody(twiddles, half);
+        if (half < CPU_WIDTH / 2) {
+            cpu_stageBody(x, w, n, half);
+            continue;
+        }
+
+        for (size_t i = 0; i < n; i=i+2*half) {
+            for (size_t k = 0; k < half; k=k+CPU_WIDTH/2) {
+                tw   = VD_LOAD(w + 2*k);
+                odd  = VD_LOAD(x + 2*(i+k+half));
+                even = VD_LOAD(x + 2*(i+k));
+                // (wr*or - wi*oi, wr*oi + wi*or)
+                t    = VD_FMADDSUB(VD_DUPEVEN(tw), odd, VD_MUL(VD_DUPODD(tw), VD_SWAPPAIRS(odd)));
+                VD_STORE(x + 2*(i+k),      VD_ADD(even, t));
+                VD_STORE(x + 2*(i+k+half), VD_SUB(even, t));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Write the magnitudes of X, see cpu_kernels_t. The squared norm of
+ *        each value is summed in both of its lanes, and the odd lanes, the y
+ *        of the points, are stored.
+ * 
+ */
+static CPU_TARGET void CPU_NAME(cpu_magnitude)(const complex double* X, point_t* out, size_t n) {
+    //========== Variables declaration
+    const double* x = (const double*)X;          // Real and imaginary parts of X
+    VD            v;                             // Values, then their magnitudes
+    size_t        i;                             // Index of the first value of a register
+
+    for (i = 0; i + CPU_WIDTH/2 <= n; i=i+CPU_WIDTH/2) {
+        v = VD_LOAD(x + 2*i);
+        v = VD_MUL(v, v);
+        v = VD_SQRT(VD_ADD(v, VD_SWAPPAIRS(v)));
+        VD_STOREODD((double*)(out + i), v);
+    }
+    cpu_magnitudeBody(X + i, out + i, n - i);
+}
+
+/**
+ * @brief Find the crossing steps from the ranks of their points, see
+ *        cpu_steps_t. The ranks of 2*CPU_WIDTH steps are compared at once,
+ *        and the bits of the crossing steps are written.
+ * 
+ */
+static CPU_TARGET size_t CPU_NAME(cpu_crossingsCompare)(const int* below, const int* upTo, size_t first, size_t n, size_t* indices) {
+    //========== Variables declaration
+    unsigned int mask;                           // Bits of the crossing steps of a register
+    size_t       count = 0;                      // Number of crossing steps
+    size_t       i;                              // Index of the first step of a register
+
+    for (i = 0; i + 2*CPU_WIDTH <= n; i=i+2*CPU_WIDTH) {
+        for (mask = VI32_CROSSINGS(below + i, upTo + i); mask; mask=mask&(mask-1)) {
+            indices[count] = first + i + (size_t)__builtin_ctz(mask);
+            count          = count + 1;
+        }
+    }
+
+    return count + cpu_stepsBody(below + i, upTo + i, first + i, n - i, indices + count);
+}
+
+/**
+ * @brief Find the steps crossing a level, see cpu_kernels_t
+ * 
+ */
+static CPU_TARGET size_t CPU_NAME(cpu_crossings)(const point_t* points, size_t first, size_t last, const double* levels, unsigned int nbLevels, size_t* indices) {
+    return cpu_crossingsBody(points, first, last, levels, nbLevels, indices, CPU_NAME(cpu_crossingsCompare));
+}
+
+static const cpu_kernels_t CPU_NAME(cpu_kernels) = {
+    CPU_NAME(cpu_envelope),
+    CPU_NAME(cpu_carrier),
+    CPU_NAME(cpu_noise),
+    CPU_NAME(cpu_butterflies),
+    CPU_NAME(cpu_magnitude),
+    CPU_NAME(cpu_crossings)
+};
+
+//========== Clean up for the next tier
+#undef CPU_NAME
+#undef VD
+#undef VI
+#undef VD_SET1
+#undef VI_SET1
+#undef VI_IOTA
+#undef VD_LOAD
+#undef VD_STORE
+#undef VD_STOREODD
+#undef VD_ADD
+#undef VD_SUB
+#undef VD_MUL
+#undef VD_DIV
+#undef VD_SQRT
+#undef VD_FMADD
+#undef VD_FNMADD
+#undef VD_FMADDSUB
+#undef VD_DUPEVEN
+#undef VD_DUPODD
+#undef VD_SWAPPAIRS
+#undef VD_AS_VI
+#undef VI_AS_VD
+#undef VI_ADD
+#undef VI_SUB
+#undef VI_AND
+#undef VI_ANDNOT
+#undef VI_OR
+#undef VI_XOR
+#undef VI_SRL
+#undef VI_SLL
+#undef VI32_LOAD
+#undef VI32_CROSSINGS
+#undef VI_MUL
+#undef VI_TODOUBLE
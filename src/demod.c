@@ -12,8 +12,229 @@
 #include "demod.h"
 #include "logging.h"
 #include "assert.h"
-#include "list.h"
+#include "context.h"
+#include "cpu.h"
+#include "parallel.h"
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Number of levels up to which the crossed levels are found by comparing
+ * them all, a bisection is used above
+ */
+#define LCADC_LINEAR_LEVELS 16
+
+/**
+ * Number of steps searched for crossings at once
+ */
+#define LCADC_BLOCK 512
+
+/**
+ * Number of points of the blocks of LCADC_batch(), read once per thread for
+ * all its configurations
+ */
+#define LCADC_BATCH_BLOCK 2048
+
+/**
+ * Number of timings of the chips tried by demod_frame(), spread over one
+ * chip
+ */
+#define DEMOD_TIMING_STEPS 16
+
+/**
+ * Number of samples allocated first, doubled when full
+ */
+#define LCADC_MIN_CAPACITY 1024
+
+/**
+ * @brief Compare two levels, for qsort()
+ * 
+ * @param a First level
+ * @param b Second level
+ * @return int - Negative, 0 or positive if a is below, equal or above b
+ */
+static int LCADC_compareLevels(const void* a, const void* b) {
+    return (*(const double*)a > *(const double*)b) - (*(const double*)a < *(const double*)b);
+}
+
+/**
+ * @brief Count the sorted levels below a value
+ * 
+ * @param levels Sorted levels
+ * @param nbLevels Number of levels
+ * @param value Value to compare the levels to
+ * @param orEqual 1 to also count the levels equal to the value
+ * @return size_t - Number of levels below (or equal to) the value
+ */
+static size_t LCADC_rank(const double* levels, unsigned int nbLevels, double value, int orEqual) {
+    //========== Variables declaration
+    size_t count = 0;                            // Number of levels below the value
+    size_t low   = 0;                            // First candidate of the bisection
+    size_t high  = nbLevels;                     // Candidate after the last one
+    size_t middle;                               // Middle of the candidates
+
+    //========== Few levels, compare them all without branch
+    if (nbLevels <= LCADC_LINEAR_LEVELS) {
+        for (unsigned int l = 0; l < nbLevels; l=l+1)
+            count = count + (size_t)(levels[l] < value || (orEqual && levels[l] == value));
+        return count;
+    }
+
+    //========== Many levels, bisection
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (levels[middle] < value || (orEqual && levels[middle] == value))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+/**
+ * @brief Start a step of the stream: find the levels it crosses
+ * 
+ * @param stream Stream
+ * @param a First point of the step
+ * @param b Second point of the step
+ */
+static void LCADC_beginStep(LCADC_stream_t stream, point_t a, point_t b) {
+    stream->a     = a;
+    stream->b     = b;
+    stream->first = LCADC_rank(stream->levels, stream->nbLevels, fmin(a.y, b.y), 1);
+    stream->last  = LCADC_rank(stream->levels, stream->nbLevels, fmax(a.y, b.y), 0);
+    stream->next  = stream->first;
+}
+
+/**
+ * @brief Emit the samples of the current step, one per crossed level in the
+ *        order they are crossed, at the time interpolated between its points
+ * 
+ * @param stream Stream
+ * @param samples Buffer of samples
+ * @param maxSamples Room left in the buffer
+ * @return size_t - Number of samples written, the step is over if stream->next reached stream->last
+ */
+static size_t LCADC_emitStep(LCADC_stream_t stream, point_t* samples, size_t maxSamples) {
+    //========== Variables declaration
+    point_t a       = stream->a;                 // First point of the step
+    point_t b       = stream->b;                 // Second point of the step
+    size_t  written = 0;                         // Number of samples written
+    size_t  level;                               // Index of the crossed level
+
+    for (; stream->next < stream->last; stream->next=stream->next+1) {
+        if (stream->skpCnt) {
+            stream->skpCnt = stream->skpCnt - 1;
+            continue;
+        }
+        if (written == maxSamples)
+            break;
+        stream->skpCnt = stream->skip;
+
+        level = b.y > a.y ? stream->next : stream->first + stream->last - 1 - stream->next;
+        samples[written].x = a.x + (int)lround(
+            (stream->levels[level] - a.y) / (b.y - a.y) * (double)(b.x - a.x)
+        );
+        samples[written].y = stream->levels[level];
+        written = written + 1;
+    }
+
+    return written;
+}
+
+int LCADC_streamCreate(double* levels, unsigned int nbLevels, unsigned int skip, LCADC_stream_t* stream) {
+    //========== Check arguments
+    assert(levels || !nbLevels, "Levels cannot be NULL if nbLevels is not null", -1);
+
+    //========== Allocate the stream
+    *stream = nfc_calloc(1, sizeof(**stream));
+    assert(*stream, "Failed to allocate memory for the LCADC stream", -1);
+
+    (*stream)->levels = nfc_malloc((nbLevels ? nbLevels : 1) * sizeof(*levels));
+    if (!(*stream)->levels) {
+        PRINT(ERR, "Failed to allocate memory for the levels");
+        nfc_free(*stream);
+        return -1;
+    }
+
+    //========== Sort the levels
+    if (nbLevels)
+        memcpy((*stream)->levels, levels, nbLevels * sizeof(*levels));
+    qsort((*stream)->levels, nbLevels, sizeof(*levels), LCADC_compareLevels);
+    (*stream)->nbLevels = nbLevels;
+    (*stream)->skip     = skip;
+
+    return 0;
+}
+
+void LCADC_streamDestroy(LCADC_stream_t stream) {
+    nfc_free(stream->levels);
+    nfc_free(stream);
+}
+
+int LCADC_streamPush(
+    LCADC_stream_t stream,
+    const point_t* points,
+    size_t nbPoints,
+    point_t* samples,
+    size_t maxSamples,
+    size_t* nbSamples,
+    size_t* nbConsumed
+) {
+    //========== Variable declaration
+    const cpu_kernels_t* kernels = cpu_kernels();  // Kernels of the CPU
+    size_t steps[LCADC_BLOCK];                   // Steps of a block crossing a level
+    size_t nbSteps;                              // Number of steps crossing a level
+    size_t last;                                 // Point after the last one of a block
+    size_t i;                                    // Index of the second point of a step
+
+    //========== Check arguments
+    assert(stream, "Stream cannot be NULL", -1);
+    assert(points || !nbPoints, "Points cannot be NULL if nbPoints is not null", -1);
+    assert(samples || !maxSamples, "Samples cannot be NULL if maxSamples is not null", -1);
+
+    *nbSamples  = 0;
+    *nbConsumed = 0;
+
+    //========== Finish the step interrupted by a full buffer
+    *nbSamples = LCADC_emitStep(stream, samples, maxSamples);
+    if (stream->next < stream->last || !nbPoints)
+        return 0;
+
+    //========== Step between the last point received and the first new one
+    if (stream->hasPrevious) {
+        LCADC_beginStep(stream, stream->previous, points[0]);
+        *nbSamples = *nbSamples + LCADC_emitStep(stream, samples + *nbSamples, maxSamples - *nbSamples);
+    }
+    stream->previous    = points[0];
+    stream->hasPrevious = 1;
+    *nbConsumed         = 1;
+    if (stream->next < stream->last)
+        return 0;
+
+    //========== Steps of the new points
+    // Only the steps crossing a level are visited
+    for (size_t block = 1; block < nbPoints; block=block+LCADC_BLOCK) {
+        last    = block + LCADC_BLOCK < nbPoints ? block + LCADC_BLOCK : nbPoints;
+        nbSteps = kernels->crossings(points, block, last, stream->levels, stream->nbLevels, steps);
+        for (size_t s = 0; s < nbSteps; s=s+1) {
+            i = steps[s];
+            LCADC_beginStep(stream, points[i-1], points[i]);
+            *nbSamples = *nbSamples + LCADC_emitStep(stream, samples + *nbSamples, maxSamples - *nbSamples);
+            if (stream->next < stream->last) {
+                // The buffer is full, the step resumes on the next call
+                stream->previous = points[i];
+                *nbConsumed      = i + 1;
+                return 0;
+            }
+        }
+    }
+    stream->previous = points[nbPoints-1];
+    *nbConsumed      = nbPoints;
+
+    return 0;
+}
 
 int LCADC(
     scatter_t signal,
@@ -22,11 +243,17 @@ int LCADC(
     unsigned int skip,
     scatter_t* output
 ) {
+    PROFILE_STAGE(PROF_LCADC);
+
     //========== Variable declaration
-    list_t samples;                              // Temporary list of samples
-    point_t* point;                              // Temporary point
-    size_t i;                                    // Index for the output signal
-    unsigned int skpCnt;                         // Counter for the skip
+    LCADC_stream_t stream;                       // Stream fed with the whole signal
+    point_t* samples;                            // Samples
+    point_t* grown;                              // Samples after a reallocation
+    size_t   nbSamples = 0;                      // Number of samples
+    size_t   capacity  = LCADC_MIN_CAPACITY;     // Number of allocated samples
+    size_t   written;                            // Number of samples written by a push
+    size_t   consumed  = 0;                      // Number of points consumed
+    size_t   pushed;                             // Number of points consumed by a push
 
     //========== Check arguments
     assert(signal, "Signal cannot be NULL", -1);
@@ -36,46 +263,489 @@ int LCADC(
     assert(levels || !nbLevels, "Levels cannot be NULL if nbLevels is not null", -1);
     if (!nbLevels) {
         PRINT(WARN, "No levels provided");
-        scatter_create(output, 0);
-        assert(output, "Failed to allocate memory for the output", -1);
+        assert(!scatter_create(output, 0), "Failed to allocate memory for the output", -1);
         return 0;
     }
 
     //========== Initialize variables
-    samples = list_new();
-    skpCnt = 0;
-
-    //========== Sample the signal
-    for (i = 1; i < signal->size; i=i+1) {
-        for (size_t j = 0; j < nbLevels; j=j+1) {
-            if ((scatter_getY(signal, i-1)-levels[j]) *
-                (scatter_getY(signal, i)-levels[j]) < 0
-            ) {
-                if (!skpCnt) {
-                    skpCnt = skip;
-                    if(point_create(&point, scatter_getX(signal, i), levels[j])) {
-                        PRINT(ERR, "Failed to create a point");
-                        list_delete(samples, point_destroy);
-                        return -1;
-                    }
-                    samples = list_add_last(samples, point);
+    if (LCADC_streamCreate(levels, nbLevels, skip, &stream))
+        return -1;
+    samples = nfc_malloc(capacity * sizeof(*samples));
+    if (!samples) {
+        PRINT(ERR, "Failed to allocate memory for the samples");
+        LCADC_streamDestroy(stream);
+        return -1;
+    }
+
+    //========== Sample the signal, growing the samples when full
+    for (;;) {
+        LCADC_streamPush(
+            stream,
+            signal->points + consumed, signal->size - consumed,
+            samples + nbSamples, capacity - nbSamples,
+            &written, &pushed
+        );
+        nbSamples = nbSamples + written;
+        consumed  = consumed + pushed;
+        if (consumed == signal->size && stream->next == stream->last)
+            break;
+
+        grown = nfc_realloc(samples, 2 * capacity * sizeof(*samples));
+        if (!grown) {
+            PRINT(ERR, "Failed to allocate memory for the samples");
+            nfc_free(samples);
+            LCADC_streamDestroy(stream);
+            return -1;
+        }
+        samples  = grown;
+        capacity = 2 * capacity;
+    }
+    LCADC_streamDestroy(stream);
+
+    //========== Create the output
+    if (scatter_createFrom(output, samples, nbSamples)) {
+        nfc_free(samples);
+        return -1;
+    }
+    PROFILE_COUNT(signal->size, signal->size * sizeof(point_t));
+
+    return 0;
+}
+
+/**
+ * @brief Arguments shared by the chunks of configurations of LCADC_batch()
+ * 
+ */
+typedef struct {
+    scatter_t       signal;                      // Input signal
+    LCADC_config_t* configs;                     // Configurations
+    int             keepSamples;                 // 1 to keep the samples
+    LCADC_result_t* results;                     // Samples and metrics of the configurations
+    int             status;                      // -1 if a chunk failed
+} LCADC_batchTask_t;
+
+/**
+ * @brief Run the configurations [first, last) of LCADC_batch(). The
+ *        squared error of a hold is computed from prefix sums of the block,
+ *        so only the crossing steps are visited for each configuration.
+ *        The samples kept are grown in place and handed to the results.
+ * 
+ * @param arg Arguments of the batch (LCADC_batchTask_t)
+ * @param first First configuration
+ * @param last Configuration after the last one
+ */
+static void LCADC_batchChunk(void* arg, size_t first, size_t last) {
+    //========== Variable declaration
+    LCADC_batchTask_t*   task    = (LCADC_batchTask_t*)arg;
+    const cpu_kernels_t* kernels = cpu_kernels();  // Kernels of the CPU
+    point_t*        points = task->signal->points; // Points of the signal
+    size_t          size   = task->signal->size; // Number of points
+    size_t          nb     = last - first;       // Number of configurations
+    LCADC_stream_t* streams;                     // State of each configuration
+    double*         holds;                       // Level held by each configuration
+    double*         squares;                     // Squared error of each configuration
+    size_t*         capacities;                  // Allocated samples of each configuration
+    point_t**       samples;                     // Samples kept of each configuration
+    double*         sums;                        // Prefix sums of y, then of y^2, of the block
+    size_t*         steps;                       // Steps of the block crossing a level
+    point_t         buffer[LCADC_BLOCK];         // Samples not kept
+    point_t*        grown;                       // Samples after a reallocation
+    size_t          nbSteps;                     // Number of steps crossing a level
+    size_t          end;                         // Point after the last one of the block
+    size_t          segment;                     // First point of the current hold
+    size_t          written;                     // Samples written for a step
+    size_t          room;                        // Room left for the samples of a configuration
+    point_t*        out;                         // Where the samples of a step are written
+    size_t          c;                           // Index of the configuration
+    size_t          i;                           // Index of the second point of a step
+
+    //========== Allocate memory
+    streams    = nfc_calloc(nb, sizeof(*streams));
+    holds      = nfc_calloc(nb, sizeof(*holds));
+    squares    = nfc_calloc(nb, sizeof(*squares));
+    capacities = nfc_calloc(nb, sizeof(*capacities));
+    samples    = nfc_calloc(nb, sizeof(*samples));
+    sums       = nfc_malloc(2 * (LCADC_BATCH_BLOCK + 1) * sizeof(*sums));
+    steps      = nfc_malloc(LCADC_BATCH_BLOCK * sizeof(*steps));
+    if (!streams || !holds || !squares || !capacities || !samples || !sums || !steps)
+        goto fail;
+    for (c = 0; c < nb; c=c+1) {
+        if (LCADC_streamCreate(task->configs[first+c].levels, task->configs[first+c].nbLevels, task->configs[first+c].skip, &streams[c]))
+            goto fail;
+        if (task->keepSamples) {
+            capacities[c] = LCADC_MIN_CAPACITY;
+            samples[c]    = nfc_malloc(capacities[c] * sizeof(point_t));
+            if (!samples[c])
+                goto fail;
+        }
+    }
+
+    //========== Run every configuration on each block of the signal
+    for (size_t block = 0; block < size; block=block+LCADC_BATCH_BLOCK) {
+        end = block + LCADC_BATCH_BLOCK < size ? block + LCADC_BATCH_BLOCK : size;
+
+        //----- Prefix sums of the block, shared by the configurations
+        sums[0]                         = 0;
+        sums[LCADC_BATCH_BLOCK + 1]     = 0;
+        for (size_t j = block; j < end; j=j+1) {
+            sums[j - block + 1]                     = sums[j - block] + points[j].y;
+            sums[LCADC_BATCH_BLOCK + 1 + j - block + 1] = sums[LCADC_BATCH_BLOCK + 1 + j - block] + points[j].y * points[j].y;
+        }
+
+        for (c = 0; c < nb; c=c+1) {
+            nbSteps = kernels->crossings(
+                points, block ? block : 1, end,
+                streams[c]->levels, streams[c]->nbLevels, steps
+            );
+            segment = block;
+            for (size_t s = 0; s <= nbSteps; s=s+1) {
+                i = s < nbSteps ? steps[s] : end;
+
+                //----- Squared error of the hold over [segment, i)
+                squares[c] = squares[c] +
+                    (sums[LCADC_BATCH_BLOCK + 1 + i - block] - sums[LCADC_BATCH_BLOCK + 1 + segment - block]) -
+                    2 * holds[c] * (sums[i - block] - sums[segment - block]) +
+                    (double)(i - segment) * holds[c] * holds[c];
+                segment = i;
+                if (s == nbSteps)
                     break;
-                } else
-                    skpCnt = skpCnt - 1;
+
+                //----- Samples of the step
+                LCADC_beginStep(streams[c], points[i-1], points[i]);
+                while (streams[c]->next < streams[c]->last) {
+                    if (task->keepSamples) {
+                        if (task->results[first+c].nbSamples == capacities[c]) {
+                            grown = nfc_realloc(samples[c], 2 * capacities[c] * sizeof(point_t));
+                            if (!grown)
+                                goto fail;
+                            samples[c]    = grown;
+                            capacities[c] = 2 * capacities[c];
+                        }
+                        out  = samples[c] + task->results[first+c].nbSamples;
+                        room = capacities[c] - task->results[first+c].nbSamples;
+                    } else {
+                        out  = buffer;
+                        room = LCADC_BLOCK;
+                    }
+                    written = LCADC_emitStep(streams[c], out, room);
+                    if (written)
+                        holds[c] = out[written-1].y;
+                    task->results[first+c].nbSamples = task->results[first+c].nbSamples + written;
+                }
             }
         }
     }
 
-    //========== Create the output
-    scatter_create(output, list_length(samples));
-    assert(output, "Failed to allocate memory for the output", -1);
-    i = 0;
-    for (; !list_empty(samples); samples = list_del_first(samples, point_destroy)) {
-        point = (point_t*)list_first(samples);
-        scatter_setX(*output, i, point->x);
-        scatter_setY(*output, i, point->y);
-        i = i + 1;
+    //========== Hand the samples to the results
+    for (c = 0; c < nb; c=c+1) {
+        task->results[first+c].rmsError = sqrt(fmax(squares[c], 0) / (double)size);
+        if (task->keepSamples) {
+            if (scatter_createFrom(&task->results[first+c].samples, samples[c], task->results[first+c].nbSamples))
+                goto fail;
+            samples[c] = NULL;
+        }
+    }
+    goto end;
+
+fail:
+    task->status = -1;
+end:
+    for (c = 0; streams && c < nb; c=c+1)
+        if (streams[c])
+            LCADC_streamDestroy(streams[c]);
+    for (c = 0; samples && c < nb; c=c+1)
+        nfc_free(samples[c]);
+    nfc_free(streams);
+    nfc_free(holds);
+    nfc_free(squares);
+    nfc_free(capacities);
+    nfc_free(samples);
+    nfc_free(sums);
+    nfc_free(steps);
+}
+
+int LCADC_batch(scatter_t signal, LCADC_config_t* configs, size_t nbConfigs, int keepSamples, LCADC_result_t* results) {
+    PROFILE_STAGE(PROF_LCADC);
+
+    //========== Variable declaration
+    LCADC_batchTask_t task;                      // Arguments of the chunks
+    int               status = 0;                // Status of the batch
+
+    //========== Check arguments
+    assert(signal, "Signal cannot be NULL", -1);
+    assert(signal->points, "Signal cannot be NULL", -1);
+    assert(signal->size, "Signal size cannot be null", -1);
+    assert(configs || !nbConfigs, "Configurations cannot be NULL if nbConfigs is not null", -1);
+    assert(results || !nbConfigs, "Results cannot be NULL if nbConfigs is not null", -1);
+    for (size_t c = 0; c < nbConfigs; c=c+1)
+        assert(
+            configs[c].levels || !configs[c].nbLevels,
+            "Levels of configuration %zu cannot be NULL if nbLevels is not null",
+            -1, c
+        );
+
+    //========== Run the configurations
+    memset(results, 0, nbConfigs * sizeof(*results));
+    task.signal      = signal;
+    task.configs     = configs;
+    task.keepSamples = keepSamples;
+    task.results     = results;
+    task.status      = 0;
+    if (parallel_for(nbConfigs, 1, LCADC_batchChunk, &task) || task.status) {
+        PRINT(ERR, "Failed to simulate the LCADC configurations");
+        status = -1;
+    }
+
+    //========== Destroy the samples of all the configurations on failure
+    for (size_t c = 0; c < nbConfigs && status; c=c+1) {
+        if (results[c].samples) {
+            scatter_destroy(results[c].samples);
+            results[c].samples = NULL;
+        }
+    }
+    PROFILE_COUNT(signal->size * nbConfigs, signal->size * sizeof(point_t));
+
+    return status;
+}
+
+int demod_create(nfc_sigParam_t* sigParam, size_t maxPoints, demod_t* demod) {
+    //========== Check arguments
+    assert(sigParam, "Signal parameters cannot be NULL", -1);
+    assert(!nfc_checkParam(sigParam), "Invalid signal parameters", -1);
+    assert(maxPoints, "Maximum number of points cannot be null", -1);
+    assert(nfc_symbolDuration(sigParam), "Chips shorter than 1 ns", -1);
+
+    //========== Allocate the receiver
+    *demod = nfc_calloc(1, sizeof(**demod));
+    assert(*demod, "Failed to allocate memory for the receiver", -1);
+
+    (*demod)->param        = *sigParam;
+    (*demod)->param.data   = NULL;
+    (*demod)->maxPoints    = maxPoints;
+    (*demod)->nbChips      = nfc_subModulatedSize(sigParam);
+    (*demod)->chipDuration = nfc_symbolDuration(sigParam);
+    (*demod)->projection   = nfc_malloc((maxPoints + 1) * sizeof(double));
+    (*demod)->energy       = nfc_malloc((maxPoints + 1) * sizeof(double));
+    (*demod)->chips        = nfc_malloc((*demod)->nbChips * sizeof(double));
+    (*demod)->weights      = nfc_malloc((*demod)->nbChips * sizeof(double));
+    if (!(*demod)->projection || !(*demod)->energy || !(*demod)->chips || !(*demod)->weights) {
+        PRINT(ERR, "Failed to allocate memory for the receiver");
+        demod_destroy(*demod);
+        return -1;
+    }
+
+    return 0;
+}
+
+void demod_destroy(demod_t demod) {
+    nfc_free(demod->projection);
+    nfc_free(demod->energy);
+    nfc_free(demod->chips);
+    nfc_free(demod->weights);
+    nfc_free(demod);
+}
+
+/**
+ * @brief Compute the amplitude of the envelope and the energy of the
+ *        carrier on each chip, for chips starting at timing. The amplitude
+ *        is the least squares fit of the carrier on the points of the chip.
+ * 
+ * @param demod Receiver, projection and energy hold the prefix sums of the frame
+ * @param signal Frame
+ * @param timing Start of the first chip (ns)
+ * @return double - Weighted distance of the chips to their mean, larger when the eye is open
+ */
+static double demod_chips(demod_t demod, scatter_t signal, int timing) {
+    //========== Variables declaration
+    size_t    start  = 0;                        // First point of the chip
+    size_t    end    = 0;                        // Point after the last one of the chip
+    long long bound  = timing;                   // End of the chip (ns)
+    double    sum    = 0;                        // Sum of the projections
+    double    total  = 0;                        // Sum of the energies
+    double    spread = 0;                        // Weighted distance to the mean
+
+    //========== Integrate over each chip
+    while (end < signal->size && signal->points[end].x < bound)
+        end = end + 1;
+    for (size_t k = 0; k < demod->nbChips; k=k+1) {
+        start = end;
+        bound = bound + demod->chipDuration;
+        while (end < signal->size && signal->points[end].x < bound)
+            end = end + 1;
+        demod->weights[k] = demod->energy[end] - demod->energy[start];
+        demod->chips[k]   = demod->weights[k] > 0 ?
+            (demod->projection[end] - demod->projection[start]) / demod->weights[k] : 0;
+        sum   = sum + demod->projection[end] - demod->projection[start];
+        total = total + demod->weights[k];
+    }
+
+    //========== Opening of the eye
+    for (size_t k = 0; k < demod->nbChips && total > 0; k=k+1)
+        spread = spread + demod->weights[k] * fabs(demod->chips[k] - sum / total);
+    return spread;
+}
+
+int demod_frame(demod_t demod, scatter_t signal, char* data) {
+    PROFILE_STAGE(PROF_DEMOD);
+
+    //========== Variables declaration
+    nfc_sigParam_t* param    = NULL;             // Parameters of the frames
+    size_t          nbBits;                      // Number of bits of a frame
+    double          turns;                       // Phase of the carrier at a point (turns)
+    double          gram[3]  = {0, 0, 0};        // Sums of sin^2, sin*cos and cos^2 of the carrier
+    double          proj[2]  = {0, 0};           // Sums of the signal times sin and cos
+    double          det;                         // Determinant of the Gram matrix
+    double          a;                           // Weight of the sin in the carrier
+    double          b;                           // Weight of the cos in the carrier
+    double          norm;                        // Norm of (a, b)
+    double          carrier;                     // Carrier at a point
+    size_t          perQuarter[2];               // Chips of the current quarter, from the first one
+    double          spread;                      // Opening of the eye for a timing
+    double          best     = -1;               // Best opening of the eye
+    int             timing;                      // Timing tried
+    double          levels[2][2] = {{0, 0}, {0, 0}}; // Weighted sums and weights of the chips below and above the mean
+    double          mean;                        // Threshold between the levels
+    double          soft[4];                     // Soft value of the quarters of a bit, positive for 1
+    double          bit;                         // Soft value of a bit, positive for 1
+
+    //========== Check arguments
+    assert(demod, "Receiver cannot be NULL", -1);
+    assert(signal && signal->points && signal->size, "Signal cannot be NULL or empty", -1);
+    assert(data, "Data cannot be NULL", -1);
+    assert(
+        signal->size <= demod->maxPoints,
+        "Frame of %zu points above the %zu points of the receiver", -1,
+        signal->size, demod->maxPoints
+    );
+    param  = &demod->param;
+    nbBits = 8 * param->dataSize;
+
+    //========== Envelope detection
+    //----- Phase of the carrier, least squares fit of a sin and a cos on the frame
+    for (size_t i = 0; i < signal->size; i=i+1) {
+        turns = (double)param->carrierFreq * (double)signal->points[i].x * 1e-9;
+        turns = turns - floor(turns);
+        demod->projection[i+1] = sin(2 * M_PI * turns);
+        demod->energy[i+1]     = cos(2 * M_PI * turns);
+        gram[0] = gram[0] + demod->projection[i+1] * demod->projection[i+1];
+        gram[1] = gram[1] + demod->projection[i+1] * demod->energy[i+1];
+        gram[2] = gram[2] + demod->energy[i+1] * demod->energy[i+1];
+        proj[0] = proj[0] + signal->points[i].y * demod->projection[i+1];
+        proj[1] = proj[1] + signal->points[i].y * demod->energy[i+1];
+    }
+    det = gram[0] * gram[2] - gram[1] * gram[1];
+    a   = det > 1e-9 * gram[0] * gram[2] ? (gram[2] * proj[0] - gram[1] * proj[1]) / det : 1;
+    b   = det > 1e-9 * gram[0] * gram[2] ? (gram[0] * proj[1] - gram[1] * proj[0]) / det : 0;
+    norm = sqrt(a * a + b * b);
+    if (!(norm > 0)) {
+        a    = 1;
+        b    = 0;
+        norm = 1;
+    }
+
+    //----- Prefix sums of the projection on the carrier and of its energy
+    demod->projection[0] = 0;
+    demod->energy[0]     = 0;
+    for (size_t i = 0; i < signal->size; i=i+1) {
+        carrier                = (a * demod->projection[i+1] + b * demod->energy[i+1]) / norm;
+        demod->projection[i+1] = demod->projection[i] + signal->points[i].y * carrier;
+        demod->energy[i+1]     = demod->energy[i] + carrier * carrier;
+    }
+
+    //========== Timing recovery: timing of the chips opening the eye the most
+    for (int step = 0; step < DEMOD_TIMING_STEPS; step=step+1) {
+        timing = signal->points[0].x - (int)demod->chipDuration / 2 +
+                 step * (int)demod->chipDuration / DEMOD_TIMING_STEPS;
+        spread = demod_chips(demod, signal, timing);
+        if (spread > best) {
+            best          = spread;
+            demod->timing = timing;
+        }
+    }
+    demod_chips(demod, signal, demod->timing);
+
+    //========== Decision threshold, between the levels of the chips
+    for (size_t k = 0; k < demod->nbChips; k=k+1) {
+        levels[0][0] = levels[0][0] + demod->weights[k] * demod->chips[k];
+        levels[0][1] = levels[0][1] + demod->weights[k];
+    }
+    mean         = levels[0][1] > 0 ? levels[0][0] / levels[0][1] : 0;
+    levels[0][0] = 0;
+    levels[0][1] = 0;
+    for (size_t k = 0; k < demod->nbChips; k=k+1) {
+        levels[demod->chips[k] >= mean][0] = levels[demod->chips[k] >= mean][0] + demod->weights[k] * demod->chips[k];
+        levels[demod->chips[k] >= mean][1] = levels[demod->chips[k] >= mean][1] + demod->weights[k];
+    }
+    levels[1][0] = levels[1][1] > 0 ? levels[1][0] / levels[1][1] : mean;
+    levels[0][0] = levels[0][1] > 0 ? levels[0][0] / levels[0][1] : levels[1][0];
+    mean         = (levels[0][0] + levels[1][0]) / 2;
+
+    //========== Demodulate and decode each bit
+    memset(data, 0, param->dataSize);
+    demod->margin = INFINITY;
+    for (size_t n = 0; n < nbBits; n=n+1) {
+        //----- Sub-carrier demodulation of the quarters, weighted by the energy of the chips
+        for (size_t q = 0; q < 4; q=q+1) {
+            if (param->subModulation == NONE) {
+                perQuarter[0] = 4*n + q;
+                perQuarter[1] = 4*n + q + 1;
+            } else {
+                perQuarter[0] = (4*n + q)     * (param->subCarrierFreq / param->bitRate) / 2;
+                perQuarter[1] = (4*n + q + 1) * (param->subCarrierFreq / param->bitRate) / 2;
+            }
+            soft[q] = 0;
+            for (size_t k = perQuarter[0]; k < perQuarter[1]; k=k+1) {
+                switch (param->subModulation) {
+                    //----- OOK: the even chips are high without sub-carrier
+                    case OOK:
+                        if ((k - perQuarter[0]) % 2 == 0)
+                            soft[q] = soft[q] + demod->weights[k] * (demod->chips[k] - mean);
+                    break;
+
+                    //----- BPSK: the even chips are high for a 1, the odd ones for a 0
+                    case BPSK:
+                        if ((k - perQuarter[0]) % 2 == 0)
+                            soft[q] = soft[q] + demod->weights[k] * (demod->chips[k] - mean);
+                        else
+                            soft[q] = soft[q] - demod->weights[k] * (demod->chips[k] - mean);
+                    break;
+
+                    //----- No sub-carrier: one chip per quarter
+                    default:
+                        soft[q] = soft[q] + demod->weights[k] * (demod->chips[k] - mean);
+                    break;
+                }
+            }
+        }
+
+        //----- Decoding of the bit
+        switch (param->encodingType) {
+            //----- Modified miller encoding, pause in the third quarter for a 1
+            case MOD_MILLER:
+                bit = -soft[2];
+            break;
+
+            //----- Manchester encoding, high in the second half for a 1
+            case MANCHESTER:
+                bit = soft[2] + soft[3] - soft[0] - soft[1];
+            break;
+
+            //----- Non-return-to-zero encoding
+            default:
+                bit = soft[0] + soft[1] + soft[2] + soft[3];
+            break;
+        }
+        if (bit > 0)
+            data[n/8] = (char)(data[n/8] | (1 << (n%8)));
+
+        //----- Margin, relative to the energy of the bit and the eye opening
+        if (levels[1][0] > levels[0][0] && demod->energy[signal->size] > 0) {
+            bit = fabs(bit) / ((levels[1][0] - levels[0][0]) * demod->energy[signal->size] / (double)nbBits);
+            if (bit < demod->margin)
+                demod->margin = bit;
+        }
     }
+    PROFILE_COUNT(signal->size, signal->size * sizeof(point_t));
 
     return 0;
 }
@@ -94,7 +764,7 @@ int createLUT(char** LUT, size_t LUTSize) {
     }
 
     //========== Allocate memory
-    *LUT = calloc(LUTSize, sizeof(**LUT));
+    *LUT = nfc_calloc(LUTSize, sizeof(**LUT));
     assert(*LUT, "Failed to allocate memory for the LUT", -1);
 
     //========== Create the LUT
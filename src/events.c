@@ -0,0 +1,461 @@
+/**
+ * @file events.c
+ * @author OUSSET Gaël
+ * @brief Compact binary files of LCADC samples: delta-encoded varint
+ *        timestamps, level indices and an index of blocks for seeking
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "events.h"
+#include "logging.h"
+#include "assert.h"
+#include "context.h"
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#define EVENTS_MAGIC   0x45434E46U               // "NFCE"
+#define EVENTS_VERSION 1
+
+/**
+ * Maximum size of an encoded event (bytes)
+ */
+#define EVENTS_MAX_VARINT 10
+
+/**
+ * @brief Header of an event file, followed by the levels
+ * 
+ */
+typedef struct {
+    uint32_t magic;                              // EVENTS_MAGIC
+    uint32_t version;                            // EVENTS_VERSION
+    uint32_t nbLevels;                           // Number of levels
+    uint32_t blockSize;                          // Number of events of a block
+    uint64_t nbEvents;                           // Number of events
+    uint64_t nbBlocks;                           // Number of blocks
+    uint64_t indexOffset;                        // Offset of the index (bytes)
+} events_header_t;
+
+/**
+ * @brief Compare two levels for qsort()
+ * 
+ * @param a First level
+ * @param b Second level
+ * @return int - Sign of a - b
+ */
+static int events_compareLevels(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Return the number of bits of an index of nbLevels levels
+ * 
+ * @param nbLevels Number of levels
+ * @return unsigned int - Number of bits
+ */
+static unsigned int events_levelBits(unsigned int nbLevels) {
+    unsigned int bits = 0;
+
+    while (bits < 32 && (1ULL << bits) < nbLevels)
+        bits = bits + 1;
+    return bits;
+}
+
+/**
+ * @brief Write the current block of a writer to its file
+ * 
+ * @param writer Writer
+ * @return int - 0 if success, -1 otherwise
+ */
+static int events_flushBlock(events_writer_t writer) {
+    if (!writer->used)
+        return 0;
+    assert(
+        fwrite(writer->buffer, 1, writer->used, writer->file) == writer->used,
+        "Cannot write to file %s", -1, writer->filename
+    );
+    writer->offset = writer->offset + writer->used;
+    writer->used   = 0;
+    return 0;
+}
+
+int events_writerOpen(char* filename, double* levels, unsigned int nbLevels, events_writer_t* writer) {
+    //========== Variables declaration
+    events_header_t header = {0};                // Header, completed on close
+
+    //========== Check arguments
+    assert(filename && filename[0], "Filename cannot be NULL or empty", -1);
+    assert(levels && nbLevels, "Levels cannot be NULL or empty", -1);
+    assert(nbLevels <= EVENTS_MAX_LEVELS, "Too many levels (%u > %u)", -1, nbLevels, EVENTS_MAX_LEVELS);
+
+    //========== Allocate the writer
+    *writer = nfc_calloc(1, sizeof(**writer));
+    assert(*writer, "Failed to allocate memory for the event writer", -1);
+    (*writer)->filename = nfc_malloc(strlen(filename) + 1);
+    (*writer)->levels   = nfc_malloc(nbLevels * sizeof(*levels));
+    (*writer)->buffer   = nfc_malloc(EVENTS_BLOCK_SIZE * EVENTS_MAX_VARINT);
+    if (!(*writer)->filename || !(*writer)->levels || !(*writer)->buffer) {
+        PRINT(ERR, "Failed to allocate memory for the event writer");
+        goto fail;
+    }
+    strcpy((*writer)->filename, filename);
+    memcpy((*writer)->levels, levels, nbLevels * sizeof(*levels));
+    qsort((*writer)->levels, nbLevels, sizeof(*levels), events_compareLevels);
+    (*writer)->nbLevels  = nbLevels;
+    (*writer)->levelBits = events_levelBits(nbLevels);
+
+    //========== Write the header and the levels, the header is rewritten on close
+    (*writer)->file = fopen(filename, "wb");
+    if (!(*writer)->file) {
+        PRINT(ERR, "Cannot open file %s", filename);
+        goto fail;
+    }
+    if (fwrite(&header, sizeof(header), 1, (*writer)->file) != 1 ||
+        fwrite((*writer)->levels, sizeof(double), nbLevels, (*writer)->file) != nbLevels) {
+        PRINT(ERR, "Cannot write to file %s", filename);
+        fclose((*writer)->file);
+        remove(filename);
+        goto fail;
+    }
+    (*writer)->offset = sizeof(header) + nbLevels * sizeof(double);
+
+    return 0;
+
+fail:
+    nfc_free((*writer)->filename);
+    nfc_free((*writer)->levels);
+    nfc_free((*writer)->buffer);
+    nfc_free(*writer);
+    *writer = NULL;
+    return -1;
+}
+
+int events_write(events_writer_t writer, const point_t* events, size_t nbEvents) {
+    //========== Variables declaration
+    events_index_t* grown;                       // Index after a reallocation
+    size_t          low;                         // Lowest candidate level
+    size_t          high;                        // Highest candidate level
+    size_t          middle;                      // Level tested
+    uint64_t        token;                       // Encoded event
+
+    //========== Check arguments
+    assert(writer, "Writer cannot be NULL", -1);
+    assert(events || !nbEvents, "Events cannot be NULL if nbEvents is not null", -1);
+
+    for (size_t i = 0; i < nbEvents; i=i+1) {
+        //----- Start a block
+        if (writer->nbEvents % EVENTS_BLOCK_SIZE == 0) {
+            if (events_flushBlock(writer))
+                return -1;
+            if (writer->nbEvents / EVENTS_BLOCK_SIZE == writer->capacity) {
+                grown = nfc_realloc(writer->index, (2 * writer->capacity + 1) * sizeof(*grown));
+                assert(grown, "Failed to allocate memory for the index", -1);
+                writer->index    = grown;
+                writer->capacity = 2 * writer->capacity + 1;
+            }
+            writer->index[writer->nbEvents / EVENTS_BLOCK_SIZE].offset = writer->offset;
+            writer->index[writer->nbEvents / EVENTS_BLOCK_SIZE].time   = events[i].x;
+            writer->previous                                          = events[i].x;
+        }
+
+        //----- Level of the event
+        low  = 0;
+        high = writer->nbLevels;
+        while (high - low > 1) {
+            middle = (low + high) / 2;
+            if (writer->levels[middle] <= events[i].y)
+                low = middle;
+            else
+                high = middle;
+        }
+        assert(
+            writer->levels[low] == events[i].y,
+            "Event %zu: %g is not a level of the file", -1, i, events[i].y
+        );
+        assert(
+            events[i].x >= writer->previous,
+            "Event %zu: time %d is before the previous event", -1, i, events[i].x
+        );
+
+        //----- Encode the event
+        token            = ((uint64_t)(events[i].x - writer->previous) << writer->levelBits) | low;
+        writer->previous = events[i].x;
+        do {
+            writer->buffer[writer->used] = (unsigned char)(token & 0x7F) | (token > 0x7F ? 0x80 : 0);
+            writer->used                 = writer->used + 1;
+            token                        = token >> 7;
+        } while (token);
+        writer->nbEvents = writer->nbEvents + 1;
+    }
+
+    return 0;
+}
+
+int events_writerClose(events_writer_t writer) {
+    //========== Variables declaration
+    events_header_t header;                      // Header of the file
+    char            padding[8] = {0};            // Padding of the index
+    size_t          nbPadding;                   // Bytes of padding
+    int             ok;                          // 1 if the file is fully written
+
+    //========== Check arguments
+    assert(writer, "Writer cannot be NULL", -1);
+
+    //========== Write the last block, the index and the header
+    header.magic       = EVENTS_MAGIC;
+    header.version     = EVENTS_VERSION;
+    header.nbLevels    = writer->nbLevels;
+    header.blockSize   = EVENTS_BLOCK_SIZE;
+    header.nbEvents    = writer->nbEvents;
+    header.nbBlocks    = (writer->nbEvents + EVENTS_BLOCK_SIZE - 1) / EVENTS_BLOCK_SIZE;
+
+    ok                 = !events_flushBlock(writer);
+    nbPadding          = (8 - writer->offset % 8) % 8;
+    header.indexOffset = writer->offset + nbPadding;
+    ok = ok &&
+         fwrite(padding, 1, nbPadding, writer->file) == nbPadding &&
+         fwrite(writer->index, sizeof(*writer->index), header.nbBlocks, writer->file) == header.nbBlocks &&
+         !fseek(writer->file, 0, SEEK_SET) &&
+         fwrite(&header, sizeof(header), 1, writer->file) == 1;
+    ok = !fclose(writer->file) && ok;
+    if (!ok) {
+        PRINT(ERR, "Failed to write the event file %s", writer->filename);
+        remove(writer->filename);
+    }
+
+    nfc_free(writer->filename);
+    nfc_free(writer->levels);
+    nfc_free(writer->buffer);
+    nfc_free(writer->index);
+    nfc_free(writer);
+    return ok ? 0 : -1;
+}
+
+int events_readerOpen(char* filename, events_reader_t* reader) {
+    //========== Variables declaration
+    events_header_t header;                      // Header of the file
+    unsigned char*  content;                     // Content of the file
+    size_t          fileSize;                    // Size of the file
+#ifndef _WIN32
+    int             fd;                          // Descriptor of the file
+    struct stat     info;                        // Size of the file
+#else
+    FILE*           file;                        // File of the events
+#endif
+
+    //========== Check arguments
+    assert(filename && filename[0], "Filename cannot be NULL or empty", -1);
+
+    //========== Map the file
+#ifndef _WIN32
+    fd = open(filename, O_RDONLY);
+    assert(fd >= 0, "Cannot open file %s", -1, filename);
+    if (fstat(fd, &info) || (size_t)info.st_size < sizeof(header)) {
+        close(fd);
+        PRINT(ERR, "Invalid event file %s", filename);
+        return -1;
+    }
+    fileSize = (size_t)info.st_size;
+    content  = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    assert(content != MAP_FAILED, "Cannot map file %s", -1, filename);
+#else
+    file = fopen(filename, "rb");
+    assert(file, "Cannot open file %s", -1, filename);
+    fseek(file, 0, SEEK_END);
+    fileSize = (size_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+    content = nfc_malloc(fileSize ? fileSize : 1);
+    if (!content || fread(content, 1, fileSize, file) != fileSize) {
+        nfc_free(content);
+        fclose(file);
+        PRINT(ERR, "Cannot read file %s", filename);
+        return -1;
+    }
+    fclose(file);
+#endif
+
+    //========== Check the header
+    memcpy(&header, content, fileSize < sizeof(header) ? 0 : sizeof(header));
+    if (fileSize            <  sizeof(header)                                  ||
+        header.magic        != EVENTS_MAGIC                                    ||
+        header.version      != EVENTS_VERSION                                  ||
+        header.blockSize    != EVENTS_BLOCK_SIZE                               ||
+        header.nbLevels     == 0 || header.nbLevels > EVENTS_MAX_LEVELS         ||
+        header.nbBlocks     != (header.nbEvents + EVENTS_BLOCK_SIZE - 1) / EVENTS_BLOCK_SIZE ||
+        header.indexOffset  %  8                                               ||
+        header.indexOffset  <  sizeof(header) + header.nbLevels * sizeof(double) ||
+        header.indexOffset  >  fileSize                                        ||
+        (fileSize - header.indexOffset) / sizeof(events_index_t) != header.nbBlocks ||
+        !(*reader = nfc_calloc(1, sizeof(**reader)))
+    ) {
+        PRINT(ERR, "Invalid event file %s", filename);
+#ifndef _WIN32
+        munmap(content, fileSize);
+#else
+        nfc_free(content);
+#endif
+        return -1;
+    }
+
+    //========== Levels and index are read in place
+    (*reader)->content   = content;
+    (*reader)->fileSize  = fileSize;
+    (*reader)->levels    = (const double*)(content + sizeof(header));
+    (*reader)->nbLevels  = header.nbLevels;
+    (*reader)->levelBits = events_levelBits(header.nbLevels);
+    (*reader)->nbEvents  = header.nbEvents;
+    (*reader)->nbBlocks  = header.nbBlocks;
+    (*reader)->index     = (const events_index_t*)(content + header.indexOffset);
+
+    return 0;
+}
+
+void events_readerClose(events_reader_t reader) {
+#ifndef _WIN32
+    munmap((void*)reader->content, reader->fileSize);
+#else
+    nfc_free((void*)reader->content);
+#endif
+    nfc_free(reader);
+}
+
+int events_read(events_reader_t reader, point_t* events, size_t maxEvents, size_t* nbEvents) {
+    //========== Variables declaration
+    const events_index_t* block;                 // Block of the next event
+    size_t                end;                   // End of the encoded events (bytes)
+    uint64_t              token;                 // Encoded event
+    unsigned int          shift;                 // Shift of the next varint byte
+    unsigned char         byte;                  // Varint byte
+
+    //========== Check arguments
+    assert(reader, "Reader cannot be NULL", -1);
+    assert(events || !maxEvents, "Events cannot be NULL if maxEvents is not null", -1);
+    assert(nbEvents, "nbEvents cannot be NULL", -1);
+
+    end       = (size_t)((const events_header_t*)reader->content)->indexOffset;
+    *nbEvents = 0;
+    while (*nbEvents < maxEvents && reader->next < reader->nbEvents) {
+        //----- Start of a block
+        if (reader->next % EVENTS_BLOCK_SIZE == 0) {
+            block            = &reader->index[reader->next / EVENTS_BLOCK_SIZE];
+            reader->position = (size_t)block->offset;
+            reader->previous = block->time;
+        }
+
+        //----- Decode the event
+        token = 0;
+        shift = 0;
+        do {
+            assert(reader->position < end && shift < 64, "Corrupted event file, event %llu", -1, (unsigned long long)reader->next);
+            byte             = reader->content[reader->position];
+            token            = token | ((uint64_t)(byte & 0x7F) << shift);
+            shift            = shift + 7;
+            reader->position = reader->position + 1;
+        } while (byte & 0x80);
+        assert(
+            (token & ((1ULL << reader->levelBits) - 1)) < reader->nbLevels,
+            "Corrupted event file, event %llu", -1, (unsigned long long)reader->next
+        );
+
+        reader->previous    = reader->previous + (int64_t)(token >> reader->levelBits);
+        events[*nbEvents].x = (int)reader->previous;
+        events[*nbEvents].y = reader->levels[token & ((1ULL << reader->levelBits) - 1)];
+        *nbEvents           = *nbEvents + 1;
+        reader->next        = reader->next + 1;
+    }
+
+    return 0;
+}
+
+int events_seek(events_reader_t reader, int time) {
+    //========== Variables declaration
+    size_t   low  = 0;                           // Lowest candidate block
+    size_t   high;                               // Block after the highest candidate
+    size_t   middle;                             // Block tested
+    uint64_t next;                               // Number of the event before the next one decoded
+    size_t   position;                           // Offset of that event
+    int64_t  previous;                           // Time of the event before it
+    point_t  event;                              // Decoded event
+    size_t   nbRead;                             // Number of events decoded
+
+    //========== Check arguments
+    assert(reader, "Reader cannot be NULL", -1);
+
+    //========== Last block starting before the time, events of equal time may end the previous one
+    high = reader->nbBlocks;
+    while (high - low > 1) {
+        middle = (low + high) / 2;
+        if (reader->index[middle].time < time)
+            low = middle;
+        else
+            high = middle;
+    }
+    reader->next = low * EVENTS_BLOCK_SIZE;
+
+    //========== Decode up to the time
+    do {
+        next     = reader->next;
+        position = reader->position;
+        previous = reader->previous;
+        if (events_read(reader, &event, 1, &nbRead))
+            return -1;
+    } while (nbRead && event.x < time);
+
+    //----- Step back before the first event at or after the time
+    reader->next     = next;
+    reader->position = position;
+    reader->previous = previous;
+
+    return 0;
+}
+
+int events_save(char* filename, scatter_t samples, double* levels, unsigned int nbLevels) {
+    //========== Variables declaration
+    events_writer_t writer;                      // Writer of the file
+
+    //========== Check arguments
+    assert(samples, "Samples cannot be NULL", -1);
+
+    //========== Write the samples
+    assert(!events_writerOpen(filename, levels, nbLevels, &writer), "Failed to create the event file %s", -1, filename);
+    if (events_write(writer, samples->points, samples->size)) {
+        events_writerClose(writer);
+        remove(filename);
+        return -1;
+    }
+    return events_writerClose(writer);
+}
+
+int events_load(char* filename, scatter_t* samples) {
+    //========== Variables declaration
+    events_reader_t reader;                      // Reader of the file
+    size_t          nbRead;                      // Number of events read
+
+    //========== Read the events
+    assert(!events_readerOpen(filename, &reader), "Failed to open the event file %s", -1, filename);
+    if (scatter_create(samples, (size_t)reader->nbEvents)) {
+        events_readerClose(reader);
+        return -1;
+    }
+    if (events_read(reader, (*samples)->points, (*samples)->size, &nbRead) || nbRead != (*samples)->size) {
+        PRINT(ERR, "Failed to read the event file %s", filename);
+        scatter_destroy(*samples);
+        events_readerClose(reader);
+        return -1;
+    }
+
+    events_readerClose(reader);
+    return 0;
+}
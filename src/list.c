@@ -14,6 +14,7 @@
 
 #include "list.h"
 #include "assert.h"
+#include "context.h"
 
 list_t list_new(void) { 
     return NULL; 
@@ -38,7 +39,7 @@ list_t list_next(list_t l) {
 }
 
 list_t list_add_first(list_t l, void* object) { 
-    struct link_t *new = malloc(sizeof(*new));
+    struct link_t *new = nfc_malloc(sizeof(*new));
     assert(new, "Memory allocation failed", l); 
 
     new->content = object; 
@@ -53,7 +54,7 @@ list_t list_add_last(list_t l, void* object) {
         return l;
     }
 
-    struct link_t *new = malloc(sizeof(*new));
+    struct link_t *new = nfc_malloc(sizeof(*new));
     assert(new, "Memory allocation failed", l);
 
     list_t first = l;
@@ -76,7 +77,7 @@ list_t list_del_first(list_t l, action_t delete) {
 
     if (delete) delete(l->content);
     
-    free(l);
+    nfc_free(l);
     
     return next; 
 }
@@ -10,62 +10,256 @@
  */
 
 #include "logging.h"
+#include "context.h"
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
 #include <stdarg.h>
+#include <stdatomic.h>
+#include <stdlib.h>
 
-void printInfo(print_type_t print_type, const char* format, ...) {
-    va_list args;                                // Variable argument list
-    
-    //----- Print the type of the message
+/**
+ * Maximum length of a message, longer messages are truncated
+ */
+#define MESSAGE_SIZE 1024
+
+void printStderr(void* user, print_type_t print_type, const char* message) {
+    //========== Variables declaration
+    char        line[MESSAGE_SIZE + 64];         // Styled line
+    const char* tag;                             // Tag of the type
+    int         color;                           // Color of the tag
+    const char* style = STYLE_BOLD;              // Style of the tag
+
+    (void)user;
+
+    //----- Style of the type of the message
     switch (print_type) {
-        #if VERBOSITY >= 0
-            case NORM:
-                STYLE(stderr, COLOR_WHITE, STYLE_REGULAR);
-                fprintf(stderr, "\t");
-            break;
-        #endif
-        #if VERBOSITY >= 1
-            case ERR:
-                STYLE(stderr, COLOR_RED, STYLE_BOLD);
-                fprintf(stderr, "[ERR]\t");
-            break;
-        #endif
-        #if VERBOSITY >= 2
-            case WARN:
-                STYLE(stderr, COLOR_YELLOW, STYLE_BOLD);
-                fprintf(stderr, "[WARN]\t");
-            break;
-        #endif
-        #if VERBOSITY >= 3
-            case SUCC:
-                STYLE(stderr, COLOR_GREEN, STYLE_BOLD);
-                fprintf(stderr, "[SUCC]\t");
-            break;
-        #endif
-        #if VERBOSITY >= 4
-            case INFO:
-                STYLE(stderr, COLOR_BLUE, STYLE_BOLD);
-                fprintf(stderr, "[INFO]\t");
-            break;
-        #endif
-        #if VERBOSITY >= 5
-            case DBG:
-                STYLE(stderr, COLOR_MAGENTA, STYLE_BOLD);
-                fprintf(stderr, "[DBG]\t");
-            break;
-        #endif
-        default:
-            // STYLE(stderr, COLOR_WHITE, STYLE_REGULAR);
-            // fprintf(stderr, "[MSG]\t");
-        break;
+        case NORM: color = COLOR_WHITE;   tag = "\t";       style = STYLE_REGULAR; break;
+        case ERR:  color = COLOR_RED;     tag = "[ERR]\t";  break;
+        case WARN: color = COLOR_YELLOW;  tag = "[WARN]\t"; break;
+        case SUCC: color = COLOR_GREEN;   tag = "[SUCC]\t"; break;
+        case INFO: color = COLOR_BLUE;    tag = "[INFO]\t"; break;
+        case DBG:  color = COLOR_MAGENTA; tag = "[DBG]\t";  break;
+        default:   return;
     }
-    
-    //----- Print the message
-    if (VERBOSITY >= print_type) {
-        STYLE(stderr, COLOR_WHITE, STYLE_REGULAR);
-        va_start(args, format);
-        vfprintf(stderr, format, args);
-        va_end(args);
-        printf("\n");
-        STYLE_RESET(stderr);
+
+    //----- Print the whole line at once
+    snprintf(
+        line, sizeof(line),
+        "%s%dm%s%s%dm%s" ANSI_ESC "0m\n",
+        style, color, tag,
+        STYLE_REGULAR, COLOR_WHITE, message
+    );
+    fputs(line, stderr);
+}
+
+//========== Asynchronous output
+/**
+ * @brief Message waiting for the logging thread. The sequence tells which
+ *        lap of the ring buffer the slot is ready for (bounded queue of
+ *        D. Vyukov).
+ * 
+ */
+typedef struct {
+    atomic_size_t sequence;                      // Position the slot is ready for
+    print_type_t  type;                          // Type of the message
+    nfc_logSink_t sink;                          // Sink of the message
+    void*         user;                          // User pointer of the sink
+    char          message[MESSAGE_SIZE];         // Formatted message
+} log_slot_t;
+
+/**
+ * @brief States of the logging thread
+ * 
+ */
+enum {
+    LOG_IDLE,                                    // Not started yet
+    LOG_RUNNING,                                 // Draining the ring buffer
+    LOG_STOPPED                                  // Stopped, messages are printed synchronously
+};
+
+static log_slot_t    log_slots[LOG_BUFFER_SIZE]; // Ring buffer of the messages
+static atomic_size_t log_enqueued;               // Number of claimed slots
+static atomic_size_t log_dequeued;               // Number of messages sent to their sink
+static atomic_size_t log_dropped;                // Messages dropped since the last report
+static atomic_int    log_state = LOG_IDLE;       // State of the logging thread
+static atomic_int    log_stopping;               // 1 once the thread should stop
+static sem_t         log_pending;                // Posted once per message, and to stop
+static pthread_t     log_thread;                 // Logging thread
+static pthread_once_t log_once = PTHREAD_ONCE_INIT; // Start of the logging thread
+
+/**
+ * @brief Send a message to its sink
+ * 
+ * @param sink Sink of the message, NULL for stderr
+ * @param user User pointer of the sink
+ * @param print_type Type of the message
+ * @param message Formatted message
+ */
+static void log_send(nfc_logSink_t sink, void* user, print_type_t print_type, const char* message) {
+    if (sink)
+        sink(user, print_type, message);
+    else
+        printStderr(NULL, print_type, message);
+}
+
+/**
+ * @brief Send the oldest message of the ring buffer to its sink, waiting for
+ *        its producer to finish writing it
+ * 
+ */
+static void log_drainOne(void) {
+    //========== Variables declaration
+    size_t      position = atomic_load_explicit(&log_dequeued, memory_order_relaxed);
+    log_slot_t* slot     = &log_slots[position % LOG_BUFFER_SIZE];
+    size_t      dropped;                         // Messages dropped before this one
+    char        report[64];                      // Report of the dropped messages
+
+    while (atomic_load_explicit(&slot->sequence, memory_order_acquire) != position + 1)
+        sched_yield();
+
+    dropped = atomic_exchange_explicit(&log_dropped, 0, memory_order_relaxed);
+    if (dropped) {
+        snprintf(report, sizeof(report), "%zu messages dropped, logging buffer full", dropped);
+        printStderr(NULL, WARN, report);
+    }
+    log_send(slot->sink, slot->user, slot->type, slot->message);
+
+    atomic_store_explicit(&slot->sequence, position + LOG_BUFFER_SIZE, memory_order_release);
+    atomic_store_explicit(&log_dequeued, position + 1, memory_order_release);
+}
+
+/**
+ * @brief Logging thread, send the messages to their sink until stopped
+ * 
+ * @param arg Unused
+ * @return void* - NULL
+ */
+static void* log_worker(void* arg) {
+    (void)arg;
+
+    for (;;) {
+        while (sem_wait(&log_pending));
+        // Every message posts once, so the queue is empty only on the stop post
+        if (atomic_load(&log_enqueued) == atomic_load_explicit(&log_dequeued, memory_order_relaxed)) {
+            if (atomic_load(&log_stopping))
+                return NULL;
+            continue;
+        }
+        log_drainOne();
+    }
+}
+
+/**
+ * @brief Stop the logging thread at exit, once the queued messages are sent
+ * 
+ */
+static void log_stop(void) {
+    atomic_store(&log_stopping, 1);
+    sem_post(&log_pending);
+    pthread_join(log_thread, NULL);
+    atomic_store(&log_state, LOG_STOPPED);
+
+    // Messages queued while stopping
+    while (atomic_load(&log_enqueued) != atomic_load(&log_dequeued))
+        log_drainOne();
+}
+
+/**
+ * @brief Start the logging thread, messages are printed synchronously if it
+ *        cannot be started
+ * 
+ */
+static void log_start(void) {
+    for (size_t i = 0; i < LOG_BUFFER_SIZE; i=i+1)
+        atomic_init(&log_slots[i].sequence, i);
+
+    if (sem_init(&log_pending, 0, 0)) {
+        atomic_store(&log_state, LOG_STOPPED);
+        return;
+    }
+    if (pthread_create(&log_thread, NULL, log_worker, NULL)) {
+        sem_destroy(&log_pending);
+        atomic_store(&log_state, LOG_STOPPED);
+        return;
+    }
+    atomic_store(&log_state, LOG_RUNNING);
+    atexit(log_stop);
+}
+
+/**
+ * @brief Claim a slot of the ring buffer
+ * 
+ * @param position Position of the claimed slot
+ * @return log_slot_t* - Claimed slot, NULL if the buffer is full
+ */
+static log_slot_t* log_claim(size_t* position) {
+    //========== Variables declaration
+    log_slot_t* slot;                            // Slot at the position
+    size_t      sequence;                        // Position the slot is ready for
+
+    *position = atomic_load_explicit(&log_enqueued, memory_order_relaxed);
+    for (;;) {
+        slot     = &log_slots[*position % LOG_BUFFER_SIZE];
+        sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        if (sequence == *position) {
+            if (atomic_compare_exchange_weak_explicit(&log_enqueued, position, *position + 1, memory_order_relaxed, memory_order_relaxed))
+                return slot;
+        } else if (sequence < *position)
+            // The slot still holds the message of the previous lap
+            return NULL;
+        else
+            *position = atomic_load_explicit(&log_enqueued, memory_order_relaxed);
+    }
+}
+
+void printFlush(void) {
+    //========== Variables declaration
+    size_t enqueued = atomic_load(&log_enqueued); // Messages to wait for
+
+    if (atomic_load(&log_state) != LOG_RUNNING || pthread_equal(pthread_self(), log_thread))
+        return;
+    while (atomic_load_explicit(&log_dequeued, memory_order_acquire) < enqueued)
+        sched_yield();
+}
+
+void printInfo(print_type_t print_type, const char* format, ...) {
+    //========== Variables declaration
+    va_list       args;                          // Variable argument list
+    char          message[MESSAGE_SIZE];         // Formatted message, when printed synchronously
+    nfc_context_t context = nfc_contextGet();    // Context holding the sink
+    log_slot_t*   slot    = NULL;                // Slot of the message in the ring buffer
+    size_t        position;                      // Position of the slot
+
+    //----- Filter the message
+    if ((int)print_type > VERBOSITY || (int)print_type > context->verbosity)
+        return;
+
+#ifndef SYNC_LOGGING
+    pthread_once(&log_once, log_start);
+    if (atomic_load_explicit(&log_state, memory_order_relaxed) == LOG_RUNNING) {
+        slot = log_claim(&position);
+        // Results and errors are never dropped
+        if (!slot && print_type != NORM && print_type != ERR) {
+            atomic_fetch_add_explicit(&log_dropped, 1, memory_order_relaxed);
+            return;
+        }
+    }
+#endif
+
+    //----- Format the message
+    va_start(args, format);
+    vsnprintf(slot ? slot->message : message, MESSAGE_SIZE, format, args);
+    va_end(args);
+
+    //----- Send it to the sink of the context
+    if (!slot) {
+        log_send(context->logSink, context->logUser, print_type, message);
+        return;
     }
-}
\ No newline at end of file
+    slot->type = print_type;
+    slot->sink = context->logSink;
+    slot->user = context->logUser;
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+    sem_post(&log_pending);
+}
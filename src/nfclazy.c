@@ -0,0 +1,209 @@
+/**
+ * @file nfclazy.c
+ * @author OUSSET Gaël
+ * @brief Lazily evaluated NFC signals, any range of samples is computed on
+ *        demand without generating the whole signal
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "nfclazy.h"
+#include "prng.h"
+#include "logging.h"
+#include "assert.h"
+#include "context.h"
+#include "cpu.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/**
+ * @brief Return the sub-modulated symbol seen by a sample, the same way as
+ *        nfc_createEnvelope() does
+ * 
+ * @param lazySig Lazy signal
+ * @param index Index of the sample
+ * @return char - Value of the symbol
+ */
+static char nfc_lazySymbol(nfc_lazySig_t lazySig, size_t index) {
+    //========== Variables declaration
+    size_t subModDataAddr;                       // Index of the sub-modulated symbol
+
+    subModDataAddr = (size_t)nfc_lazyGetX(lazySig, index) / lazySig->symboleDuration;
+    // Required to avoid overflow when having rounding errors
+    if (subModDataAddr >= lazySig->subModulatedSize)
+        subModDataAddr = lazySig->subModulatedSize - 1;
+
+    return nfc_subModulatedSymbol(&lazySig->sigParam, subModDataAddr);
+}
+
+/**
+ * @brief Apply the carrier and the noise on an envelope sample
+ * 
+ * @param lazySig Lazy signal
+ * @param index Index of the sample
+ * @param envelope Value of the envelope at this sample
+ * @return double - Amplitude of the sample
+ */
+static double nfc_lazyFinish(nfc_lazySig_t lazySig, size_t index, double envelope) {
+    //========== Variables declaration
+    point_t point;                               // Sample
+    double  y;                                   // Amplitude of the sample
+
+    //========== Modulate with the kernel of nfc_modulate()
+    point.x = nfc_lazyGetX(lazySig, index);
+    point.y = envelope;
+    cpu_kernels()->carrier(&point, &point, 1, lazySig->sigParam.carrierFreq);
+    y = point.y;
+
+    //========== Add noise
+    if (lazySig->sigParam.noiseLevel)
+        y = y + lazySig->sigParam.noiseLevel * (prng_uniform(lazySig->seed, index) - 0.5);
+
+    return y;
+}
+
+int nfc_lazyCreate(nfc_sigParam_t* sigParam, uint64_t seed, nfc_lazySig_t* lazySig) {
+    //========== Check arguments
+    assert(sigParam, "Signal parameters cannot be NULL", -1);
+    assert(sigParam->data, "Input data cannot be NULL", -1);
+    assert(!nfc_checkParam(sigParam), "Invalid signal parameters", -1);
+
+    //========== Allocate memory
+    *lazySig = nfc_malloc(sizeof(**lazySig));
+    assert(*lazySig, "Failed to allocate memory for the lazy signal", -1);
+
+    (*lazySig)->sigParam      = *sigParam;
+    (*lazySig)->sigParam.data = nfc_malloc(sigParam->dataSize);
+    if (!(*lazySig)->sigParam.data) {
+        PRINT(ERR, "Failed to allocate memory for the data of the lazy signal");
+        nfc_free(*lazySig);
+        return -1;
+    }
+    memcpy((*lazySig)->sigParam.data, sigParam->data, sigParam->dataSize);
+
+    //========== Precompute the constants of the signal
+    (*lazySig)->seed             = seed;
+    (*lazySig)->subModulatedSize = nfc_subModulatedSize(sigParam);
+    (*lazySig)->symboleDuration  = nfc_symbolDuration(sigParam);
+    (*lazySig)->transTime        = nfc_transitionTime(sigParam);
+    (*lazySig)->modulationDepth  = (double)(100 - sigParam->modulationIndex) /
+                                   (double)(sigParam->modulationIndex + 100);
+
+    if (!(*lazySig)->symboleDuration || !(*lazySig)->subModulatedSize) {
+        PRINT(ERR, "Invalid symbol duration for the lazy signal");
+        nfc_lazyDestroy(*lazySig);
+        return -1;
+    }
+
+    return 0;
+}
+
+void nfc_lazyDestroy(nfc_lazySig_t lazySig) {
+    nfc_free(lazySig->sigParam.data);
+    nfc_free(lazySig);
+}
+
+int nfc_lazyGetX(nfc_lazySig_t lazySig, size_t index) {
+    return (int)((unsigned long long)index *
+                 (unsigned long long)lazySig->sigParam.simDuration /
+                 lazySig->sigParam.numberOfPoints);
+}
+
+double nfc_lazyGetY(nfc_lazySig_t lazySig, size_t index) {
+    //========== Variables declaration
+    double       envelope   = 0;                 // Local average of the envelope
+    unsigned int avgCounter = 0;                 // Number of averaged points
+
+    //========== Check arguments
+    assert(index < lazySig->sigParam.numberOfPoints, "Sample %ld is out of the signal", NAN, index);
+
+    //========== Average the symbols over the transition time
+    for (int j = (int)index-(int)lazySig->transTime+1; j <= (int)index; j=j+1) {
+        if (j >= 0) {
+            if (nfc_lazySymbol(lazySig, (size_t)j))
+                envelope = envelope + 1;
+            else
+                envelope = envelope + lazySig->modulationDepth;
+            avgCounter = avgCounter + 1;
+        }
+    }
+    envelope = envelope / (double)avgCounter;
+
+    return nfc_lazyFinish(lazySig, index, envelope);
+}
+
+size_t nfc_lazyBitIndex(nfc_lazySig_t lazySig, size_t bit) {
+    //========== Variables declaration
+    nfc_sigParam_t*    sigParam = &lazySig->sigParam;
+    unsigned long long symbol;                   // First sub-modulated symbol of the bit
+    unsigned long long time;                     // Start time of the bit (ns)
+
+    //========== Find the first symbol of the bit
+    symbol = 4 * (unsigned long long)bit;
+    if (sigParam->subModulation != NONE)
+        symbol = symbol * (sigParam->subCarrierFreq / sigParam->bitRate) / 2;
+    time = symbol * lazySig->symboleDuration;
+
+    //========== First sample at or after this time
+    return (size_t)((time * sigParam->numberOfPoints + sigParam->simDuration - 1) /
+                    sigParam->simDuration);
+}
+
+int nfc_lazyRange(nfc_lazySig_t lazySig, size_t first, size_t last, scatter_t* signal) {
+    //========== Variables declaration
+    size_t start;                                // First sample of the transition history
+    char*  symbols;                              // Symbols seen by the samples [start, last)
+    double envelope;                             // Local average of the envelope
+    unsigned int avgCounter;                     // Number of averaged points
+
+    //========== Check arguments
+    assert(lazySig, "Lazy signal cannot be NULL", -1);
+    assert(first <= last, "Invalid range of samples", -1);
+    assert(last <= lazySig->sigParam.numberOfPoints, "Range of samples is out of the signal", -1);
+
+    //========== Allocate memory
+    assert(
+        !scatter_create(signal, last - first),
+        "Failed to allocate memory for the signal",
+        -1
+    );
+    if (first == last)
+        return 0;
+
+    //========== Evaluate each symbol once, including the transition history
+    start   = first >= lazySig->transTime ? first - lazySig->transTime + 1 : 0;
+    symbols = nfc_malloc(last - start);
+    if (!symbols) {
+        PRINT(ERR, "Failed to allocate memory for the symbols");
+        scatter_destroy(*signal);
+        return -1;
+    }
+    for (size_t j = start; j < last; j=j+1)
+        symbols[j - start] = nfc_lazySymbol(lazySig, j);
+
+    //========== Compute the samples
+    for (size_t i = first; i < last; i=i+1) {
+        envelope   = 0;
+        avgCounter = 0;
+        for (int j = (int)i-(int)lazySig->transTime+1; j <= (int)i; j=j+1) {
+            if (j >= 0) {
+                if (symbols[(size_t)j - start])
+                    envelope = envelope + 1;
+                else
+                    envelope = envelope + lazySig->modulationDepth;
+                avgCounter = avgCounter + 1;
+            }
+        }
+        envelope = envelope / (double)avgCounter;
+
+        (*signal)->points[i - first].x = nfc_lazyGetX(lazySig, i);
+        (*signal)->points[i - first].y = nfc_lazyFinish(lazySig, i, envelope);
+    }
+
+    nfc_free(symbols);
+    return 0;
+}
@@ -12,7 +12,11 @@
 #include "nfcsig.h"
 #include "logging.h"
 #include "assert.h"
+#include "context.h"
+#include "parallel.h"
+#include "cpu.h"
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 int nfc_autoSimTime(nfc_sigParam_t* sigParam) {
@@ -29,11 +33,280 @@ int nfc_autoSimTime(nfc_sigParam_t* sigParam) {
     return 0;
 }
 
+int nfc_checkParam(nfc_sigParam_t* sigParam) {
+    //========== Check arguments
+    assert(sigParam, "Signal parameters cannot be NULL", -1);
+    assert(sigParam->dataSize, "Input data size cannot be null", -1);
+
+    //----- Check encoding and sub-carrier modulation types
+    assert(
+        sigParam->encodingType == MOD_MILLER ||
+        sigParam->encodingType == NRZ ||
+        sigParam->encodingType == MANCHESTER,
+        "Invalid encoding type",
+        -1
+    );
+    assert(
+        sigParam->subModulation == NONE ||
+        sigParam->subModulation == OOK  ||
+        sigParam->subModulation == BPSK,
+        "Invalid sub-carrier modulation type",
+        -1
+    );
+
+    //----- Check frequencies
+    assert(sigParam->bitRate, "Bit rate cannot be null", -1);
+    assert(
+        sigParam->subCarrierFreq || sigParam->subModulation == NONE,
+        "Sub-carrier frequency cannot be null",
+        -1
+    );
+    assert(
+        !(sigParam->subCarrierFreq % sigParam->bitRate),
+        "Sub-carrier frequency should be a multiple of the bit rate",
+        -1
+    );
+    assert(sigParam->carrierFreq, "Carrier frequency cannot be null", -1);
+
+    //----- Check modulation index and noise level
+    assert(sigParam->modulationIndex <= 100, "Modulation index cannot be greater than 100", -1);
+    assert(
+        sigParam->noiseLevel >= 0 && sigParam->noiseLevel <= 1,
+        "Noise level should be between 0 and 1",
+        -1
+    );
+
+    //----- Check simulation duration and number of points
+    assert(sigParam->simDuration, "Simulation duration cannot be null", -1);
+    assert(sigParam->numberOfPoints, "Number of points cannot be null", -1);
+
+    return 0;
+}
+
+size_t nfc_subModulatedSize(nfc_sigParam_t* sigParam) {
+    //========== Variables declaration
+    size_t encodedSize = 8 * 4 * sigParam->dataSize;
+
+    //========== Check arguments
+    if (!sigParam->bitRate)
+        return 0;
+
+    //========== Same size as nfc_modulateSubCarrier()
+    if (sigParam->subModulation != NONE)
+        return encodedSize * (sigParam->subCarrierFreq / sigParam->bitRate) / 2;
+    return encodedSize;
+}
+
+char nfc_encodedSymbol(nfc_sigParam_t* sigParam, size_t index) {
+    //========== Variables declaration
+    char*  data    = sigParam->data;
+    size_t bit     = index / 4;                  // Index of the input bit
+    size_t quarter = index % 4;                  // Quarter of the bit
+    char   value   = (data[bit/8] >> (bit%8)) & 0x01;
+    char   previous;                             // Value of the previous bit
+
+    //========== Encode the symbol
+    switch (sigParam->encodingType) {
+        //----- Modified miller encoding
+        case MOD_MILLER:
+            // Bit at 1, pause in the third quarter
+            if (value)
+                return quarter != 2;
+            // The first bit is arbitrarily encoded as a 0 after 1
+            if (!bit)
+                return 0x01;
+            previous = (data[(bit-1)/8] >> ((bit-1)%8)) & 0x01;
+            // Bit at 0 after a 1, no pause
+            if (previous)
+                return 0x01;
+            // Bit at 0 after a 0, pause in the first quarter
+            return quarter != 0;
+
+        //----- Non-return-to-zero encoding
+        case NRZ:
+            return value;
+
+        //----- Manchester encoding
+        case MANCHESTER:
+            return value ? quarter >= 2 : quarter < 2;
+
+        //----- Default case
+        default:
+            return 0;
+    }
+}
+
+char nfc_subModulatedSymbol(nfc_sigParam_t* sigParam, size_t index) {
+    //========== Variables declaration
+    size_t ratio;                                // Sub-carrier half periods per bit
+    size_t encodedIndex;                         // Index of the encoded symbol
+    size_t offset;                               // Half period inside the symbol
+
+    //========== No sub-carrier modulation
+    if (sigParam->subModulation == NONE)
+        return nfc_encodedSymbol(sigParam, index);
+
+    //========== Find the encoded symbol covering this index
+    // nfc_modulateSubCarrier() fills [i*ratio/2, (i+1)*ratio/2) from the
+    // i-th encoded symbol
+    ratio        = sigParam->subCarrierFreq / sigParam->bitRate;
+    encodedIndex = (2*index + 1) / ratio;
+    offset       = index - encodedIndex * ratio / 2;
+
+    switch (sigParam->subModulation) {
+        //----- On-off keying
+        case OOK:
+            if (nfc_encodedSymbol(sigParam, encodedIndex))
+                return 0x01;
+            return offset % 2;
+
+        //----- Binary phase shift keying
+        case BPSK:
+            if (nfc_encodedSymbol(sigParam, encodedIndex))
+                return (offset + 1) % 2;
+            return offset % 2;
+
+        //----- Default case
+        default:
+            return 0;
+    }
+}
+
+unsigned int nfc_symbolDuration(nfc_sigParam_t* sigParam) {
+    // If there is no sub-carrier modulation, the duration of a symbol is the bit rate
+    if (sigParam->subModulation == NONE)
+        return (unsigned int)1e9 / sigParam->bitRate / 4;
+    // Otherwise, the duration of a symbol is the sub-carrier frequency
+    return (unsigned int)1e9 / sigParam->subCarrierFreq / 2;
+}
+
+unsigned int nfc_transitionTime(nfc_sigParam_t* sigParam) {
+    return (unsigned int)(2*1e9) / sigParam->carrierFreq * sigParam->numberOfPoints / sigParam->simDuration;
+}
+
+//========== Specialised kernels
+/**
+ * @brief Signature of an encoding kernel
+ * 
+ * @param data Data to encode
+ * @param size Number of bytes of the data
+ * @param encodedData Encoded data (4 symbols per bit)
+ */
+typedef void (*nfc_encodeKernel_t)(char* data, size_t size, char* encodedData);
+
+/**
+ * @brief Signature of a sub-carrier modulation kernel
+ * 
+ * @param encodedData Encoded data
+ * @param encodedSize Size of the encoded data
+ * @param ratio Ratio between the sub-carrier frequency and the bit rate
+ * @param subModulatedData Sub-modulated data
+ */
+typedef void (*nfc_subCarrierKernel_t)(char* encodedData, size_t encodedSize, unsigned int ratio, char* subModulatedData);
+
+/**
+ * @brief Instantiate an encoding kernel. Each bit is encoded as a pattern of
+ *        4 symbols (bit q = quarter q) chosen among three constants, folded
+ *        in by the compiler. The first bit is encoded as if it followed a 1.
+ * 
+ * @param ENCODING Encoding type, suffix of the kernel name
+ * @param ONE Pattern of a 1
+ * @param ZERO_AFTER_ONE Pattern of a 0 after a 1
+ * @param ZERO_AFTER_ZERO Pattern of a 0 after a 0
+ */
+#define NFC_ENCODE_KERNEL(ENCODING, ONE, ZERO_AFTER_ONE, ZERO_AFTER_ZERO)             \
+    static void nfc_encode_##ENCODING(char* data, size_t size, char* encodedData) {   \
+        unsigned char previous = 0x01;           /* Value of the previous bit */        \
+        unsigned char value;                     /* Value of the current bit */         \
+        unsigned char pattern;                   /* Encoded pattern of the bit */       \
+        for (size_t bit = 0; bit < 8 * size; bit=bit+1) {                                \
+            value   = (data[bit/8] >> (bit%8)) & 0x01;                                   \
+            pattern = value ? (ONE) : previous ? (ZERO_AFTER_ONE) : (ZERO_AFTER_ZERO);   \
+            encodedData[4*bit  ] = (char)( pattern       & 0x01);                        \
+            encodedData[4*bit+1] = (char)((pattern >> 1) & 0x01);                        \
+            encodedData[4*bit+2] = (char)((pattern >> 2) & 0x01);                        \
+            encodedData[4*bit+3] = (char)((pattern >> 3) & 0x01);                        \
+            previous = value;                                                            \
+        }                                                                                \
+    }
+
+/**
+ * @brief Instantiate a sub-carrier modulation kernel. Each encoded symbol
+ *        fills ratio/2 sub-carrier half periods, the value of a half period
+ *        is given by an expression of its offset in the symbol.
+ * 
+ * @param MODULATION Sub-carrier modulation type, suffix of the kernel name
+ * @param ONE Value of the half period `offset` of a symbol at 1
+ * @param ZERO Value of the half period `offset` of a symbol at 0
+ */
+#define NFC_SUBCARRIER_KERNEL(MODULATION, ONE, ZERO)                                   \
+    static void nfc_subCarrier_##MODULATION(                                           \
+        char* encodedData, size_t encodedSize, unsigned int ratio, char* subModulatedData \
+    ) {                                                                                \
+        size_t first;                            /* First half period of the symbol */  \
+        size_t last;                             /* Half period after the symbol */     \
+        for (size_t i = 0; i < encodedSize; i=i+1) {                                    \
+            first = i * ratio / 2;                                                       \
+            last  = (i+1) * ratio / 2;                                                   \
+            if (encodedData[i])                                                          \
+                for (size_t offset = 0; offset < last - first; offset=offset+1)          \
+                    subModulatedData[first + offset] = (char)(ONE);                      \
+            else                                                                         \
+                for (size_t offset = 0; offset < last - first; offset=offset+1)          \
+                    subModulatedData[first + offset] = (char)(ZERO);                     \
+        }                                                                                \
+    }
+
+NFC_ENCODE_KERNEL(MOD_MILLER, 0x0B, 0x0F, 0x0E)     // Pause in the 3rd quarter for a 1, in the 1st for a 0 after a 0
+NFC_ENCODE_KERNEL(NRZ,        0x0F, 0x00, 0x00)
+NFC_ENCODE_KERNEL(MANCHESTER, 0x0C, 0x03, 0x03)
+
+NFC_SUBCARRIER_KERNEL(OOK,  0x01,             offset % 2)
+NFC_SUBCARRIER_KERNEL(BPSK, (offset + 1) % 2, offset % 2)
+
+/**
+ * @brief Sub-carrier modulation kernel without sub-carrier, copy the data
+ * 
+ * @param encodedData Encoded data
+ * @param encodedSize Size of the encoded data
+ * @param ratio Unused
+ * @param subModulatedData Copy of the encoded data
+ */
+static void nfc_subCarrier_NONE(char* encodedData, size_t encodedSize, unsigned int ratio, char* subModulatedData) {
+    (void)ratio;
+    memcpy(subModulatedData, encodedData, encodedSize);
+}
+
+//----- Dispatch tables, indexed by nfc_encoding_t and nfc_subModulation_t
+static const nfc_encodeKernel_t nfc_encodeKernels[] = {
+    [MOD_MILLER] = nfc_encode_MOD_MILLER,
+    [NRZ]        = nfc_encode_NRZ,
+    [MANCHESTER] = nfc_encode_MANCHESTER
+};
+static const char* nfc_encodingNames[] = {
+    [MOD_MILLER] = "modified miller",
+    [NRZ]        = "NRZ",
+    [MANCHESTER] = "Manchester"
+};
+
+static const nfc_subCarrierKernel_t nfc_subCarrierKernels[] = {
+    [NONE] = nfc_subCarrier_NONE,
+    [OOK]  = nfc_subCarrier_OOK,
+    [BPSK] = nfc_subCarrier_BPSK
+};
+static const char* nfc_subCarrierNames[] = {
+    [NONE] = "No sub-carrier modulation",
+    [OOK]  = "Modulating data with on-off keying",
+    [BPSK] = "Modulating data with binary phase shift keying"
+};
+
 int nfc_encodeData(
     nfc_sigParam_t* sigParam,
     char** encodedData,
     size_t* encodedSize
 ) {
+    PROFILE_STAGE(PROF_ENCODE);
+
     //========== Variables declaration
     char* data                  = sigParam->data;
     size_t size                 = sigParam->dataSize;
@@ -55,119 +328,13 @@ int nfc_encodeData(
 
     //========== Allocate memory for the encoded data
     *encodedSize = 8 * 4 * size;
-    *encodedData = (char*)malloc(*encodedSize);
+    *encodedData = (char*)nfc_malloc(*encodedSize);
     assert(*encodedData, "Failed to allocate memory for the encoded data", -1);
 
     //========== Encode data
-    switch (encodingType) {
-        //----- Modified miller encoding
-        case MOD_MILLER:
-            PRINT(INFO, "Encoding data with modified miller encoding");
-            // Encode the first bit
-            if (data[0] & 0x01) {
-                (*encodedData)[0] = 0x01;
-                (*encodedData)[1] = 0x01;
-                (*encodedData)[2] = 0x00;
-                (*encodedData)[3] = 0x01;
-            }
-            // Arbitrarily encode the first bit as a 0 after 1
-            else {
-                (*encodedData)[0] = 0x01;
-                (*encodedData)[1] = 0x01;
-                (*encodedData)[2] = 0x01;
-                (*encodedData)[3] = 0x01;
-            }
-            for (int i = 0; (size_t)i < size; i=i+1) {
-                for (int j = 0; j < 8; j=j+1) {
-                    if (i != 0 || j != 0) {      // Skip the first bit, already encoded above
-                        // Bit at 1
-                        if ((data[i] >> j) & 0x01) {
-                            (*encodedData)[32*i+4*j  ] = 0x01;
-                            (*encodedData)[32*i+4*j+1] = 0x01;
-                            (*encodedData)[32*i+4*j+2] = 0x00;
-                            (*encodedData)[32*i+4*j+3] = 0x01;
-                        }
-                        // Bit at 0 after a 1
-                        else if (
-                            // Check the last bit of the previous byte
-                            (j == 0 && !((data[i] >> j) & 0x01) && (data[i-1] >> 7            )) ||
-                            // Check the previous bit of the current byte
-                            (j != 0 && !((data[i] >> j) & 0x01) && ((data[i]  >> (j-1)) & 0x01))
-                        ) {
-                            (*encodedData)[32*i+4*j  ] = 0x01;
-                            (*encodedData)[32*i+4*j+1] = 0x01;
-                            (*encodedData)[32*i+4*j+2] = 0x01;
-                            (*encodedData)[32*i+4*j+3] = 0x01;
-                        }
-                        // Bit at 0 after a 0
-                        else {
-                            (*encodedData)[32*i+4*j  ] = 0x00;
-                            (*encodedData)[32*i+4*j+1] = 0x01;
-                            (*encodedData)[32*i+4*j+2] = 0x01;
-                            (*encodedData)[32*i+4*j+3] = 0x01;
-                        }
-                    }
-                }
-            }
-        break;
-
-        //----- Non-return-to-zero encoding
-        case NRZ:
-            PRINT(INFO, "Encoding data with NRZ encoding");
-            for (int i = 0; (size_t)i < size; i=i+1) {
-                for (int j = 0; j < 8; j=j+1) {
-                    if ((data[i] >> j) & 0x01) {
-                        (*encodedData)[32*i+4*j  ] = 0x01;
-                        (*encodedData)[32*i+4*j+1] = 0x01;
-                        (*encodedData)[32*i+4*j+2] = 0x01;
-                        (*encodedData)[32*i+4*j+3] = 0x01;
-                    }
-                    else {
-                        (*encodedData)[32*i+4*j  ] = 0x00;
-                        (*encodedData)[32*i+4*j+1] = 0x00;
-                        (*encodedData)[32*i+4*j+2] = 0x00;
-                        (*encodedData)[32*i+4*j+3] = 0x00;
-                    }
-                }
-            }
-        break;
-
-        //----- Manchester encoding
-        case MANCHESTER:
-            PRINT(INFO, "Encoding data with Manchester encoding");
-            for (int i = 0; (size_t)i < size; i=i+1) {
-                for (int j = 0; j < 8; j=j+1) {
-                    if ((data[i] >> j) & 0x01) {
-                        (*encodedData)[32*i+4*j  ] = 0x00;
-                        (*encodedData)[32*i+4*j+1] = 0x00;
-                        (*encodedData)[32*i+4*j+2] = 0x01;
-                        (*encodedData)[32*i+4*j+3] = 0x01;
-                    }
-                    else {
-                        (*encodedData)[32*i+4*j  ] = 0x01;
-                        (*encodedData)[32*i+4*j+1] = 0x01;
-                        (*encodedData)[32*i+4*j+2] = 0x00;
-                        (*encodedData)[32*i+4*j+3] = 0x00;
-                    }
-                    // PRINT(
-                    //     DBG,
-                    //     "Encoded data: [%d]\t%d %d %d %d",
-                    //     32*i+4*j,
-                    //     (*encodedData)[32*i+4*j  ],
-                    //     (*encodedData)[32*i+4*j+1],
-                    //     (*encodedData)[32*i+4*j+2],
-                    //     (*encodedData)[32*i+4*j+3]
-                    // );
-                }
-            }
-        break;
-
-        //----- Default case
-        default:
-            PRINT(ERR, "Invalid encoding type");
-            return -1;
-        break;
-    }
+    PRINT(INFO, "Encoding data with %s encoding", nfc_encodingNames[encodingType]);
+    nfc_encodeKernels[encodingType](data, size, *encodedData);
+    PROFILE_COUNT(*encodedSize, *encodedSize);
 
     return 0;
 }
@@ -179,12 +346,12 @@ int nfc_modulateSubCarrier(
     char** subModulatedData,
     size_t* subModulatedSize
 ) {
+    PROFILE_STAGE(PROF_SUBCARRIER);
+
     //========== Variables declaration
     nfc_subModulation_t subModulation = sigParam->subModulation;
     unsigned int bitRate              = sigParam->bitRate;
     unsigned int subCarrierFreq       = sigParam->subCarrierFreq;
-    char isEven = 0;                             // Flag to know if the current
-                                                 // value in the sub-carrier has to be 0 or 1
 
     //========== Check arguments
     //----- Check input data
@@ -217,77 +384,42 @@ int nfc_modulateSubCarrier(
 
     // PRINT(DBG, "subModulatedSize: %ld", *subModulatedSize);
 
-    *subModulatedData = (char*)malloc(*subModulatedSize);
+    *subModulatedData = (char*)nfc_malloc(*subModulatedSize);
     assert(*subModulatedData, "Failed to allocate memory for the modulated data", -1);
 
     //========== Modulate data
-    switch (subModulation) {
-        //----- No sub-carrier modulation
-        case NONE:
-            PRINT(INFO, "No sub-carrier modulation");
-            for (int i = 0; (size_t)i < encodedSize; i=i+1) {
-                (*subModulatedData)[i] = encodeData[i];
-            }
-        break;
+    PRINT(INFO, "%s", nfc_subCarrierNames[subModulation]);
+    nfc_subCarrierKernels[subModulation](encodeData, encodedSize, subCarrierFreq / bitRate, *subModulatedData);
+    PROFILE_COUNT(*subModulatedSize, *subModulatedSize);
 
-        //----- On-off keying
-        case OOK:
-            PRINT(INFO, "Modulating data with on-off keying");
-            for (unsigned int i = 0; (size_t)i < encodedSize; i=i+1) {
-                // PRINT(
-                //     DBG,
-                //     "Encoded data: [%d]\t%d %d %d %d",
-                //     i,
-                //     encodeData[4*i],
-                //     encodeData[4*i+1],
-                //     encodeData[4*i+2],
-                //     encodeData[4*i+3]
-                // );
-                if (encodeData[i]) {
-                    for (unsigned int j = i*(subCarrierFreq/bitRate)/2; j < (i+1)*(subCarrierFreq/bitRate)/2; j=j+1) {
-                        // PRINT(DBG, "OOK: [%d]", j);
-                        (*subModulatedData)[j] = 0x01;
-                    }
-                }
-                else {
-                    isEven = 0;
-                    for (unsigned int j = i*(subCarrierFreq/bitRate)/2; j < (i+1)*(subCarrierFreq/bitRate)/2; j=j+1) {
-                        // PRINT(DBG, "OOK: [%d]", j);
-                        (*subModulatedData)[j] = isEven;
-                        isEven = !isEven;
-                    }
-                }
-            }
-        break;
+    return 0;
+}
 
-        //----- Binary phase shift keying
-        case BPSK:
-            PRINT(INFO, "Modulating data with binary phase shift keying");
-            for (unsigned int i = 0; (size_t)i < encodedSize; i=i+1) {
-                if (encodeData[i]) {
-                    isEven = 1;
-                    for (unsigned int j = i*(subCarrierFreq/bitRate)/2; j < (i+1)*(subCarrierFreq/bitRate)/2; j=j+1) {
-                        (*subModulatedData)[j] = isEven;
-                        isEven = !isEven;
-                    }
-                }
-                else {
-                    isEven = 0;
-                    for (unsigned int j = i*(subCarrierFreq/bitRate)/2; j < (i+1)*(subCarrierFreq/bitRate)/2; j=j+1) {
-                        (*subModulatedData)[j] = isEven;
-                        isEven = !isEven;
-                    }
-                }
-            }
-        break;
-        
-        //----- Default case
-        default:
-            assert(0, "Invalid sub-carrier modulation type", -1);
-        break;
-    }
+/**
+ * @brief Arguments shared by the chunks of the envelope generation
+ * 
+ */
+typedef struct {
+    cpu_envelope_t env;                          // Parameters of the envelope kernel
+    scatter_t      envelope;                     // Envelope to fill
+} nfc_envelopeTask_t;
 
-    return 0;
+/**
+ * @brief Generate the points [first, last) of the envelope.
+ *        The time of the points of the transition history is recomputed
+ *        instead of being read back, so the chunks are independent and the
+ *        result does not depend on how the envelope is split.
+ * 
+ * @param arg Arguments of the envelope generation (nfc_envelopeTask_t)
+ * @param first First point to generate
+ * @param last Point after the last one to generate
+ */
+static void nfc_envelopeChunk(void* arg, size_t first, size_t last) {
+    //========== Variables declaration
+    nfc_envelopeTask_t* task = (nfc_envelopeTask_t*)arg;
+
+    //========== Generate the envelope
+    cpu_kernels()->envelope(&task->env, task->envelope->points, first, last);
 }
 
 int nfc_createEnvelope(
@@ -296,6 +428,8 @@ int nfc_createEnvelope(
     nfc_sigParam_t* sigParam,
     scatter_t* envelope
 ) {
+    PROFILE_STAGE(PROF_ENVELOPE);
+
     //========== Variables declaration
     nfc_subModulation_t subModulation = sigParam->subModulation;
     unsigned int bitRate              = sigParam->bitRate;
@@ -310,8 +444,7 @@ int nfc_createEnvelope(
     unsigned int symboleDuration;                // Duration of a symbol in ns 
                                                  // from the subModulatedData
     unsigned int transTime;                      // Time of the transition between two states in points
-    unsigned int avgCounter;                     // Counter to calculate the local average of the envelope
-    size_t       subModDataAddr;                 // Address of the index of sub-modulated data
+    nfc_envelopeTask_t task;                     // Arguments of the envelope chunks
 
     //========== Check arguments
     assert(subModulatedData, "Sub-modulated data cannot be NULL", -1);
@@ -333,6 +466,9 @@ int nfc_createEnvelope(
     assert(subCarrierFreq || subModulation == NONE, "Sub-carrier frequency cannot be null", -1);
     assert(!(subCarrierFreq % bitRate), "Sub-carrier frequency should be a multiple of the bit rate", -1);
 
+    //----- Check carrier frequency
+    assert(carrierFreq, "Carrier frequency cannot be null", -1);
+
     //----- Check modulation index
     assert(modulationIndex <= 100, "Modulation index cannot be greater than 100", -1);
 
@@ -348,16 +484,11 @@ int nfc_createEnvelope(
 
     //========== Generate envelope
     //----- Calculate the duration of a symbol
-    // If there is no sub-carrier modulation, the duration of a symbol is the bit rate
-    if (subModulation == NONE)
-        symboleDuration = (unsigned int)1e9 / bitRate / 4;
-    // Otherwise, the duration of a symbol is the sub-carrier frequency
-    else
-        symboleDuration = (unsigned int)1e9 / subCarrierFreq / 2;
+    symboleDuration = nfc_symbolDuration(sigParam);
     PRINT(INFO, "Duration of a symbol: %d ns", symboleDuration);
     
     //----- Calculate the transition time (2 carrier periods)
-    transTime = (unsigned int)(2*1e9) / carrierFreq * numberOfPoints / simDuration;
+    transTime = nfc_transitionTime(sigParam);
     PRINT(INFO, "Transition time: %d ns", transTime);
 
     //----- Calculate the modulation depth
@@ -365,39 +496,61 @@ int nfc_createEnvelope(
     PRINT(INFO, "Modulation depth: %f", modulationDepth);
 
     //----- Generate the envelope
-    for (unsigned int i = 0; i < numberOfPoints; i=i+1) {
-        (*envelope)->points[i].x =    (int)((unsigned long long)i * 
-                                            (unsigned long long)simDuration / 
-                                            numberOfPoints);
-        (*envelope)->points[i].y = 0;
-        avgCounter = 0;
-        for (int j = (int)i-(int)transTime+1; j <= (int)i; j=j+1) {
-            if (j >= 0 && j < (int)numberOfPoints) {
-                subModDataAddr = (size_t)scatter_getX(*envelope, (size_t)j)/symboleDuration;
-                if (subModulatedData[
-                    // Required to avoid overflow when having rounding errors
-                    subModDataAddr >= subModulatedSize ?
-                        subModulatedSize-1 :
-                        subModDataAddr
-                ])
-                    (*envelope)->points[i].y = (*envelope)->points[i].y + 1;
-                else
-                    (*envelope)->points[i].y = (*envelope)->points[i].y + modulationDepth;
-                avgCounter = avgCounter + 1;
-            }
-        }
-        (*envelope)->points[i].y = (*envelope)->points[i].y / (double)avgCounter;
+    task.env.symbols        = subModulatedData;
+    task.env.nbSymbols      = subModulatedSize;
+    task.env.simDuration    = simDuration;
+    task.env.numberOfPoints = numberOfPoints;
+    task.env.symbolDuration = symboleDuration;
+    task.env.transTime      = transTime;
+    task.env.levels[0]      = modulationDepth;
+    task.env.levels[1]      = 1;
+    task.envelope           = *envelope;
+    if (parallel_for(numberOfPoints, MIN_POINTS_PER_THREAD, nfc_envelopeChunk, &task)) {
+        PRINT(ERR, "Failed to generate the envelope");
+        scatter_destroy(*envelope);
+        return -1;
     }
+    PROFILE_COUNT(numberOfPoints, numberOfPoints * sizeof(point_t));
+
     return 0;
 }
 
+/**
+ * @brief Arguments shared by the chunks of the modulation
+ * 
+ */
+typedef struct {
+    scatter_t    envelope;                       // Envelope to modulate
+    unsigned int carrierFreq;                    // Frequency of the carrier (Hz)
+    scatter_t    modulatedSignal;                // Modulated signal to fill
+} nfc_modulateTask_t;
+
+/**
+ * @brief Modulate the points [first, last) of the envelope
+ * 
+ * @param arg Arguments of the modulation (nfc_modulateTask_t)
+ * @param first First point to modulate
+ * @param last Point after the last one to modulate
+ */
+static void nfc_modulateChunk(void* arg, size_t first, size_t last) {
+    //========== Variables declaration
+    nfc_modulateTask_t* task = (nfc_modulateTask_t*)arg;
+
+    //========== Modulate signal
+    cpu_kernels()->carrier(
+        task->envelope->points + first,
+        task->modulatedSignal->points + first,
+        last - first,
+        task->carrierFreq
+    );
+}
+
 int nfc_modulate(
     scatter_t envelope,
     nfc_sigParam_t* sigParam,
     scatter_t* modulatedSignal
 ) {
-    //========== Variables declaration
-    unsigned int carrierFreq = sigParam->carrierFreq;
+    PROFILE_STAGE(PROF_MODULATE);
 
     //========== Check arguments
     assert(envelope, "Envelope cannot be NULL", -1);
@@ -405,8 +558,6 @@ int nfc_modulate(
         PRINT(ERR, "Enveloppe cannot be NULL or empty");
         return -1;
     }
-    assert(envelope->points, "Envelope cannot be NULL", -1);
-    assert(envelope->size, "Envelope size cannot be null", -1);
     
     //========== Allocate memory for the modulated signal
     assert(
@@ -416,37 +567,66 @@ int nfc_modulate(
     );
 
     //========== Modulate signal
-    for (int i = 0; (size_t)i < (*modulatedSignal)->size; i=i+1) {
-        (*modulatedSignal)->points[i].x =   envelope->points[i].x;
-        (*modulatedSignal)->points[i].y =   envelope->points[i].y * 
-                                            sin(
-                                                (double)2 *
-                                                (double)M_PI *
-                                                (double)carrierFreq *
-                                                (double)(envelope->points[i].x) / (double)1e9
-                                            );
+    if (nfc_modulateInto(envelope, sigParam, *modulatedSignal)) {
+        scatter_destroy(*modulatedSignal);
+        return -1;
     }
 
     return 0;
 }
 
+int nfc_modulateInto(
+    scatter_t envelope,
+    nfc_sigParam_t* sigParam,
+    scatter_t modulatedSignal
+) {
+    PROFILE_STAGE(PROF_MODULATE);
+
+    //========== Variables declaration
+    nfc_modulateTask_t task;                     // Arguments of the modulation chunks
+
+    //========== Check arguments
+    assert(envelope, "Envelope cannot be NULL", -1);
+    assert(envelope->points, "Envelope cannot be NULL", -1);
+    assert(envelope->size, "Envelope size cannot be null", -1);
+    assert(modulatedSignal && modulatedSignal->points, "Modulated signal cannot be NULL", -1);
+    assert(
+        modulatedSignal->size == envelope->size,
+        "Modulated signal should have the size of the envelope",
+        -1
+    );
+
+    //========== Modulate signal
+    // Each point only depends on the same point of the envelope, so both
+    // clouds of points can be the same
+    task.envelope        = envelope;
+    task.carrierFreq     = sigParam->carrierFreq;
+    task.modulatedSignal = modulatedSignal;
+    assert(
+        !parallel_for(modulatedSignal->size, MIN_POINTS_PER_THREAD, nfc_modulateChunk, &task),
+        "Failed to modulate the signal",
+        -1
+    );
+    PROFILE_COUNT(modulatedSignal->size, modulatedSignal->size * sizeof(point_t));
+
+    return 0;
+}
+
+int nfc_modulateInPlace(scatter_t signal, nfc_sigParam_t* sigParam) {
+    return nfc_modulateInto(signal, sigParam, signal);
+}
+
 int nfc_addNoise(
     scatter_t signal,
     nfc_sigParam_t* sigParam,
     scatter_t* noisySignal
 ) {
-    //========== Variables declaration
-    double noiseLevel = sigParam->noiseLevel;
+    PROFILE_STAGE(PROF_NOISE);
 
     //========== Check arguments
     assert(signal, "Signal cannot be NULL", -1);
     assert(signal->points, "Signal cannot be NULL", -1);
     assert(signal->size, "Signal size cannot be null", -1);
-    assert(
-        noiseLevel >= 0 && noiseLevel <= 1,
-        "Noise level should be between 0 and 1",
-        -1
-    );
 
     //========== Allocate memory for the noisy signal
     if (scatter_create(noisySignal, signal->size)) {
@@ -455,14 +635,56 @@ int nfc_addNoise(
     }
 
     //========== Add noise
-    for (unsigned int i = 0; i < (*noisySignal)->size; i=i+1) {
-        (*noisySignal)->points[i].x = signal->points[i].x;
-        (*noisySignal)->points[i].y = signal->points[i].y + noiseLevel * ((double)rand() / (double)RAND_MAX - 0.5);
+    if (nfc_addNoiseInto(signal, sigParam, *noisySignal)) {
+        scatter_destroy(*noisySignal);
+        return -1;
     }
 
     return 0;
 }
 
+int nfc_addNoiseInto(
+    scatter_t signal,
+    nfc_sigParam_t* sigParam,
+    scatter_t noisySignal
+) {
+    PROFILE_STAGE(PROF_NOISE);
+
+    //========== Variables declaration
+    double noiseLevel     = sigParam->noiseLevel;
+    nfc_context_t context = nfc_contextGet();    // Context holding the random generator
+
+    //========== Check arguments
+    assert(signal, "Signal cannot be NULL", -1);
+    assert(signal->points, "Signal cannot be NULL", -1);
+    assert(signal->size, "Signal size cannot be null", -1);
+    assert(noisySignal && noisySignal->points, "Noisy signal cannot be NULL", -1);
+    assert(
+        noisySignal->size == signal->size,
+        "Noisy signal should have the size of the signal",
+        -1
+    );
+    assert(
+        noiseLevel >= 0 && noiseLevel <= 1,
+        "Noise level should be between 0 and 1",
+        -1
+    );
+
+    //========== Add noise
+    // Same values as drawing them one by one with nfc_contextRandom()
+    cpu_kernels()->noise(
+        signal->points, noisySignal->points, noisySignal->size, noiseLevel, context->seed,
+        nfc_contextDraw(context, noisySignal->size)
+    );
+    PROFILE_COUNT(noisySignal->size, noisySignal->size * sizeof(point_t));
+
+    return 0;
+}
+
+int nfc_addNoiseInPlace(scatter_t signal, nfc_sigParam_t* sigParam) {
+    return nfc_addNoiseInto(signal, sigParam, signal);
+}
+
 int nfc_createSignal(
     nfc_sigParam_t* sigParam,
     scatter_t* signal
@@ -472,8 +694,8 @@ int nfc_createSignal(
     size_t         encodedSize      = 0;         // Size of the encoded data
     char*          subModulatedData = NULL;      // Sub-carrier modulated data
     size_t         subModulatedSize = 0;         // Size of the sub-carrier modulated data
-    scatter_t      envelope         = NULL;      // Envelope of the signal
-    scatter_t      modulatedSignal  = NULL;      // Modulated signal
+    scatter_t      envelope         = NULL;      // Envelope of the signal, then
+                                                 // modulated and noisy signal
 
     //========== Check arguments
     /* Inch no need, already done in sub-functions */
@@ -517,7 +739,7 @@ int nfc_createSignal(
         &subModulatedData, &subModulatedSize
     )) {
         PRINT(ERR, "Failed to modulate data with sub-carrier");
-        free(encodedData);
+        nfc_free(encodedData);
         return -1;
     }
 
@@ -532,23 +754,22 @@ int nfc_createSignal(
         &envelope
     )) {
         PRINT(ERR, "Failed to generate envelope");
-        free(encodedData);
-        free(subModulatedData);
+        nfc_free(encodedData);
+        nfc_free(subModulatedData);
         return -1;
     }
 
+    // The symbols are not needed anymore
+    nfc_free(encodedData);
+    nfc_free(subModulatedData);
+
     // PRINT(DBG, "===== ENVELOPE =====");
     // scatter_print(*envelope, '\t', DBG);
 
     //========== Modulate signal
-    if (nfc_modulate(
-        envelope, 
-        sigParam,
-        sigParam->noiseLevel ? &modulatedSignal : signal
-    )) {
+    // The envelope buffer is reused by the following stages
+    if (nfc_modulateInPlace(envelope, sigParam)) {
         PRINT(ERR, "Failed to modulate signal");
-        free(encodedData);
-        free(subModulatedData);
         scatter_destroy(envelope);
         return -1;
     }
@@ -557,39 +778,21 @@ int nfc_createSignal(
     // scatter_print(*modulatedSignal, '\t', DBG);
 
     //========== Add noise
-    if (!sigParam->noiseLevel) {
+    if (!sigParam->noiseLevel)
         PRINT(INFO, "Skipping noise addition");
-        free(encodedData);
-        free(subModulatedData);
-        scatter_destroy(envelope);
-        PRINT(SUCC, "Signal successfully generated");
-        return 0;
-    }
-
-    if (nfc_addNoise(
-        modulatedSignal,
-        sigParam,
-        signal
-    )) {
+    else if (nfc_addNoiseInPlace(envelope, sigParam)) {
         PRINT(ERR, "Failed to add noise to the signal");
-        free(encodedData);
-        free(subModulatedData);
         scatter_destroy(envelope);
-        scatter_destroy(modulatedSignal);
         return -1;
     }
 
-    //========== Free memory
-    free(encodedData);
-    free(subModulatedData);
-    scatter_destroy(envelope);
-    scatter_destroy(modulatedSignal);
+    *signal = envelope;
 
     PRINT(SUCC, "Signal successfully generated");
     return 0;
 }
 
-int nfc_standardSignal(
+int nfc_standardParam(
     char* data,
     size_t size,
     nfc_standard_t standard,
@@ -597,11 +800,8 @@ int nfc_standardSignal(
     unsigned int bitRate,
     double noiseLevel,
     unsigned int numberOfPoints,
-    scatter_t* signal
+    nfc_sigParam_t* sigParam
 ) {
-    //========== Variables declaration
-    nfc_sigParam_t sigParam;                     // Parameters of the signal
-
     //========== Check arguments
     assert(standard == NFC_A || standard == NFC_B, "Invalid NFC standard", -1);
     assert(dataTransm == PCD || dataTransm == PICC, "Invalid data transmission mode", -1);
@@ -613,12 +813,12 @@ int nfc_standardSignal(
         );
 
     //========== Prepare parameters
-    sigParam.data            = data;
-    sigParam.dataSize        = size;
-    sigParam.bitRate         = bitRate;
-    sigParam.carrierFreq     = CARRIER_FREQ;
-    sigParam.noiseLevel      = noiseLevel;
-    sigParam.numberOfPoints  = numberOfPoints;
+    sigParam->data            = data;
+    sigParam->dataSize        = size;
+    sigParam->bitRate         = bitRate;
+    sigParam->carrierFreq     = CARRIER_FREQ;
+    sigParam->noiseLevel      = noiseLevel;
+    sigParam->numberOfPoints  = numberOfPoints;
 
     switch (standard) {
         //----- NFC-A standard
@@ -628,19 +828,19 @@ int nfc_standardSignal(
                 //----- Proximity Coupling Device
                 case PCD:
                     PRINT(INFO, "PCD data transmitter");
-                    sigParam.encodingType    = MOD_MILLER;
-                    sigParam.subModulation   = NONE;
-                    sigParam.subCarrierFreq  = 0;
-                    sigParam.modulationIndex = 100;
+                    sigParam->encodingType    = MOD_MILLER;
+                    sigParam->subModulation   = NONE;
+                    sigParam->subCarrierFreq  = 0;
+                    sigParam->modulationIndex = 100;
                 break;
 
                 //----- Proximity Integrated Circuit Card
                 case PICC:
                     PRINT(INFO, "PICC data transmitter");
-                    sigParam.encodingType    = MANCHESTER;
-                    sigParam.subModulation   = OOK;
-                    sigParam.subCarrierFreq  = SUB_CARRIER_FREQ;
-                    sigParam.modulationIndex = 10;
+                    sigParam->encodingType    = MANCHESTER;
+                    sigParam->subModulation   = OOK;
+                    sigParam->subCarrierFreq  = SUB_CARRIER_FREQ;
+                    sigParam->modulationIndex = 10;
                 break;
 
                 //----- Default case
@@ -657,19 +857,19 @@ int nfc_standardSignal(
                 //----- Proximity Coupling Device
                 case PCD:
                     PRINT(INFO, "PCD data transmitter");
-                    sigParam.encodingType    = NRZ;
-                    sigParam.subModulation   = NONE;
-                    sigParam.subCarrierFreq  = 0;
-                    sigParam.modulationIndex = 10;
+                    sigParam->encodingType    = NRZ;
+                    sigParam->subModulation   = NONE;
+                    sigParam->subCarrierFreq  = 0;
+                    sigParam->modulationIndex = 10;
                 break;
 
                 //----- Proximity Integrated Circuit Card
                 case PICC:
                     PRINT(INFO, "PICC data transmitter");
-                    sigParam.encodingType    = NRZ;
-                    sigParam.subModulation   = BPSK;
-                    sigParam.subCarrierFreq  = SUB_CARRIER_FREQ;
-                    sigParam.modulationIndex = 10;
+                    sigParam->encodingType    = NRZ;
+                    sigParam->subModulation   = BPSK;
+                    sigParam->subCarrierFreq  = SUB_CARRIER_FREQ;
+                    sigParam->modulationIndex = 10;
                 break;
 
                 //----- Default case
@@ -681,11 +881,34 @@ int nfc_standardSignal(
     }
 
     assert(
-        !nfc_autoSimTime(&sigParam),
+        !nfc_autoSimTime(sigParam),
         "Failed to automatically calculate the simulation time",
         -1
     );
 
+    return 0;
+}
+
+int nfc_standardSignal(
+    char* data,
+    size_t size,
+    nfc_standard_t standard,
+    nfc_dataTransm_t dataTransm,
+    unsigned int bitRate,
+    double noiseLevel,
+    unsigned int numberOfPoints,
+    scatter_t* signal
+) {
+    //========== Variables declaration
+    nfc_sigParam_t sigParam;                     // Parameters of the signal
+
+    //========== Prepare parameters
+    assert(
+        !nfc_standardParam(data, size, standard, dataTransm, bitRate, noiseLevel, numberOfPoints, &sigParam),
+        "Failed to prepare the parameters of the standard signal",
+        -1
+    );
+
     //========== Generate signal
     assert(
         !nfc_createSignal(&sigParam, signal),
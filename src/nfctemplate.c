@@ -0,0 +1,209 @@
+/**
+ * @file nfctemplate.c
+ * @author OUSSET Gaël
+ * @brief Synthesis of NFC envelopes from precomputed transition ramps
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "nfctemplate.h"
+#include "logging.h"
+#include "assert.h"
+#include "context.h"
+#include <stdlib.h>
+
+/**
+ * @brief Return the level of the envelope at the point j, the same way as
+ *        nfc_createEnvelope() does
+ * 
+ * @param tpl Templates
+ * @param sigParam Parameters of the signal (with the data)
+ * @param j Index of the point
+ * @return double - Level of the symbol of the point
+ */
+static double nfc_templateLevel(nfc_template_t tpl, nfc_sigParam_t* sigParam, size_t j) {
+    //========== Variables declaration
+    int    x = (int)((unsigned long long)j * sigParam->simDuration / sigParam->numberOfPoints);
+    size_t symbol = (size_t)x / tpl->symbolDuration;
+
+    // Required to avoid overflow when having rounding errors
+    if (symbol >= tpl->nbSymbols)
+        symbol = tpl->nbSymbols - 1;
+    return tpl->levels[(int)nfc_subModulatedSymbol(sigParam, symbol)];
+}
+
+/**
+ * @brief Average the window of the point i level by level. Used for the
+ *        first points, whose window is not full, and for the windows
+ *        covering more than two runs of symbols.
+ * 
+ * @param tpl Templates
+ * @param sigParam Parameters of the signal (with the data)
+ * @param i Index of the point
+ * @return double - Level of the envelope
+ */
+static double nfc_templatePoint(nfc_template_t tpl, nfc_sigParam_t* sigParam, size_t i) {
+    //========== Variables declaration
+    double       y          = 0;                 // Sum of the levels of the window
+    unsigned int avgCounter = 0;                 // Number of points of the window
+
+    for (size_t j = i + 1 > tpl->transTime ? i + 1 - tpl->transTime : 0; j <= i; j=j+1) {
+        y          = y + nfc_templateLevel(tpl, sigParam, j);
+        avgCounter = avgCounter + 1;
+    }
+
+    return y / (double)avgCounter;
+}
+
+int nfc_templateCreate(nfc_sigParam_t* sigParam, nfc_template_t* tpl) {
+    //========== Variables declaration
+    double* ramp;                                // Ramp being computed
+
+    //========== Check arguments
+    assert(!nfc_checkParam(sigParam), "Invalid signal parameters", -1);
+    assert(sigParam->simDuration, "Simulation duration cannot be null", -1);
+
+    //========== Allocate memory
+    *tpl = nfc_malloc(sizeof(**tpl));
+    assert(*tpl, "Failed to allocate memory for the templates", -1);
+
+    (*tpl)->sigParam       = *sigParam;
+    (*tpl)->sigParam.data  = NULL;
+    (*tpl)->nbSymbols      = nfc_subModulatedSize(sigParam);
+    (*tpl)->symbolDuration = nfc_symbolDuration(sigParam);
+    (*tpl)->transTime      = nfc_transitionTime(sigParam);
+    (*tpl)->levels[0]      = (double)(100 - sigParam->modulationIndex) /
+                             (double)(sigParam->modulationIndex + 100);
+    (*tpl)->levels[1]      = 1;
+    if (!(*tpl)->nbSymbols || !(*tpl)->symbolDuration || !(*tpl)->transTime) {
+        PRINT(ERR, "Templates require symbols and a transition of at least one point");
+        nfc_free(*tpl);
+        return -1;
+    }
+
+    (*tpl)->ramps = nfc_malloc(2 * ((*tpl)->transTime + 1) * sizeof(double));
+    if (!(*tpl)->ramps) {
+        PRINT(ERR, "Failed to allocate memory for the ramps");
+        nfc_free(*tpl);
+        return -1;
+    }
+
+    //========== Compute the ramps
+    // Summed from the oldest point of the window, as the envelope kernels
+    for (unsigned int level = 0; level < 2; level=level+1) {
+        ramp = (*tpl)->ramps + level * ((*tpl)->transTime + 1);
+        for (unsigned int c = 0; c <= (*tpl)->transTime; c=c+1) {
+            ramp[c] = 0;
+            for (unsigned int k = 0; k < (*tpl)->transTime; k=k+1)
+                ramp[c] = ramp[c] + (*tpl)->levels[k < c ? !level : level];
+            ramp[c] = ramp[c] / (double)(*tpl)->transTime;
+        }
+    }
+
+    PRINT(INFO, "Ramps of %d points computed for %ld symbols", (*tpl)->transTime, (*tpl)->nbSymbols);
+    return 0;
+}
+
+void nfc_templateDestroy(nfc_template_t tpl) {
+    nfc_free(tpl->ramps);
+    nfc_free(tpl);
+}
+
+int nfc_templateSignal(nfc_template_t tpl, nfc_sigParam_t* sigParam, scatter_t* signal) {
+    //========== Variables declaration
+    point_t*     points;                         // Points of the signal
+    unsigned int transTime;                      // Transition time (points)
+    size_t       symbol    = 0;                  // Sub-modulated symbol of the point
+    char         value;                          // Value of the symbol
+    size_t       runStart  = 0;                  // First point of the run of the point
+    size_t       prevStart = 0;                  // First point of the previous run
+    size_t       start;                          // First point of the window of the point
+    size_t       symbolIdx;                      // Symbol of the point, before the run check
+    int          x;                              // Time of the point (ns)
+
+    //========== Check arguments
+    assert(tpl, "Templates cannot be NULL", -1);
+    assert(sigParam && sigParam->data, "Input data cannot be NULL", -1);
+    assert(
+        sigParam->dataSize        == tpl->sigParam.dataSize        &&
+        sigParam->encodingType    == tpl->sigParam.encodingType    &&
+        sigParam->subModulation   == tpl->sigParam.subModulation   &&
+        sigParam->bitRate         == tpl->sigParam.bitRate         &&
+        sigParam->subCarrierFreq  == tpl->sigParam.subCarrierFreq  &&
+        sigParam->carrierFreq     == tpl->sigParam.carrierFreq     &&
+        sigParam->modulationIndex == tpl->sigParam.modulationIndex &&
+        sigParam->simDuration     == tpl->sigParam.simDuration     &&
+        sigParam->numberOfPoints  == tpl->sigParam.numberOfPoints,
+        "Templates were built for other parameters",
+        -1
+    );
+    assert(
+        sigParam->noiseLevel >= 0 && sigParam->noiseLevel <= 1,
+        "Noise level should be between 0 and 1",
+        -1
+    );
+
+    //========== Allocate memory for the signal
+    assert(
+        !scatter_create(signal, sigParam->numberOfPoints),
+        "Failed to allocate memory for the signal",
+        -1
+    );
+
+    //========== Generate the envelope
+    // A run starts at each point whose symbol value differs from the one of
+    // the previous point. A full window starting in the run of the point
+    // is flat, one starting in the previous run is on the ramp.
+    points    = (*signal)->points;
+    transTime = tpl->transTime;
+    value     = nfc_subModulatedSymbol(sigParam, 0);
+    for (size_t i = 0; i < sigParam->numberOfPoints; i=i+1) {
+        x = (int)((unsigned long long)i * sigParam->simDuration / sigParam->numberOfPoints);
+
+        //----- Symbol of the point
+        symbolIdx = (size_t)x / tpl->symbolDuration;
+        if (symbolIdx >= tpl->nbSymbols)
+            symbolIdx = tpl->nbSymbols - 1;
+        if (symbolIdx != symbol) {
+            symbol = symbolIdx;
+            if (nfc_subModulatedSymbol(sigParam, symbol) != value) {
+                value     = !value;
+                prevStart = runStart;
+                runStart  = i;
+            }
+        }
+
+        //----- Level of the point
+        points[i].x = x;
+        if (i + 1 < transTime) {
+            points[i].y = nfc_templatePoint(tpl, sigParam, i);
+            continue;
+        }
+        start = i + 1 - transTime;
+        if (start >= runStart)
+            points[i].y = tpl->ramps[(unsigned int)value * (transTime + 1)];
+        else if (start >= prevStart)
+            points[i].y = tpl->ramps[(unsigned int)value * (transTime + 1) + runStart - start];
+        else
+            points[i].y = nfc_templatePoint(tpl, sigParam, i);
+    }
+
+    //========== Modulate signal
+    if (nfc_modulateInPlace(*signal, sigParam)) {
+        PRINT(ERR, "Failed to modulate signal");
+        scatter_destroy(*signal);
+        return -1;
+    }
+
+    //========== Add noise
+    if (sigParam->noiseLevel && nfc_addNoiseInPlace(*signal, sigParam)) {
+        PRINT(ERR, "Failed to add noise to the signal");
+        scatter_destroy(*signal);
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file parallel.c
+ * @author OUSSET Gaël
+ * @brief Split a loop into chunks processed by several threads
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "parallel.h"
+#include "logging.h"
+#include "assert.h"
+#include "context.h"
+#include "trace.h"
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * @brief Chunk given to a thread
+ * 
+ */
+typedef struct {
+    parallel_task_t task;                        // Task to apply
+    void*           arg;                         // Argument of the task
+    size_t          first;                       // First index of the chunk
+    size_t          last;                        // Index after the last one
+    nfc_context_t   context;                     // Context of the caller, shared by the chunks
+    prof_stage_t    stage;                       // Stage of the caller, run by the chunks
+} parallel_chunk_t;
+
+/**
+ * @brief Number of chunks being run by the calling thread, the loops
+ *        nested in a chunk run on the thread of the chunk
+ * 
+ */
+static _Thread_local unsigned int parallel_depth = 0;
+
+/**
+ * @brief Number of threads forced by parallel_setNbThreads(), 0 if none
+ * 
+ */
+static unsigned int parallel_forced = 0;
+
+/**
+ * @brief Run the task on a chunk in the context of the caller
+ * 
+ * @param c Chunk to process
+ */
+static void parallel_run(parallel_chunk_t* c) {
+    parallel_depth = parallel_depth + 1;
+    c->task(c->arg, c->first, c->last);
+    parallel_depth = parallel_depth - 1;
+}
+
+/**
+ * @brief Thread entry point, run the task on a chunk sharing the context
+ *        of the caller
+ * 
+ * @param chunk Chunk to process
+ * @return void* - NULL
+ */
+static void* parallel_worker(void* chunk) {
+    parallel_chunk_t* c = (parallel_chunk_t*)chunk;
+
+    nfc_contextShare(c->context);
+    nfc_contextSetStage(c->stage);
+    trace_begin("parallel_worker", "parallel");
+    parallel_run(c);
+    trace_end("parallel_worker", "parallel");
+    nfc_contextBind(NULL);
+    return NULL;
+}
+
+unsigned int parallel_nbThreads(void) {
+    //========== Variables declaration
+    long nbCores;                                // Number of online cores
+
+    if (parallel_forced)
+        return parallel_forced;
+    if (NB_THREADS > 0)
+        return NB_THREADS;
+
+    nbCores = sysconf(_SC_NPROCESSORS_ONLN);
+    return nbCores > 0 ? (unsigned int)nbCores : 1;
+}
+
+void parallel_setNbThreads(unsigned int nbThreads) {
+    parallel_forced = nbThreads;
+}
+
+int parallel_for(size_t size, size_t minChunk, parallel_task_t task, void* arg) {
+    //========== Variables declaration
+    size_t            nbChunks;                  // Number of chunks
+    parallel_chunk_t* chunks;                    // Chunks to process
+    pthread_t*        threads;                   // Threads of the chunks 1..nbChunks-1
+    size_t            nbStarted;                 // Number of started threads
+
+    //========== Check arguments
+    assert(task, "Task cannot be NULL", -1);
+    if (!size)
+        return 0;
+
+    //========== Choose the number of chunks
+    nbChunks = parallel_nbThreads();
+    if (minChunk && size / minChunk < nbChunks)
+        nbChunks = size / minChunk;
+    // The cores are already busy with the chunks of the outer loop
+    if (parallel_depth)
+        nbChunks = 1;
+    if (nbChunks <= 1) {
+        task(arg, 0, size);
+        return 0;
+    }
+
+    //========== Allocate memory
+    chunks  = nfc_malloc(nbChunks * sizeof(*chunks));
+    threads = nfc_malloc(nbChunks * sizeof(*threads));
+    if (!chunks || !threads) {
+        PRINT(WARN, "Failed to allocate memory for the threads, running on a single thread");
+        nfc_free(chunks);
+        nfc_free(threads);
+        task(arg, 0, size);
+        return 0;
+    }
+
+    //========== Split the loop
+    for (size_t i = 0; i < nbChunks; i=i+1) {
+        chunks[i].task  = task;
+        chunks[i].arg   = arg;
+        chunks[i].first   = size * i / nbChunks;
+        chunks[i].last    = size * (i+1) / nbChunks;
+        chunks[i].context = nfc_contextGet();
+        chunks[i].stage   = nfc_contextStage();
+    }
+
+    //========== Run the chunks
+    nbStarted = 1;
+    for (size_t i = 1; i < nbChunks; i=i+1) {
+        if (pthread_create(&threads[i], NULL, parallel_worker, &chunks[i]))
+            break;
+        nbStarted = nbStarted + 1;
+    }
+    // Chunks for which no thread could be created are run by the caller
+    trace_begin("parallel_worker", "parallel");
+    for (size_t i = nbStarted; i < nbChunks; i=i+1)
+        parallel_run(&chunks[i]);
+    parallel_run(&chunks[0]);
+    trace_end("parallel_worker", "parallel");
+
+    trace_begin("parallel_join", "parallel");
+    for (size_t i = 1; i < nbStarted; i=i+1)
+        pthread_join(threads[i], NULL);
+    trace_end("parallel_join", "parallel");
+
+    nfc_free(chunks);
+    nfc_free(threads);
+    return 0;
+}
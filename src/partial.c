@@ -0,0 +1,589 @@
+/**
+ * @file partial.c
+ * @author OUSSET Gaël
+ * @brief Partial results of the shards of a run
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "partial.h"
+#include "logging.h"
+#include "assert.h"
+#include "context.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Mask of the bits of a limb of an exact sum
+ */
+#define PARTIAL_LIMB_MASK 0xFFFFFFFFLL
+
+/**
+ * @brief Names of the kinds of entries in the files
+ * 
+ */
+static const char* partial_kindNames[NB_PARTIAL_KINDS] = {
+    [PARTIAL_COUNTS] = "counts",
+    [PARTIAL_SUMS]   = "sums",
+    [PARTIAL_VALUES] = "values",
+    [PARTIAL_ROWS]   = "rows"
+};
+
+//========== Shards
+int shard_parse(const char* text, shard_t* shard) {
+    //========== Variables declaration
+    int length = 0;                              // Number of parsed characters
+
+    //========== Check arguments
+    assert(text, "Shard cannot be NULL", -1);
+
+    if (sscanf(text, "%u/%u%n", &shard->index, &shard->count, &length) != 2 || text[length]) {
+        PRINT(ERR, "Invalid shard \"%s\", expected i/N", text);
+        return -1;
+    }
+    assert(shard->index < shard->count, "Shard %u/%u out of range, i goes from 0 to N-1", -1, shard->index, shard->count);
+
+    return 0;
+}
+
+void shard_range(const shard_t* shard, size_t size, size_t* first, size_t* last) {
+    *first = size * shard->index / shard->count;
+    *last  = size * (shard->index + 1) / shard->count;
+}
+
+//========== Exact sums
+/**
+ * @brief Propagate the carries of an exact sum
+ * 
+ * @param sum Exact sum
+ */
+static void partial_sumCarry(partial_sum_t* sum) {
+    //========== Variables declaration
+    int64_t low;                                 // Bits of a limb below 2^32
+
+    for (size_t i = 0; i + 1 < PARTIAL_SUM_LIMBS; i=i+1) {
+        low             = sum->limbs[i] & PARTIAL_LIMB_MASK;
+        sum->limbs[i+1] = sum->limbs[i+1] + (sum->limbs[i] - low) / (PARTIAL_LIMB_MASK + 1);
+        sum->limbs[i]   = low;
+    }
+    sum->pending = 0;
+}
+
+int partial_sumAdd(partial_sum_t* sum, double value) {
+    //========== Variables declaration
+    int      exponent;                           // Exponent of the value
+    uint64_t mantissa;                           // Mantissa of the value, as an integer
+    uint64_t low;                                // Low 32 bits of the mantissa, shifted
+    uint64_t high;                               // High bits of the mantissa, shifted
+    size_t   limb;                               // Limb of the lowest bit of the mantissa
+    int64_t  sign;                               // Sign of the value
+
+    if (!isfinite(value))
+        return -1;
+    if (value == 0)
+        return 0;
+
+    //========== Value = mantissa * 2^exponent, exponent >= -1074
+    sign     = value < 0 ? -1 : 1;
+    mantissa = (uint64_t)ldexp(frexp(fabs(value), &exponent), 53);
+    exponent = exponent - 53;
+    // The dropped bits of the subnormals are zeros
+    while (exponent < -1074) {
+        mantissa = mantissa >> 1;
+        exponent = exponent + 1;
+    }
+
+    //========== Add the mantissa to the limbs
+    limb = (size_t)(exponent + 1074) / 32;
+    low  = (mantissa & PARTIAL_LIMB_MASK) << ((exponent + 1074) % 32);
+    high = (mantissa >> 32) << ((exponent + 1074) % 32);
+    sum->limbs[limb]   = sum->limbs[limb]   + sign * (int64_t)(low & PARTIAL_LIMB_MASK);
+    sum->limbs[limb+1] = sum->limbs[limb+1] + sign * (int64_t)((low >> 32) + (high & PARTIAL_LIMB_MASK));
+    sum->limbs[limb+2] = sum->limbs[limb+2] + sign * (int64_t)(high >> 32);
+
+    sum->pending = sum->pending + 1;
+    if (sum->pending == PARTIAL_SUM_PENDING)
+        partial_sumCarry(sum);
+
+    return 0;
+}
+
+double partial_sumValue(partial_sum_t* sum) {
+    //========== Variables declaration
+    partial_sum_t magnitude;                     // Absolute value of the sum
+    double        value = 0;                     // Value of the sum
+    double        sign  = 1;                     // Sign of the sum
+
+    //========== Negative sums are in two's complement, their high limbs are full
+    partial_sumCarry(sum);
+    magnitude = *sum;
+    if (sum->limbs[PARTIAL_SUM_LIMBS-1] < 0) {
+        sign = -1;
+        for (size_t i = 0; i < PARTIAL_SUM_LIMBS; i=i+1)
+            magnitude.limbs[i] = -magnitude.limbs[i];
+        partial_sumCarry(&magnitude);
+    }
+
+    for (size_t i = PARTIAL_SUM_LIMBS; i > 0; i=i-1)
+        if (magnitude.limbs[i-1])
+            value = value + ldexp((double)magnitude.limbs[i-1], 32 * (int)(i-1) - 1074);
+
+    return sign * value;
+}
+
+//========== Partial results
+int partial_create(const char* tool, const char* config, const shard_t* shard, partial_t* partial) {
+    //========== Check arguments
+    assert(tool && config && shard, "Tool, configuration and shard cannot be NULL", -1);
+    assert(shard->index < shard->count, "Shard %u/%u out of range", -1, shard->index, shard->count);
+    assert(!strpbrk(tool, " \t\n") && tool[0], "The name of the tool cannot be empty or hold spaces", -1);
+    assert(!strchr(config, '\n'), "The configuration cannot hold line breaks", -1);
+    assert(strlen(tool) < PARTIAL_MAX_NAME && strlen(config) < PARTIAL_MAX_NAME, "Configuration too long", -1);
+
+    //========== Allocate the results
+    *partial = nfc_calloc(1, sizeof(**partial));
+    assert(*partial, "Failed to allocate memory for the partial results", -1);
+    (*partial)->tool     = nfc_malloc(strlen(tool) + 1);
+    (*partial)->config   = nfc_malloc(strlen(config) + 1);
+    (*partial)->shards   = nfc_calloc(shard->count, 1);
+    (*partial)->nbShards = shard->count;
+    if (!(*partial)->tool || !(*partial)->config || !(*partial)->shards) {
+        PRINT(ERR, "Failed to allocate memory for the partial results");
+        partial_destroy(*partial);
+        return -1;
+    }
+    strcpy((*partial)->tool, tool);
+    strcpy((*partial)->config, config);
+    (*partial)->shards[shard->index] = 1;
+
+    return 0;
+}
+
+void partial_destroy(partial_t partial) {
+    for (size_t e = 0; e < partial->nbEntries; e=e+1) {
+        nfc_free(partial->entries[e].name);
+        nfc_free(partial->entries[e].counts);
+        nfc_free(partial->entries[e].sums);
+        nfc_free(partial->entries[e].values);
+        for (size_t c = 0; partial->entries[e].columns && c < partial->entries[e].size; c=c+1)
+            nfc_free(partial->entries[e].columns[c]);
+        nfc_free(partial->entries[e].columns);
+    }
+    nfc_free(partial->entries);
+    nfc_free(partial->tool);
+    nfc_free(partial->config);
+    nfc_free(partial->shards);
+    nfc_free(partial);
+}
+
+partial_entry_t* partial_find(partial_t partial, const char* name) {
+    for (size_t e = 0; e < partial->nbEntries; e=e+1)
+        if (!strcmp(partial->entries[e].name, name))
+            return &partial->entries[e];
+    return NULL;
+}
+
+int partial_entry(partial_t partial, const char* name, partial_kind_t kind, size_t size, partial_entry_t** entry) {
+    //========== Variables declaration
+    partial_entry_t* grown;                      // Grown array of the entries
+    partial_entry_t* e;                          // New entry
+
+    //========== Check arguments
+    assert(partial && name, "Results and name cannot be NULL", -1);
+    assert(kind < NB_PARTIAL_KINDS, "Invalid kind of entry", -1);
+    assert(name[0] && !strpbrk(name, " \t\n") && strlen(name) < PARTIAL_MAX_NAME, "Invalid name of entry \"%s\"", -1, name);
+
+    //========== Existing entry
+    *entry = partial_find(partial, name);
+    if (*entry) {
+        assert(
+            (*entry)->kind == kind && (*entry)->size == size,
+            "Entry %s already exists with another kind or size", -1, name
+        );
+        return 0;
+    }
+
+    //========== New entry
+    grown = nfc_realloc(partial->entries, (partial->nbEntries + 1) * sizeof(*grown));
+    assert(grown, "Failed to allocate memory for the entries", -1);
+    partial->entries = grown;
+    e                = &partial->entries[partial->nbEntries];
+    memset(e, 0, sizeof(*e));
+    e->kind = kind;
+    e->size = size;
+    e->name = nfc_malloc(strlen(name) + 1);
+    switch (kind) {
+        case PARTIAL_COUNTS: e->counts  = nfc_calloc(size + 1, sizeof(*e->counts)); break;
+        case PARTIAL_SUMS:   e->sums    = nfc_calloc(size + 1, sizeof(*e->sums));   break;
+        case PARTIAL_VALUES: e->values  = nfc_calloc(size + 1, sizeof(*e->values)); break;
+        case PARTIAL_ROWS:   e->columns = nfc_calloc(size + 1, sizeof(char*));      break;
+        default: break;
+    }
+    if (!e->name || (!e->counts && !e->sums && !e->values && !e->columns)) {
+        PRINT(ERR, "Failed to allocate memory for the entry %s", name);
+        nfc_free(e->name);
+        nfc_free(e->counts);
+        nfc_free(e->sums);
+        nfc_free(e->values);
+        nfc_free(e->columns);
+        return -1;
+    }
+    strcpy(e->name, name);
+    partial->nbEntries = partial->nbEntries + 1;
+    *entry             = e;
+
+    return 0;
+}
+
+int partial_setColumns(partial_entry_t* entry, const char** columns) {
+    //========== Check arguments
+    assert(entry && entry->kind == PARTIAL_ROWS, "Columns are only named in entries of rows", -1);
+
+    for (size_t c = 0; c < entry->size; c=c+1) {
+        assert(
+            columns[c] && columns[c][0] && !strpbrk(columns[c], " \t\n") && strlen(columns[c]) < PARTIAL_MAX_NAME,
+            "Invalid name of column \"%s\"", -1, columns[c] ? columns[c] : "(null)"
+        );
+        nfc_free(entry->columns[c]);
+        entry->columns[c] = nfc_malloc(strlen(columns[c]) + 1);
+        assert(entry->columns[c], "Failed to allocate memory for the columns", -1);
+        strcpy(entry->columns[c], columns[c]);
+    }
+
+    return 0;
+}
+
+int partial_addRow(partial_entry_t* entry, const double* row) {
+    //========== Variables declaration
+    double* grown;                               // Grown array of the rows
+
+    //========== Check arguments
+    assert(entry && entry->kind == PARTIAL_ROWS, "Rows are only added to entries of rows", -1);
+
+    if (entry->nbRows == entry->capacity) {
+        grown = nfc_realloc(entry->values, (2 * entry->capacity + 1) * entry->size * sizeof(double));
+        assert(grown, "Failed to allocate memory for the rows", -1);
+        entry->values   = grown;
+        entry->capacity = 2 * entry->capacity + 1;
+    }
+    memcpy(entry->values + entry->nbRows * entry->size, row, entry->size * sizeof(double));
+    entry->nbRows = entry->nbRows + 1;
+
+    return 0;
+}
+
+/**
+ * @brief Compare two rows on their first column, see qsort()
+ * 
+ * @param a First row
+ * @param b Second row
+ * @return int - Order of the rows
+ */
+static int partial_compareRows(const void* a, const void* b) {
+    return (*(const double*)a > *(const double*)b) - (*(const double*)a < *(const double*)b);
+}
+
+int partial_merge(partial_t partial, partial_t other) {
+    //========== Variables declaration
+    partial_entry_t* from;                       // Entry of the other results
+    partial_entry_t* to;                         // Entry of the results
+    int              isNew;                      // 1 if the entry is not in the results yet
+
+    //========== Check arguments
+    assert(partial && other, "Results cannot be NULL", -1);
+    assert(!strcmp(partial->tool, other->tool), "Results of %s and of %s cannot be merged", -1, partial->tool, other->tool);
+    assert(!strcmp(partial->config, other->config), "Results of different configurations cannot be merged", -1);
+    assert(partial->nbShards == other->nbShards, "Results split in %u and %u shards cannot be merged", -1, partial->nbShards, other->nbShards);
+    for (unsigned int s = 0; s < partial->nbShards; s=s+1)
+        assert(!(partial->shards[s] && other->shards[s]), "Shard %u/%u is merged twice", -1, s, partial->nbShards);
+
+    //========== Merge the entries
+    for (size_t e = 0; e < other->nbEntries; e=e+1) {
+        from  = &other->entries[e];
+        isNew = !partial_find(partial, from->name);
+        if (partial_entry(partial, from->name, from->kind, from->size, &to))
+            return -1;
+        switch (from->kind) {
+            case PARTIAL_COUNTS:
+                for (size_t i = 0; i < from->size; i=i+1)
+                    to->counts[i] = to->counts[i] + from->counts[i];
+            break;
+            case PARTIAL_SUMS:
+                for (size_t i = 0; i < from->size; i=i+1) {
+                    partial_sumCarry(&to->sums[i]);
+                    partial_sumCarry(&from->sums[i]);
+                    for (size_t l = 0; l < PARTIAL_SUM_LIMBS; l=l+1)
+                        to->sums[i].limbs[l] = to->sums[i].limbs[l] + from->sums[i].limbs[l];
+                    partial_sumCarry(&to->sums[i]);
+                }
+            break;
+            case PARTIAL_VALUES:
+                if (isNew)
+                    memcpy(to->values, from->values, from->size * sizeof(double));
+                assert(
+                    !memcmp(to->values, from->values, from->size * sizeof(double)),
+                    "Values %s differ between the shards", -1, from->name
+                );
+            break;
+            case PARTIAL_ROWS:
+                if (!to->columns[0] && from->columns[0] && partial_setColumns(to, (const char**)from->columns))
+                    return -1;
+                for (size_t r = 0; r < from->nbRows; r=r+1)
+                    if (partial_addRow(to, from->values + r * from->size))
+                        return -1;
+                if (to->nbRows)
+                    qsort(to->values, to->nbRows, to->size * sizeof(double), partial_compareRows);
+            break;
+            default:
+            break;
+        }
+    }
+
+    for (unsigned int s = 0; s < partial->nbShards; s=s+1)
+        partial->shards[s] = partial->shards[s] | other->shards[s];
+
+    return 0;
+}
+
+int partial_complete(partial_t partial) {
+    for (unsigned int s = 0; s < partial->nbShards; s=s+1)
+        if (!partial->shards[s])
+            return 0;
+    return 1;
+}
+
+int partial_write(partial_t partial, const char* filename) {
+    //========== Variables declaration
+    FILE*            file;                       // Written file
+    partial_entry_t* e;                          // Written entry
+    size_t           first;                      // First non null limb of a sum
+    size_t           last;                       // Limb after the last non null one of a sum
+    unsigned int     nbCovered = 0;              // Number of shards covered by the results
+
+    //========== Check arguments
+    assert(partial, "Results cannot be NULL", -1);
+    assert(filename && filename[0], "Filename cannot be NULL or empty", -1);
+
+    file = fopen(filename, "w");
+    assert(file, "Cannot open file %s", -1, filename);
+
+    //========== Header
+    for (unsigned int s = 0; s < partial->nbShards; s=s+1)
+        nbCovered = nbCovered + partial->shards[s];
+    fprintf(file, "NFCSIM-PARTIAL %d\ntool %s\nconfig %s\nshards %u %u", PARTIAL_VERSION, partial->tool, partial->config, partial->nbShards, nbCovered);
+    for (unsigned int s = 0; s < partial->nbShards; s=s+1)
+        if (partial->shards[s])
+            fprintf(file, " %u", s);
+    fprintf(file, "\n");
+
+    //========== Entries
+    for (size_t i = 0; i < partial->nbEntries; i=i+1) {
+        e = &partial->entries[i];
+        fprintf(file, "%s %s %zu", partial_kindNames[e->kind], e->name, e->size);
+        if (e->kind == PARTIAL_ROWS) {
+            fprintf(file, " %zu\n", e->nbRows);
+            for (size_t c = 0; c < e->size; c=c+1)
+                fprintf(file, "%s%s", c ? " " : "", e->columns[c] ? e->columns[c] : "-");
+        }
+        fprintf(file, "\n");
+
+        switch (e->kind) {
+            case PARTIAL_COUNTS:
+                for (size_t v = 0; v < e->size; v=v+1)
+                    fprintf(file, "%llu\n", (unsigned long long)e->counts[v]);
+            break;
+            case PARTIAL_SUMS:
+                for (size_t v = 0; v < e->size; v=v+1) {
+                    partial_sumCarry(&e->sums[v]);
+                    first = 0;
+                    last  = PARTIAL_SUM_LIMBS;
+                    while (last > 0 && !e->sums[v].limbs[last-1])
+                        last = last - 1;
+                    while (first < last && !e->sums[v].limbs[first])
+                        first = first + 1;
+                    fprintf(file, "%zu %zu", first, last - first);
+                    for (size_t l = first; l < last; l=l+1)
+                        fprintf(file, " %lld", (long long)e->sums[v].limbs[l]);
+                    fprintf(file, "\n");
+                }
+            break;
+            case PARTIAL_VALUES:
+                for (size_t v = 0; v < e->size; v=v+1)
+                    fprintf(file, "%.17g\n", e->values[v]);
+            break;
+            case PARTIAL_ROWS:
+                if (e->nbRows)
+                    qsort(e->values, e->nbRows, e->size * sizeof(double), partial_compareRows);
+                for (size_t r = 0; r < e->nbRows; r=r+1)
+                    for (size_t c = 0; c < e->size; c=c+1)
+                        fprintf(file, "%.17g%c", e->values[r * e->size + c], c + 1 < e->size ? ' ' : '\n');
+            break;
+            default:
+            break;
+        }
+    }
+    fprintf(file, "end\n");
+
+    if (ferror(file)) {
+        PRINT(ERR, "Failed to write the partial results %s", filename);
+        fclose(file);
+        remove(filename);
+        return -1;
+    }
+    fclose(file);
+
+    return 0;
+}
+
+int partial_read(const char* filename, partial_t* partial) {
+    //========== Variables declaration
+    FILE*            file;                       // Read file
+    char             tool[PARTIAL_MAX_NAME];     // Tool of the results
+    char             config[PARTIAL_MAX_NAME+1]; // Configuration of the results
+    char             kind[16];                   // Kind of an entry
+    char             name[PARTIAL_MAX_NAME];     // Name of an entry or of a column
+    partial_entry_t* e;                          // Read entry
+    shard_t          shard = {0, 1};             // First shard of the results
+    unsigned int     nbCovered;                  // Number of shards covered by the results
+    unsigned int     index;                      // Index of a covered shard
+    int              version;                    // Version of the layout
+    size_t           size;                       // Size of an entry
+    size_t           nbRows;                     // Number of rows of an entry
+    size_t           first;                      // First non null limb of a sum
+    size_t           nbLimbs;                    // Number of limbs of a sum
+    long long        limb;                       // Limb of a sum
+    unsigned long long count;                    // Count of an entry
+    double*          row   = NULL;               // Row of an entry
+    partial_kind_t   k;                          // Kind of an entry
+
+    //========== Check arguments
+    assert(filename, "Filename cannot be NULL", -1);
+    file = fopen(filename, "r");
+    assert(file, "Cannot open file %s", -1, filename);
+    *partial = NULL;
+
+    //========== Header
+    if (fscanf(file, "NFCSIM-PARTIAL %d tool %1023s config", &version, tool) != 2 || version != PARTIAL_VERSION ||
+        fgetc(file) != ' ' || !fgets(config, sizeof(config), file) || !strchr(config, '\n') ||
+        fscanf(file, " shards %u %u", &shard.count, &nbCovered) != 2 || !shard.count || nbCovered > shard.count)
+        goto corrupted;
+    config[strlen(config) - 1] = '\0';
+    if (partial_create(tool, config, &shard, partial))
+        goto fail;
+    (*partial)->shards[0] = 0;
+    for (unsigned int s = 0; s < nbCovered; s=s+1) {
+        if (fscanf(file, "%u", &index) != 1 || index >= shard.count)
+            goto corrupted;
+        (*partial)->shards[index] = 1;
+    }
+
+    //========== Entries
+    while (fscanf(file, " %15s", kind) == 1 && strcmp(kind, "end")) {
+        for (k = 0; k < NB_PARTIAL_KINDS; k=k+1)
+            if (!strcmp(kind, partial_kindNames[k]))
+                break;
+        if (k == NB_PARTIAL_KINDS || fscanf(file, " %1023s %zu", name, &size) != 2 ||
+            partial_find(*partial, name) || partial_entry(*partial, name, k, size, &e))
+            goto corrupted;
+
+        switch (k) {
+            case PARTIAL_COUNTS:
+                for (size_t v = 0; v < size; v=v+1) {
+                    if (fscanf(file, "%llu", &count) != 1)
+                        goto corrupted;
+                    e->counts[v] = count;
+                }
+            break;
+            case PARTIAL_SUMS:
+                for (size_t v = 0; v < size; v=v+1) {
+                    if (fscanf(file, "%zu %zu", &first, &nbLimbs) != 2 || first + nbLimbs > PARTIAL_SUM_LIMBS)
+                        goto corrupted;
+                    for (size_t l = first; l < first + nbLimbs; l=l+1) {
+                        if (fscanf(file, "%lld", &limb) != 1)
+                            goto corrupted;
+                        e->sums[v].limbs[l] = limb;
+                    }
+                }
+            break;
+            case PARTIAL_VALUES:
+                for (size_t v = 0; v < size; v=v+1)
+                    if (fscanf(file, "%lg", &e->values[v]) != 1)
+                        goto corrupted;
+            break;
+            case PARTIAL_ROWS:
+                if (fscanf(file, "%zu", &nbRows) != 1)
+                    goto corrupted;
+                // Unnamed columns are written as "-"
+                for (size_t c = 0; c < size; c=c+1) {
+                    if (fscanf(file, " %1023s", name) != 1)
+                        goto corrupted;
+                    if (!strcmp(name, "-"))
+                        continue;
+                    e->columns[c] = nfc_malloc(strlen(name) + 1);
+                    if (!e->columns[c])
+                        goto fail;
+                    strcpy(e->columns[c], name);
+                }
+                nfc_free(row);
+                row = nfc_malloc((size + 1) * sizeof(double));
+                if (!row)
+                    goto fail;
+                for (size_t r = 0; r < nbRows; r=r+1) {
+                    for (size_t c = 0; c < size; c=c+1)
+                        if (fscanf(file, "%lg", &row[c]) != 1)
+                            goto corrupted;
+                    if (partial_addRow(e, row))
+                        goto fail;
+                }
+            break;
+            default:
+            break;
+        }
+    }
+    if (strcmp(kind, "end"))
+        goto corrupted;
+
+    nfc_free(row);
+    fclose(file);
+    return 0;
+
+corrupted:
+    PRINT(ERR, "Corrupted partial results %s", filename);
+fail:
+    nfc_free(row);
+    fclose(file);
+    if (*partial)
+        partial_destroy(*partial);
+    *partial = NULL;
+    return -1;
+}
+
+int partial_readAll(const char** filenames, size_t nbFiles, partial_t* partial) {
+    //========== Variables declaration
+    partial_t other;                             // Results of a file
+
+    //========== Check arguments
+    assert(filenames && nbFiles, "At least one file is needed", -1);
+
+    if (partial_read(filenames[0], partial))
+        return -1;
+    for (size_t f = 1; f < nbFiles; f=f+1) {
+        if (partial_read(filenames[f], &other)) {
+            partial_destroy(*partial);
+            return -1;
+        }
+        if (partial_merge(*partial, other)) {
+            PRINT(ERR, "Cannot merge %s", filenames[f]);
+            partial_destroy(other);
+            partial_destroy(*partial);
+            return -1;
+        }
+        partial_destroy(other);
+    }
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+/**
+ * @file pipeline.c
+ * @author OUSSET Gaël
+ * @brief Incremental generation of NFC signals, only the stages depending on
+ *        changed parameters are run again
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "pipeline.h"
+#include "logging.h"
+#include "assert.h"
+#include "context.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Fields each stage depends on directly, the stages after a stage
+ *        depend on its output
+ * 
+ */
+static const unsigned int nfc_stageDeps[NB_STAGES] = {
+    [STAGE_ENCODE]     = FIELD_DATA | FIELD_DATA_SIZE | FIELD_ENCODING_TYPE,
+    [STAGE_SUBCARRIER] = FIELD_SUB_MODULATION | FIELD_SUB_CARRIER_FREQ | FIELD_BIT_RATE,
+    [STAGE_ENVELOPE]   = FIELD_SUB_MODULATION | FIELD_SUB_CARRIER_FREQ | FIELD_BIT_RATE |
+                         FIELD_CARRIER_FREQ | FIELD_MODULATION_INDEX |
+                         FIELD_SIM_DURATION | FIELD_NUMBER_OF_POINTS,
+    [STAGE_MODULATE]   = FIELD_CARRIER_FREQ,
+    [STAGE_NOISE]      = FIELD_NOISE_LEVEL
+};
+
+/**
+ * @brief Free the output of a stage
+ * 
+ * @param pipeline Pipeline
+ * @param stage Stage to clear
+ */
+static void nfc_pipelineClear(nfc_pipeline_t pipeline, nfc_stage_t stage) {
+    switch (stage) {
+        case STAGE_ENCODE:
+            nfc_free(pipeline->encodedData);
+            pipeline->encodedData = NULL;
+        break;
+        case STAGE_SUBCARRIER:
+            nfc_free(pipeline->subModulatedData);
+            pipeline->subModulatedData = NULL;
+        break;
+        case STAGE_ENVELOPE:
+            if (pipeline->envelope)
+                scatter_destroy(pipeline->envelope);
+            pipeline->envelope = NULL;
+        break;
+        case STAGE_MODULATE:
+            if (pipeline->modulatedSignal)
+                scatter_destroy(pipeline->modulatedSignal);
+            pipeline->modulatedSignal = NULL;
+        break;
+        case STAGE_NOISE:
+            if (pipeline->noisySignal)
+                scatter_destroy(pipeline->noisySignal);
+            pipeline->noisySignal = NULL;
+        break;
+        default:
+        break;
+    }
+    pipeline->valid[stage] = 0;
+}
+
+/**
+ * @brief Run a stage from the output of the previous one
+ * 
+ * @param pipeline Pipeline
+ * @param stage Stage to run
+ * @return int - 0 if success, -1 otherwise
+ */
+static int nfc_pipelineStage(nfc_pipeline_t pipeline, nfc_stage_t stage) {
+    //========== Variables declaration
+    nfc_sigParam_t* sigParam = &pipeline->sigParam;
+    int             ret      = 0;            // Return value of the stage
+
+    //========== Reuse the noisy signal buffer between noise draws
+    if (stage == STAGE_NOISE && pipeline->noisySignal && sigParam->noiseLevel &&
+        pipeline->noisySignal->size == pipeline->modulatedSignal->size
+    ) {
+        if (nfc_addNoiseInto(pipeline->modulatedSignal, sigParam, pipeline->noisySignal))
+            return -1;
+        pipeline->valid[stage]  = 1;
+        pipeline->nbRuns[stage] = pipeline->nbRuns[stage] + 1;
+        return 0;
+    }
+
+    nfc_pipelineClear(pipeline, stage);
+    switch (stage) {
+        case STAGE_ENCODE:
+            ret = nfc_encodeData(sigParam, &pipeline->encodedData, &pipeline->encodedSize);
+        break;
+        case STAGE_SUBCARRIER:
+            ret = nfc_modulateSubCarrier(
+                pipeline->encodedData, pipeline->encodedSize,
+                sigParam,
+                &pipeline->subModulatedData, &pipeline->subModulatedSize
+            );
+        break;
+        case STAGE_ENVELOPE:
+            ret = nfc_createEnvelope(
+                pipeline->subModulatedData, pipeline->subModulatedSize,
+                sigParam,
+                &pipeline->envelope
+            );
+        break;
+        case STAGE_MODULATE:
+            ret = nfc_modulate(pipeline->envelope, sigParam, &pipeline->modulatedSignal);
+        break;
+        case STAGE_NOISE:
+            // Without noise, the output is the modulated signal
+            if (sigParam->noiseLevel)
+                ret = nfc_addNoise(pipeline->modulatedSignal, sigParam, &pipeline->noisySignal);
+        break;
+        default:
+            ret = -1;
+        break;
+    }
+
+    //----- Output pointers are not set on failure
+    if (ret) {
+        switch (stage) {
+            case STAGE_ENCODE:     pipeline->encodedData      = NULL; break;
+            case STAGE_SUBCARRIER: pipeline->subModulatedData = NULL; break;
+            case STAGE_ENVELOPE:   pipeline->envelope         = NULL; break;
+            case STAGE_MODULATE:   pipeline->modulatedSignal  = NULL; break;
+            case STAGE_NOISE:      pipeline->noisySignal      = NULL; break;
+            default: break;
+        }
+        return -1;
+    }
+
+    pipeline->valid[stage]  = 1;
+    pipeline->nbRuns[stage] = pipeline->nbRuns[stage] + 1;
+    return 0;
+}
+
+unsigned int nfc_stageDependencies(nfc_stage_t stage) {
+    if (stage >= NB_STAGES)
+        return 0;
+    return nfc_stageDeps[stage];
+}
+
+int nfc_pipelineCreate(nfc_pipeline_t* pipeline) {
+    *pipeline = nfc_calloc(1, sizeof(**pipeline));
+    assert(*pipeline, "Failed to allocate memory for the pipeline", -1);
+
+    return 0;
+}
+
+void nfc_pipelineDestroy(nfc_pipeline_t pipeline) {
+    for (int stage = 0; stage < NB_STAGES; stage=stage+1)
+        nfc_pipelineClear(pipeline, (nfc_stage_t)stage);
+    nfc_free(pipeline->data);
+    nfc_free(pipeline);
+}
+
+unsigned int nfc_pipelineChanges(nfc_pipeline_t pipeline, nfc_sigParam_t* sigParam) {
+    //========== Variables declaration
+    nfc_sigParam_t* old     = &pipeline->sigParam;
+    unsigned int    changes = 0;                 // Mask of the changed fields
+
+    //========== Nothing cached yet
+    if (!pipeline->data)
+        return ~0u;
+
+    //========== Compare the fields
+    if (sigParam->dataSize != old->dataSize)
+        changes = changes | FIELD_DATA_SIZE | FIELD_DATA;
+    else if (!sigParam->data || memcmp(sigParam->data, pipeline->data, sigParam->dataSize))
+        changes = changes | FIELD_DATA;
+    if (sigParam->bitRate         != old->bitRate)         changes = changes | FIELD_BIT_RATE;
+    if (sigParam->encodingType    != old->encodingType)    changes = changes | FIELD_ENCODING_TYPE;
+    if (sigParam->subModulation   != old->subModulation)   changes = changes | FIELD_SUB_MODULATION;
+    if (sigParam->subCarrierFreq  != old->subCarrierFreq)  changes = changes | FIELD_SUB_CARRIER_FREQ;
+    if (sigParam->carrierFreq     != old->carrierFreq)     changes = changes | FIELD_CARRIER_FREQ;
+    if (sigParam->modulationIndex != old->modulationIndex) changes = changes | FIELD_MODULATION_INDEX;
+    if (sigParam->noiseLevel      != old->noiseLevel)      changes = changes | FIELD_NOISE_LEVEL;
+    if (sigParam->simDuration     != old->simDuration)     changes = changes | FIELD_SIM_DURATION;
+    if (sigParam->numberOfPoints  != old->numberOfPoints)  changes = changes | FIELD_NUMBER_OF_POINTS;
+
+    return changes;
+}
+
+void nfc_pipelineInvalidate(nfc_pipeline_t pipeline, nfc_stage_t stage) {
+    for (int i = (int)stage; i < NB_STAGES; i=i+1)
+        pipeline->valid[i] = 0;
+}
+
+int nfc_pipelineRun(nfc_pipeline_t pipeline, nfc_sigParam_t* sigParam, scatter_t* signal) {
+    //========== Variables declaration
+    unsigned int changes;                        // Mask of the changed fields
+    char*        data;                           // Copy of the new data
+
+    //========== Check arguments
+    assert(pipeline, "Pipeline cannot be NULL", -1);
+    assert(sigParam, "Signal parameters cannot be NULL", -1);
+    assert(sigParam->data, "Input data cannot be NULL", -1);
+    assert(sigParam->dataSize, "Input data size cannot be null", -1);
+
+    //========== Find the out of date stages
+    changes = nfc_pipelineChanges(pipeline, sigParam);
+    for (int stage = 0; stage < NB_STAGES; stage=stage+1) {
+        if (changes & nfc_stageDeps[stage]) {
+            nfc_pipelineInvalidate(pipeline, (nfc_stage_t)stage);
+            break;
+        }
+    }
+
+    //========== Keep a snapshot of the parameters
+    if (changes & FIELD_DATA) {
+        data = nfc_malloc(sigParam->dataSize);
+        assert(data, "Failed to allocate memory for the data of the pipeline", -1);
+        memcpy(data, sigParam->data, sigParam->dataSize);
+        nfc_free(pipeline->data);
+        pipeline->data = data;
+    }
+    pipeline->sigParam      = *sigParam;
+    pipeline->sigParam.data = pipeline->data;
+
+    //========== Run the out of date stages
+    for (int stage = 0; stage < NB_STAGES; stage=stage+1) {
+        if (pipeline->valid[stage])
+            continue;
+        if (nfc_pipelineStage(pipeline, (nfc_stage_t)stage)) {
+            PRINT(ERR, "Failed to run stage %d of the pipeline", stage);
+            return -1;
+        }
+    }
+
+    *signal = pipeline->noisySignal ? pipeline->noisySignal : pipeline->modulatedSignal;
+    return 0;
+}
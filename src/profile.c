@@ -0,0 +1,356 @@
+/**
+ * @file profile.c
+ * @author OUSSET Gaël
+ * @brief Attribution of the work of the library to the pipeline stages,
+ *        timing and hardware counters of the stages
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "profile.h"
+#include "context.h"
+#include "assert.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __linux__
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+/**
+ * @brief Hardware counters opened by a thread
+ * 
+ */
+struct prof_counters {
+    int fds[NB_PROF_COUNTERS];                   // File descriptors of the counters, -1 if not permitted
+};
+
+/**
+ * @brief Names of the stages, indexed by prof_stage_t
+ * 
+ */
+static const char* prof_stageNames[NB_PROF_STAGES] = {
+    [PROF_OTHER]      = "other",
+    [PROF_ENCODE]     = "encode",
+    [PROF_SUBCARRIER] = "sub-carrier",
+    [PROF_ENVELOPE]   = "envelope",
+    [PROF_MODULATE]   = "modulate",
+    [PROF_NOISE]      = "noise",
+    [PROF_FFT]        = "FFT",
+    [PROF_LCADC]      = "LCADC",
+    [PROF_DEMOD]      = "demod",
+    [PROF_CSV]        = "CSV"
+};
+
+/**
+ * @brief Names of the hardware counters, indexed by prof_counter_t
+ * 
+ */
+static const char* prof_counterNames[NB_PROF_COUNTERS] = {
+    [PROF_CYCLES]        = "cycles",
+    [PROF_INSTRUCTIONS]  = "instructions",
+    [PROF_L1D_MISSES]    = "L1D misses",
+    [PROF_LLC_MISSES]    = "LLC misses",
+    [PROF_BRANCH_MISSES] = "branch misses"
+};
+
+const char* prof_stageName(prof_stage_t stage) {
+    if (stage >= NB_PROF_STAGES)
+        return "unknown";
+    return prof_stageNames[stage];
+}
+
+uint64_t prof_now(void) {
+    //========== Variables declaration
+    struct timespec now;                         // Current time
+
+#ifdef _WIN32
+    timespec_get(&now, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec + 1;
+}
+
+#ifndef NO_PROFILING
+/**
+ * @brief Read the hardware counters of a context
+ * 
+ * @param counters Hardware counters, may be NULL
+ * @param values Values of the counters, 0 for the closed ones
+ */
+static void prof_readCounters(prof_counters_t* counters, uint64_t values[NB_PROF_COUNTERS]) {
+    //========== Variables declaration
+#ifdef __linux__
+    uint64_t raw[3];                             // Value, time enabled, time running
+#endif
+    int      i;                                  // Loop index
+
+    for (i=0; i<NB_PROF_COUNTERS; i=i+1) {
+        values[i] = 0;
+#ifdef __linux__
+        if (!counters || counters->fds[i] < 0)
+            continue;
+        if (read(counters->fds[i], raw, sizeof(raw)) != (ssize_t)sizeof(raw) || !raw[2])
+            continue;
+        // Scale the value when the counter was multiplexed with others
+        values[i] = raw[2] < raw[1] ? (uint64_t)((double)raw[0] * (double)raw[1] / (double)raw[2]) : raw[0];
+#else
+        (void)counters;
+#endif
+    }
+}
+#endif
+
+prof_scope_t prof_enter(prof_stage_t stage, const char* name) {
+    //========== Variables declaration
+#ifndef NO_PROFILING
+    nfc_context_t context = nfc_contextGet();   // Context of the thread
+#endif
+    prof_scope_t  scope;                        // Scope of the stage
+
+    scope.stage    = stage;
+    scope.previous = nfc_contextStage();
+    nfc_contextSetStage(stage);
+#ifndef NO_PROFILING
+    scope.name     = name;
+    trace_begin(name, prof_stageNames[stage]);
+    // A stage calling itself (nfc_modulate() -> nfc_modulateInto()) is timed once
+    scope.start    = stage == scope.previous ? 0 : prof_now();
+    if (scope.start)
+        prof_readCounters(context->counters, scope.counters);
+#else
+    (void)name;
+#endif
+
+    return scope;
+}
+
+void prof_leave(prof_scope_t* scope) {
+    //========== Variables declaration
+#ifndef NO_PROFILING
+    nfc_context_t context = nfc_contextGet();   // Context of the thread
+    uint64_t      counters[NB_PROF_COUNTERS];   // Hardware counters when leaving
+    int           i;                            // Loop index
+#endif
+
+    nfc_contextSetStage(scope->previous);
+#ifndef NO_PROFILING
+    if (scope->start) {
+        prof_readCounters(context->counters, counters);
+        // The workers of parallel_for() share the statistics of the caller
+        pthread_mutex_lock(&context->lock);
+        context->profStats[scope->stage].nbCalls = context->profStats[scope->stage].nbCalls + 1;
+        context->profStats[scope->stage].time    = context->profStats[scope->stage].time + prof_now() - scope->start;
+        if (context->counters)
+            for (i=0; i<NB_PROF_COUNTERS; i=i+1)
+                context->profStats[scope->stage].counters[i] =
+                    context->profStats[scope->stage].counters[i] + counters[i] - scope->counters[i];
+        pthread_mutex_unlock(&context->lock);
+    }
+    trace_end(scope->name, prof_stageNames[scope->stage]);
+#endif
+}
+
+void prof_count(size_t nbSamples, size_t nbBytes) {
+    //========== Variables declaration
+    nfc_context_t context = nfc_contextGet();   // Context of the thread
+    prof_stats_t* stats   = &context->profStats[nfc_contextStage()];
+
+    pthread_mutex_lock(&context->lock);
+    stats->nbSamples = stats->nbSamples + nbSamples;
+    stats->nbBytes   = stats->nbBytes + nbBytes;
+    pthread_mutex_unlock(&context->lock);
+}
+
+prof_stats_t prof_stats(prof_stage_t stage) {
+    //========== Variables declaration
+    prof_stats_t stats;                          // Timing of the stage
+
+    memset(&stats, 0, sizeof(stats));
+    if (stage < NB_PROF_STAGES)
+        stats = nfc_contextGet()->profStats[stage];
+
+    return stats;
+}
+
+void prof_reset(void) {
+    nfc_context_t context = nfc_contextGet();
+
+    memset(context->profStats, 0, sizeof(context->profStats));
+}
+
+int prof_countersOpen(void) {
+    //========== Variables declaration
+    nfc_context_t    context = nfc_contextGet(); // Context of the thread
+    prof_counters_t* counters;                   // Opened counters
+    int              nbOpened;                   // Number of opened counters
+    int              i;                          // Loop index
+#ifdef __linux__
+    struct perf_event_attr attr;                 // Attributes of a counter
+    static const struct {
+        uint32_t type;
+        uint64_t config;
+    } events[NB_PROF_COUNTERS] = {               // Events of the counters
+        [PROF_CYCLES]        = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        [PROF_INSTRUCTIONS]  = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        [PROF_L1D_MISSES]    = {
+            PERF_TYPE_HW_CACHE,
+            PERF_COUNT_HW_CACHE_L1D |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+        },
+        [PROF_LLC_MISSES]    = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        [PROF_BRANCH_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+    };
+#endif
+
+    if (context->counters)
+        return 0;
+
+    counters = malloc(sizeof(*counters));
+    assert(counters, "Failed to allocate memory for the hardware counters", -1);
+
+    //========== Open the counters
+    nbOpened = 0;
+    for (i=0; i<NB_PROF_COUNTERS; i=i+1) {
+        counters->fds[i] = -1;
+#ifdef __linux__
+        memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = events[i].type;
+        attr.config         = events[i].config;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.inherit        = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        counters->fds[i]    = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (counters->fds[i] < 0)
+            PRINT(WARN, "Hardware counter \"%s\" is not permitted", prof_counterNames[i]);
+        else
+            nbOpened = nbOpened + 1;
+#endif
+    }
+
+    if (!nbOpened) {
+        PRINT(WARN, "No hardware counter available, only the time is measured");
+        free(counters);
+        return -1;
+    }
+    context->counters = counters;
+
+    return 0;
+}
+
+void prof_countersClose(void) {
+    nfc_context_t context = nfc_contextGet();
+
+    prof_countersDestroy(context->counters);
+    context->counters = NULL;
+}
+
+void prof_countersDestroy(prof_counters_t* counters) {
+    //========== Variables declaration
+    int i;                                       // Loop index
+
+    if (!counters)
+        return;
+#ifdef __linux__
+    for (i=0; i<NB_PROF_COUNTERS; i=i+1)
+        if (counters->fds[i] >= 0)
+            close(counters->fds[i]);
+#else
+    (void)i;
+#endif
+    free(counters);
+}
+
+int prof_counterAvailable(prof_counter_t counter) {
+    //========== Variables declaration
+    prof_counters_t* counters = nfc_contextGet()->counters;
+
+    return counter < NB_PROF_COUNTERS && counters && counters->fds[counter] >= 0;
+}
+
+/**
+ * @brief Format the number of hardware events per sample of a stage
+ * 
+ * @param stats Timing of the stage
+ * @param counter Counter to format
+ * @param buffer Buffer to fill
+ * @param size Size of the buffer
+ * @return const char* - Formatted value, "-" if the counter is not sampled
+ */
+static const char* prof_formatPerSample(prof_stats_t* stats, prof_counter_t counter, char* buffer, size_t size) {
+    if (!prof_counterAvailable(counter) || !stats->nbSamples)
+        return "-";
+    snprintf(buffer, size, "%.4g", (double)stats->counters[counter] / (double)stats->nbSamples);
+    return buffer;
+}
+
+void prof_report(print_type_t print_type) {
+    //========== Variables declaration
+    prof_stats_t stats;                          // Timing of a stage
+    double       seconds;                        // Time spent in the stage (s)
+    char         ipc[16];                        // Instructions per cycle
+    char         l1d[16];                        // L1D misses per sample
+    char         llc[16];                        // LLC misses per sample
+    char         branch[16];                     // Branch misses per sample
+    int          counted;                        // 1 if hardware counters are open
+    int          i;                              // Loop index
+
+    counted = nfc_contextGet()->counters != NULL;
+    if (counted)
+        PRINT(print_type, "%-12s %8s %12s %14s %14s %8s %10s %10s %10s",
+              "Stage", "Calls", "Time (ms)", "Samples/s", "MB/s",
+              "IPC", "L1D/smp", "LLC/smp", "Br/smp");
+    else
+        PRINT(print_type, "%-12s %8s %12s %14s %14s",
+              "Stage", "Calls", "Time (ms)", "Samples/s", "MB/s");
+    for (i=0; i<NB_PROF_STAGES; i=i+1) {
+        stats = prof_stats((prof_stage_t)i);
+        if (!stats.nbCalls)
+            continue;
+        seconds = (double)stats.time * 1e-9;
+        if (!counted) {
+            PRINT(print_type, "%-12s %8lu %12.3f %14.4g %14.4g",
+                  prof_stageName((prof_stage_t)i), stats.nbCalls, seconds * 1e3,
+                  seconds > 0 ? (double)stats.nbSamples / seconds : 0.0,
+                  seconds > 0 ? (double)stats.nbBytes / seconds * 1e-6 : 0.0);
+            continue;
+        }
+        if (prof_counterAvailable(PROF_CYCLES) && prof_counterAvailable(PROF_INSTRUCTIONS) && stats.counters[PROF_CYCLES])
+            snprintf(ipc, sizeof(ipc), "%.2f", (double)stats.counters[PROF_INSTRUCTIONS] / (double)stats.counters[PROF_CYCLES]);
+        else
+            strcpy(ipc, "-");
+        PRINT(print_type, "%-12s %8lu %12.3f %14.4g %14.4g %8s %10s %10s %10s",
+              prof_stageName((prof_stage_t)i), stats.nbCalls, seconds * 1e3,
+              seconds > 0 ? (double)stats.nbSamples / seconds : 0.0,
+              seconds > 0 ? (double)stats.nbBytes / seconds * 1e-6 : 0.0,
+              ipc,
+              prof_formatPerSample(&stats, PROF_L1D_MISSES, l1d, sizeof(l1d)),
+              prof_formatPerSample(&stats, PROF_LLC_MISSES, llc, sizeof(llc)),
+              prof_formatPerSample(&stats, PROF_BRANCH_MISSES, branch, sizeof(branch)));
+    }
+}
+
+/**
+ * @brief Print the timings at exit, see prof_reportAtExit
+ * 
+ */
+static void prof_exitHandler(void) {
+    prof_report(INFO);
+}
+
+int prof_reportAtExit(void) {
+    return atexit(prof_exitHandler) ? -1 : 0;
+}
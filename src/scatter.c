@@ -12,20 +12,26 @@
 #include "scatter.h"
 #include "logging.h"
 #include "assert.h"
+#include "context.h"
 #include <stdlib.h>
+#ifndef _WIN32
+    #include <sys/mman.h>
+#endif
 
 int scatter_create(scatter_t* scatter, size_t size) {
-    *scatter = malloc(sizeof(**scatter));
+    *scatter = nfc_malloc(sizeof(**scatter));
     assert(*scatter, "Failed to allocate memory for the scatter", -1);
 
     (*scatter)->size = size;
     (*scatter)->xName = NULL;
     (*scatter)->yName = NULL;
+    (*scatter)->mapping = NULL;
+    (*scatter)->mappingSize = 0;
 
-    (*scatter)->points = calloc(size, sizeof(point_t));
+    (*scatter)->points = nfc_calloc(size, sizeof(point_t));
     if (!(*scatter)->points) {
         PRINT(ERR, "Cannot allocate memory for %ld points", size);
-        free(scatter);
+        nfc_free(*scatter);
         return -1;
     }
 
@@ -50,9 +56,39 @@ int scatter_createWName(scatter_t* scatter, size_t size, char* xName, char* yNam
     return 0;
 }
 
+int scatter_createFrom(scatter_t* scatter, point_t* points, size_t size) {
+    *scatter = nfc_malloc(sizeof(**scatter));
+    assert(*scatter, "Failed to allocate memory for the scatter", -1);
+
+    (*scatter)->size        = size;
+    (*scatter)->xName       = NULL;
+    (*scatter)->yName       = NULL;
+    (*scatter)->points      = points;
+    (*scatter)->mapping     = NULL;
+    (*scatter)->mappingSize = 0;
+
+    return 0;
+}
+
+#ifndef _WIN32
+int scatter_createMapped(scatter_t* scatter, void* mapping, size_t mappingSize, point_t* points, size_t size) {
+    assert(!scatter_createFrom(scatter, points, size), "Failed to create the scatter", -1);
+
+    (*scatter)->mapping     = mapping;
+    (*scatter)->mappingSize = mappingSize;
+
+    return 0;
+}
+#endif
+
 void scatter_destroy(scatter_t scatter) {
-    free(scatter->points);
-    free(scatter);
+#ifndef _WIN32
+    if (scatter->mapping)
+        munmap(scatter->mapping, scatter->mappingSize);
+    else
+#endif
+        nfc_free(scatter->points);
+    nfc_free(scatter);
 }
 
 double scatter_getY(scatter_t scatter, size_t index) {
@@ -84,7 +120,7 @@ void scatter_print(scatter_t scatter, char separator, print_type_t print_type) {
 
 //========== Functions for point_t
 int point_create(point_t** point, int x, double y) {
-    *point = malloc(sizeof(**point));
+    *point = nfc_malloc(sizeof(**point));
     assert(*point, "Failed to allocate memory for the point", -1);
 
     (*point)->x = x;
@@ -94,7 +130,7 @@ int point_create(point_t** point, int x, double y) {
 }
 
 int point_destroy(void* point) {
-    free(point);
+    nfc_free(point);
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,308 @@
+/**
+ * @file sweep.c
+ * @author OUSSET Gaël
+ * @brief Parameter sweeps sharing the stages of the generation between the
+ *        points of a grid
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "sweep.h"
+#include "CSV.h"
+#include "logging.h"
+#include "assert.h"
+#include "context.h"
+#include "parallel.h"
+#include "prng.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+//========== Structures declarations
+/**
+ * @brief Arguments shared by the chunks of a sweep
+ * 
+ */
+typedef struct {
+    const sweep_grid_t* grid;                    // Grid of the sweep
+    sweep_measure_t     measure;                 // Measure of a point
+    void*               user;                    // User pointer of the measure
+    size_t              nbValues;                // Number of measures of a point
+    FILE*               results;                 // Destination of the results, NULL for none
+    pthread_mutex_t     lock;                    // Lock of the results and of the counters
+    size_t              order[SWEEP_MAX_AXES];   // Axes from the slowest to the fastest of the visit
+    size_t              offset;                  // Position of the first point of the shard in the visit
+    unsigned long       nbRuns[NB_STAGES];       // Number of runs of each stage
+    atomic_int          status;                  // -1 if a chunk failed, the other chunks then stop
+} sweep_task_t;
+
+/**
+ * @brief Swept fields and their names
+ * 
+ */
+static const struct {
+    nfc_field_t field;                           // Field of the parameters
+    const char* name;                            // Name of the field
+} sweep_fields[] = {
+    {FIELD_BIT_RATE,         "bitRate"},
+    {FIELD_ENCODING_TYPE,    "encodingType"},
+    {FIELD_SUB_MODULATION,   "subModulation"},
+    {FIELD_SUB_CARRIER_FREQ, "subCarrierFreq"},
+    {FIELD_CARRIER_FREQ,     "carrierFreq"},
+    {FIELD_MODULATION_INDEX, "modulationIndex"},
+    {FIELD_NOISE_LEVEL,      "noiseLevel"},
+    {FIELD_SIM_DURATION,     "simDuration"},
+    {FIELD_NUMBER_OF_POINTS, "numberOfPoints"}
+};
+
+//========== Functions
+const char* sweep_fieldName(nfc_field_t field) {
+    for (size_t i = 0; i < sizeof(sweep_fields) / sizeof(*sweep_fields); i=i+1)
+        if (sweep_fields[i].field == field)
+            return sweep_fields[i].name;
+    return NULL;
+}
+
+size_t sweep_size(const sweep_grid_t* grid) {
+    //========== Variables declaration
+    size_t size = 1;                             // Number of points
+
+    for (size_t a = 0; a < grid->nbAxes; a=a+1)
+        size = size * grid->axes[a].nbValues;
+    return size;
+}
+
+/**
+ * @brief Set a field of the parameters
+ * 
+ * @param sigParam Parameters
+ * @param field Field to set
+ * @param value Value of the field
+ * @return int - 0 if success, -1 if the field cannot be swept
+ */
+static int sweep_setField(nfc_sigParam_t* sigParam, nfc_field_t field, double value) {
+    switch (field) {
+        case FIELD_BIT_RATE:         sigParam->bitRate         = (unsigned int)lround(value);        break;
+        case FIELD_ENCODING_TYPE:    sigParam->encodingType    = (nfc_encoding_t)lround(value);      break;
+        case FIELD_SUB_MODULATION:   sigParam->subModulation   = (nfc_subModulation_t)lround(value); break;
+        case FIELD_SUB_CARRIER_FREQ: sigParam->subCarrierFreq  = (unsigned int)lround(value);        break;
+        case FIELD_CARRIER_FREQ:     sigParam->carrierFreq     = (unsigned int)lround(value);        break;
+        case FIELD_MODULATION_INDEX: sigParam->modulationIndex = (unsigned char)lround(value);       break;
+        case FIELD_NOISE_LEVEL:      sigParam->noiseLevel      = value;                              break;
+        case FIELD_SIM_DURATION:     sigParam->simDuration     = (unsigned int)lround(value);        break;
+        case FIELD_NUMBER_OF_POINTS: sigParam->numberOfPoints  = (unsigned int)lround(value);        break;
+        default:
+            return -1;
+    }
+    return 0;
+}
+
+int sweep_point(const sweep_grid_t* grid, size_t index, nfc_sigParam_t* sigParam) {
+    //========== Variables declaration
+    int    autoSimTime;                          // 1 if the simulation time follows the bit rate
+    size_t value;                                // Index of the value of an axis
+
+    //========== Check arguments
+    assert(grid, "Grid cannot be NULL", -1);
+    assert(index < sweep_size(grid), "Point %zu out of the grid", -1, index);
+
+    *sigParam   = grid->base;
+    autoSimTime = !grid->base.simDuration;
+    for (size_t a = grid->nbAxes; a > 0; a=a-1) {
+        value = index % grid->axes[a-1].nbValues;
+        index = index / grid->axes[a-1].nbValues;
+        assert(
+            !sweep_setField(sigParam, grid->axes[a-1].field, grid->axes[a-1].values[value]),
+            "Field %d cannot be swept", -1, grid->axes[a-1].field
+        );
+        if (grid->axes[a-1].field == FIELD_SIM_DURATION)
+            autoSimTime = 0;
+    }
+    if (autoSimTime)
+        return nfc_autoSimTime(sigParam);
+
+    return 0;
+}
+
+/**
+ * @brief Return the index in the grid of a position of the visit
+ * 
+ * @param task Arguments of the sweep
+ * @param position Position in the visit
+ * @param digit Index of the value of each axis at the point
+ * @return size_t - Index of the point
+ */
+static size_t sweep_index(const sweep_task_t* task, size_t position, size_t* digit) {
+    //========== Variables declaration
+    const sweep_grid_t* grid  = task->grid;      // Grid of the sweep
+    size_t              index = 0;               // Index of the point
+
+    for (size_t o = grid->nbAxes; o > 0; o=o-1) {
+        digit[task->order[o-1]] = position % grid->axes[task->order[o-1]].nbValues;
+        position                = position / grid->axes[task->order[o-1]].nbValues;
+    }
+    for (size_t a = 0; a < grid->nbAxes; a=a+1)
+        index = index * grid->axes[a].nbValues + digit[a];
+    return index;
+}
+
+/**
+ * @brief Generate and measure the points [first, last) of the visit, see
+ *        parallel_task_t
+ * 
+ * @param arg Arguments of the sweep (sweep_task_t)
+ * @param first First position of the chunk
+ * @param last Position after the last one of the chunk
+ */
+static void sweep_chunk(void* arg, size_t first, size_t last) {
+    //========== Variables declaration
+    sweep_task_t*       task     = (sweep_task_t*)arg; // Arguments of the sweep
+    const sweep_grid_t* grid     = task->grid;   // Grid of the sweep
+    nfc_context_t       previous = nfc_contextGet(); // Context of the thread before the chunk
+    nfc_context_t       context  = NULL;         // Context of the points
+    nfc_pipeline_t      pipeline = NULL;         // Generation of the points
+    nfc_sigParam_t      sigParam;                // Parameters of a point
+    scatter_t           signal;                  // Signal of a point
+    double*             values   = NULL;         // Measures of a point
+    size_t              index;                   // Index of a point
+    size_t              digit[SWEEP_MAX_AXES];   // Index of the value of each axis at the point
+
+    //========== Create the context of the chunk
+    if (nfc_contextFork(&context)) {
+        atomic_store_explicit(&task->status, -1, memory_order_relaxed);
+        return;
+    }
+    nfc_contextBind(context);
+
+    values = nfc_calloc(task->nbValues + 1, sizeof(double));
+    if (!values || nfc_pipelineCreate(&pipeline)) {
+        PRINT(ERR, "Failed to allocate memory for the sweep");
+        goto fail;
+    }
+
+    //========== Visit the points
+    for (size_t position = task->offset + first; position < task->offset + last && !atomic_load_explicit(&task->status, memory_order_relaxed); position=position+1) {
+        index = sweep_index(task, position, digit);
+        if (sweep_point(grid, index, &sigParam))
+            goto fail;
+
+        // Only the noise is drawn again if the other fields did not change
+        nfc_contextSeed(context, prng_hash(grid->seed, index));
+        nfc_pipelineInvalidate(pipeline, STAGE_NOISE);
+        if (nfc_pipelineRun(pipeline, &sigParam, &signal))
+            goto fail;
+        if (task->measure && task->measure(task->user, index, &sigParam, signal, values))
+            goto fail;
+
+        //----- Write the line of the point
+        if (task->results) {
+            pthread_mutex_lock(&task->lock);
+            fprintf(task->results, "%zu", index);
+            for (size_t a = 0; a < grid->nbAxes; a=a+1)
+                fprintf(task->results, "%c%.17g", CSV_SEPARATOR, grid->axes[a].values[digit[a]]);
+            for (size_t v = 0; v < task->nbValues; v=v+1)
+                fprintf(task->results, "%c%.17g", CSV_SEPARATOR, values[v]);
+            fprintf(task->results, "\n");
+            fflush(task->results);
+            pthread_mutex_unlock(&task->lock);
+        }
+    }
+    goto end;
+
+fail:
+    atomic_store_explicit(&task->status, -1, memory_order_relaxed);
+end:
+    if (pipeline) {
+        pthread_mutex_lock(&task->lock);
+        for (int stage = 0; stage < NB_STAGES; stage=stage+1)
+            task->nbRuns[stage] = task->nbRuns[stage] + pipeline->nbRuns[stage];
+        pthread_mutex_unlock(&task->lock);
+        nfc_pipelineDestroy(pipeline);
+    }
+    nfc_free(values);
+    nfc_contextBind(previous);
+    nfc_contextDestroy(context);
+}
+
+int sweep_run(const sweep_grid_t* grid, sweep_measure_t measure, void* user, size_t nbValues, const char** valueNames, FILE* results, unsigned long* nbRuns) {
+    //========== Variables declaration
+    shard_t whole = {0, 1};                      // Single shard of the whole grid
+
+    return sweep_runShard(grid, &whole, measure, user, nbValues, valueNames, results, nbRuns);
+}
+
+int sweep_runShard(const sweep_grid_t* grid, const shard_t* shard, sweep_measure_t measure, void* user, size_t nbValues, const char** valueNames, FILE* results, unsigned long* nbRuns) {
+    //========== Variables declaration
+    sweep_task_t task;                           // Arguments of the chunks
+    unsigned int firstStage[SWEEP_MAX_AXES];     // Earliest stage depending on each axis
+    size_t       nbOrdered;                      // Number of axes in the order of the visit
+    size_t       last;                           // Position after the last point of the shard
+    int          stage;                          // Stage of an axis
+
+    //========== Check arguments
+    assert(grid, "Grid cannot be NULL", -1);
+    assert(shard && shard->index < shard->count, "Invalid shard of the sweep", -1);
+    assert(grid->nbAxes <= SWEEP_MAX_AXES, "At most %d axes are supported", -1, SWEEP_MAX_AXES);
+    assert(grid->base.data && grid->base.dataSize, "The base of the grid has no data", -1);
+    assert(!nbValues || measure, "Measures need a measure function", -1);
+    for (size_t a = 0; a < grid->nbAxes; a=a+1) {
+        assert(sweep_fieldName(grid->axes[a].field), "Field %d cannot be swept", -1, grid->axes[a].field);
+        assert(grid->axes[a].values && grid->axes[a].nbValues, "Axis %zu has no value", -1, a);
+    }
+
+    //========== Visit the axes of the earliest stages first
+    for (size_t a = 0; a < grid->nbAxes; a=a+1) {
+        for (stage = 0; stage < NB_STAGES; stage=stage+1)
+            if (nfc_stageDependencies((nfc_stage_t)stage) & grid->axes[a].field)
+                break;
+        firstStage[a] = (unsigned int)stage;
+    }
+    nbOrdered = 0;
+    for (stage = 0; stage <= NB_STAGES; stage=stage+1)
+        for (size_t a = 0; a < grid->nbAxes; a=a+1)
+            if (firstStage[a] == (unsigned int)stage) {
+                task.order[nbOrdered] = a;
+                nbOrdered             = nbOrdered + 1;
+            }
+
+    //========== Write the header of the results
+    if (results) {
+        fprintf(results, "index");
+        for (size_t a = 0; a < grid->nbAxes; a=a+1)
+            fprintf(results, "%c%s", CSV_SEPARATOR, sweep_fieldName(grid->axes[a].field));
+        for (size_t v = 0; v < nbValues; v=v+1)
+            fprintf(results, "%c%s", CSV_SEPARATOR, valueNames ? valueNames[v] : "value");
+        fprintf(results, "\n");
+    }
+
+    //========== Run the chunks
+    task.grid     = grid;
+    task.measure  = measure;
+    task.user     = user;
+    task.nbValues = nbValues;
+    task.results  = results;
+    atomic_init(&task.status, 0);
+    memset(task.nbRuns, 0, sizeof(task.nbRuns));
+    shard_range(shard, sweep_size(grid), &task.offset, &last);
+    assert(!pthread_mutex_init(&task.lock, NULL), "Failed to create the lock of the sweep", -1);
+
+    if (parallel_for(last - task.offset, 1, sweep_chunk, &task) || task.status) {
+        PRINT(ERR, "Failed to run the sweep");
+        task.status = -1;
+    }
+    pthread_mutex_destroy(&task.lock);
+
+    if (nbRuns)
+        memcpy(nbRuns, task.nbRuns, sizeof(task.nbRuns));
+    if (results && ferror(results)) {
+        PRINT(ERR, "Failed to write the results of the sweep");
+        task.status = -1;
+    }
+
+    return task.status;
+}
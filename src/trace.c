@@ -0,0 +1,275 @@
+/**
+ * @file trace.c
+ * @author OUSSET Gaël
+ * @brief Trace of the execution of the library across threads, written as
+ *        trace-event JSON (chrome://tracing, Perfetto)
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "trace.h"
+#include "profile.h"
+#include "logging.h"
+#include "assert.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//========== Structures declarations
+/**
+ * @brief Recorded event
+ * 
+ */
+typedef struct {
+    uint64_t    time;                            // Time of the event (ns)
+    const char* name;                            // Name of the scope
+    const char* category;                        // Category of the scope
+    unsigned    tid;                             // Thread of the event
+    char        phase;                           // 'B' (begin) or 'E' (end)
+} trace_event_t;
+
+/**
+ * @brief Ring buffer of the events of a thread. A buffer is written by a
+ *        single thread at a time, and given to a new thread once its owner
+ *        exits.
+ * 
+ */
+typedef struct trace_buffer {
+    struct trace_buffer* next;                   // Next buffer of the list
+    atomic_int           owned;                  // 1 if a thread writes to the buffer
+    atomic_size_t        head;                   // Number of events written
+    trace_event_t        events[TRACE_BUFFER_SIZE]; // Events, indexed by head % TRACE_BUFFER_SIZE
+} trace_buffer_t;
+
+//========== State of the tracer
+/**
+ * @brief 1 while the events are recorded
+ * 
+ */
+static atomic_int trace_enabled = 0;
+
+/**
+ * @brief List of all the buffers, never shrinks
+ * 
+ */
+static _Atomic(trace_buffer_t*) trace_buffers = NULL;
+
+/**
+ * @brief Last thread identifier given
+ * 
+ */
+static atomic_uint trace_lastTid = 0;
+
+/**
+ * @brief Key releasing the buffer of a thread when it exits
+ * 
+ */
+static pthread_key_t trace_key;
+static pthread_once_t trace_keyOnce = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Buffer and identifier of the thread
+ * 
+ */
+static _Thread_local trace_buffer_t* trace_local = NULL;
+static _Thread_local unsigned trace_tid = 0;
+
+//========== Buffers
+/**
+ * @brief Give the buffer of an exiting thread back to the list
+ * 
+ * @param buffer Buffer of the thread
+ */
+static void trace_release(void* buffer) {
+    atomic_store_explicit(&((trace_buffer_t*)buffer)->owned, 0, memory_order_release);
+}
+
+/**
+ * @brief Create the key releasing the buffers
+ * 
+ */
+static void trace_createKey(void) {
+    pthread_key_create(&trace_key, trace_release);
+}
+
+/**
+ * @brief Find a buffer for the calling thread: a released one if any,
+ *        otherwise a new one
+ * 
+ * @return trace_buffer_t* - Buffer of the thread, NULL if out of memory
+ */
+static trace_buffer_t* trace_acquire(void) {
+    //========== Variables declaration
+    trace_buffer_t* buffer;                      // Buffer of the thread
+    int             expected;                    // Expected owner flag
+
+    pthread_once(&trace_keyOnce, trace_createKey);
+    trace_tid = atomic_fetch_add(&trace_lastTid, 1) + 1;
+
+    //========== Reuse a released buffer
+    for (buffer = atomic_load(&trace_buffers); buffer; buffer = buffer->next) {
+        expected = 0;
+        if (atomic_compare_exchange_strong(&buffer->owned, &expected, 1))
+            break;
+    }
+
+    //========== Create a new buffer
+    if (!buffer) {
+        // Buffers are not counted by the allocator of the context, they
+        // outlive their thread
+        buffer = malloc(sizeof(*buffer));
+        if (!buffer)
+            return NULL;
+        atomic_init(&buffer->owned, 1);
+        atomic_init(&buffer->head, 0);
+        buffer->next = atomic_load(&trace_buffers);
+        while (!atomic_compare_exchange_weak(&trace_buffers, &buffer->next, buffer));
+    }
+
+    pthread_setspecific(trace_key, buffer);
+    return buffer;
+}
+
+/**
+ * @brief Record an event on the calling thread
+ * 
+ * @param name Name of the scope
+ * @param category Category of the scope
+ * @param phase 'B' or 'E'
+ */
+static void trace_record(const char* name, const char* category, char phase) {
+    //========== Variables declaration
+    trace_event_t* event;                        // Slot of the event
+    size_t         head;                         // Number of events written
+
+    if (!atomic_load_explicit(&trace_enabled, memory_order_relaxed))
+        return;
+    if (!trace_local)
+        trace_local = trace_acquire();
+    if (!trace_local)
+        return;
+
+    head            = atomic_load_explicit(&trace_local->head, memory_order_relaxed);
+    event           = &trace_local->events[head % TRACE_BUFFER_SIZE];
+    event->time     = prof_now();
+    event->name     = name;
+    event->category = category;
+    event->tid      = trace_tid;
+    event->phase    = phase;
+    atomic_store_explicit(&trace_local->head, head + 1, memory_order_release);
+}
+
+//========== Functions
+void trace_start(void) {
+    //========== Variables declaration
+    trace_buffer_t* buffer;                      // Buffer to clear
+
+    for (buffer = atomic_load(&trace_buffers); buffer; buffer = buffer->next)
+        atomic_store(&buffer->head, 0);
+    atomic_store(&trace_enabled, 1);
+}
+
+void trace_stop(void) {
+    atomic_store(&trace_enabled, 0);
+}
+
+void trace_begin(const char* name, const char* category) {
+    trace_record(name, category, 'B');
+}
+
+void trace_end(const char* name, const char* category) {
+    trace_record(name, category, 'E');
+}
+
+/**
+ * @brief Write a JSON string, escaping the quotes and backslashes
+ * 
+ * @param file File to write
+ * @param string String to write
+ */
+static void trace_writeString(FILE* file, const char* string) {
+    fputc('"', file);
+    for (; string && *string; string=string+1) {
+        if (*string == '"' || *string == '\\')
+            fputc('\\', file);
+        fputc(*string, file);
+    }
+    fputc('"', file);
+}
+
+int trace_write(const char* filename) {
+    //========== Variables declaration
+    FILE*           file;                        // File to write
+    trace_buffer_t* buffer;                      // Buffer being written
+    trace_event_t*  event;                       // Event being written
+    size_t          head;                        // Number of events of the buffer
+    size_t          first;                       // First event still in the buffer
+    size_t          nbEvents;                    // Number of events written
+    size_t          nbDropped = 0;               // Number of unmatched ends dropped
+    unsigned        tid;                         // Thread of the previous event of the buffer
+    size_t          depth;                       // Number of scopes of the thread open in the buffer
+
+    //========== Check arguments
+    assert(filename && filename[0], "Filename cannot be NULL or empty", -1);
+
+    //========== Open the file
+    file = fopen(filename, "w");
+    assert(file, "Cannot open file %s", -1, filename);
+
+    //========== Write the events
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    nbEvents = 0;
+    for (buffer = atomic_load(&trace_buffers); buffer; buffer = buffer->next) {
+        head  = atomic_load_explicit(&buffer->head, memory_order_acquire);
+        first = head > TRACE_BUFFER_SIZE ? head - TRACE_BUFFER_SIZE : 0;
+        tid   = 0;
+        depth = 0;
+        for (size_t i = first; i < head; i=i+1) {
+            event = &buffer->events[i % TRACE_BUFFER_SIZE];
+
+            //----- Drop the ends whose beginning was overwritten
+            // The threads of a buffer follow each other and their scopes
+            // nest, so an end with no open scope began before the ring
+            if (event->tid != tid) {
+                tid   = event->tid;
+                depth = 0;
+            }
+            if (event->phase == 'B')
+                depth = depth + 1;
+            else if (depth)
+                depth = depth - 1;
+            else {
+                nbDropped = nbDropped + 1;
+                continue;
+            }
+
+            fprintf(file, "%s\n{\"name\":", nbEvents ? "," : "");
+            trace_writeString(file, event->name);
+            fprintf(file, ",\"cat\":");
+            trace_writeString(file, event->category);
+            fprintf(
+                file,
+                ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                event->phase,
+                (double)event->time * 1e-3,
+                event->tid
+            );
+            nbEvents = nbEvents + 1;
+        }
+    }
+    fprintf(file, "\n]}\n");
+
+    //========== Close the file
+    fclose(file);
+    PRINT(
+        SUCC, "%lu trace event(s) written to file \"%s\", %lu unmatched end(s) dropped",
+        (unsigned long)nbEvents, filename, (unsigned long)nbDropped
+    );
+
+    return 0;
+}
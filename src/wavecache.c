@@ -0,0 +1,437 @@
+/**
+ * @file wavecache.c
+ * @author OUSSET Gaël
+ * @brief Persistent on-disk cache of waveforms, keyed by the hash of the
+ *        signal parameters
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "wavecache.h"
+#include "FFT.h"
+#include "logging.h"
+#include "assert.h"
+#include "context.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <utime.h>
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+#define CACHE_MAGIC     0x5743464EU          // "NFCW"
+#define CACHE_EXTENSION ".nfcw"
+
+/**
+ * @brief Header of a cached waveform file, followed by the points
+ * 
+ */
+typedef struct {
+    uint32_t magic;                              // CACHE_MAGIC
+    uint32_t pointSize;                          // sizeof(point_t) of the writer
+    uint64_t key;                                // Key of the waveform
+    uint64_t size;                               // Number of points
+} cache_header_t;
+
+// The points of a mapped file follow the header
+_Static_assert(sizeof(cache_header_t) % _Alignof(point_t) == 0, "Cached points would be misaligned");
+
+/**
+ * @brief Mix bytes into a FNV-1a hash
+ * 
+ * @param hash Current hash
+ * @param bytes Bytes to mix
+ * @param size Number of bytes
+ * @return uint64_t - New hash
+ */
+static uint64_t cache_hash(uint64_t hash, const void* bytes, size_t size) {
+    for (size_t i = 0; i < size; i=i+1) {
+        hash = hash ^ ((const unsigned char*)bytes)[i];
+        hash = hash * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Build the path of a cached waveform
+ * 
+ * @param cache Cache
+ * @param key Key of the waveform
+ * @param extension Extension of the file
+ * @param path Buffer receiving the path
+ * @param size Size of the buffer
+ */
+static void cache_path(wavecache_t cache, uint64_t key, const char* extension, char* path, size_t size) {
+    snprintf(path, size, "%s/%016llx%s", cache->dir, (unsigned long long)key, extension);
+}
+
+/**
+ * @brief Record a read or a write of a waveform file, adding it to the
+ *        files of the cache if needed
+ * 
+ * @param cache Cache
+ * @param key Key of the waveform
+ * @param size Size of the file (bytes)
+ * @return int - 0 if success, -1 otherwise
+ */
+static int cache_index(wavecache_t cache, uint64_t key, unsigned long long size) {
+    //========== Variables declaration
+    cache_entry_t* entries;                      // Reallocated entries
+    size_t         i;                            // Index of the entry
+
+    //========== Find the entry of the file
+    for (i = 0; i < cache->nbEntries; i=i+1)
+        if (cache->entries[i].key == key)
+            break;
+
+    //========== Add it
+    if (i == cache->nbEntries) {
+        if (cache->nbEntries == cache->capacity) {
+            entries = nfc_realloc(cache->entries, (2 * cache->capacity + 16) * sizeof(cache_entry_t));
+            assert(entries, "Failed to allocate memory for the cache entries", -1);
+            cache->entries  = entries;
+            cache->capacity = 2 * cache->capacity + 16;
+        }
+        cache->entries[i].key  = key;
+        cache->entries[i].size = 0;
+        cache->nbEntries       = cache->nbEntries + 1;
+    }
+
+    //========== Update its size and use
+    cache->size               = cache->size - cache->entries[i].size + size;
+    cache->entries[i].size    = size;
+    cache->clock              = cache->clock + 1;
+    cache->entries[i].lastUse = cache->clock;
+
+    return 0;
+}
+
+/**
+ * @brief Compare the uses of two entries, for qsort()
+ * 
+ * @param a First entry
+ * @param b Second entry
+ * @return int - Negative if a was used before b, positive if after
+ */
+static int cache_compareUse(const void* a, const void* b) {
+    unsigned long long useA = ((const cache_entry_t*)a)->lastUse;
+    unsigned long long useB = ((const cache_entry_t*)b)->lastUse;
+
+    return (useA > useB) - (useA < useB);
+}
+
+/**
+ * @brief Remove the least recently used waveforms until the cache fits in
+ *        its maximum size
+ * 
+ * @param cache Cache
+ */
+static void cache_evict(wavecache_t cache) {
+    //========== Variables declaration
+    char   path[4096];                           // Path of the least recently used file
+    size_t oldest;                               // Entry of the least recently used file
+
+    while (cache->size > cache->maxSize && cache->nbEntries) {
+        //----- Find the least recently used file
+        oldest = 0;
+        for (size_t i = 1; i < cache->nbEntries; i=i+1)
+            if (cache->entries[i].lastUse < cache->entries[oldest].lastUse)
+                oldest = i;
+
+        //----- Remove it, unless it is already gone
+        cache_path(cache, cache->entries[oldest].key, CACHE_EXTENSION, path, sizeof(path));
+        PRINT(INFO, "Evicting %s (%llu bytes) from the cache", path, cache->entries[oldest].size);
+        if (remove(path) && errno != ENOENT)
+            return;
+        cache->size            = cache->size - cache->entries[oldest].size;
+        cache->nbEntries       = cache->nbEntries - 1;
+        cache->entries[oldest] = cache->entries[cache->nbEntries];
+    }
+}
+
+uint64_t cache_key(nfc_sigParam_t* sigParam, cache_kind_t kind) {
+    //========== Variables declaration
+    uint64_t hash = 0xCBF29CE484222325ULL;       // FNV-1a offset basis
+    int      encodingType  = (int)sigParam->encodingType;
+    int      subModulation = (int)sigParam->subModulation;
+    int      kindValue     = (int)kind;
+
+    //========== Hash each field, not the structure (padding)
+    hash = cache_hash(hash, NFCSIM_VERSION, sizeof(NFCSIM_VERSION));
+    hash = cache_hash(hash, &kindValue, sizeof(kindValue));
+    hash = cache_hash(hash, &sigParam->dataSize, sizeof(sigParam->dataSize));
+    hash = cache_hash(hash, sigParam->data, sigParam->dataSize);
+    hash = cache_hash(hash, &sigParam->bitRate, sizeof(sigParam->bitRate));
+    hash = cache_hash(hash, &encodingType, sizeof(encodingType));
+    hash = cache_hash(hash, &subModulation, sizeof(subModulation));
+    hash = cache_hash(hash, &sigParam->subCarrierFreq, sizeof(sigParam->subCarrierFreq));
+    hash = cache_hash(hash, &sigParam->carrierFreq, sizeof(sigParam->carrierFreq));
+    hash = cache_hash(hash, &sigParam->modulationIndex, sizeof(sigParam->modulationIndex));
+    hash = cache_hash(hash, &sigParam->noiseLevel, sizeof(sigParam->noiseLevel));
+    hash = cache_hash(hash, &sigParam->simDuration, sizeof(sigParam->simDuration));
+    hash = cache_hash(hash, &sigParam->numberOfPoints, sizeof(sigParam->numberOfPoints));
+
+    return hash;
+}
+
+int cache_open(char* dir, unsigned long long maxSize, wavecache_t* cache) {
+    //========== Variables declaration
+    struct stat    info;                         // Information on the directory, then on a file
+    DIR*           files;                        // Directory of the cache
+    struct dirent* entry;                        // File of the directory
+    char           path[4096];                   // Path of a file
+    char*          end;                          // End of the key in a file name
+    uint64_t       key;                          // Key of a file
+
+    //========== Check arguments
+    assert(dir && dir[0], "Cache directory cannot be NULL or empty", -1);
+    assert(!stat(dir, &info) && S_ISDIR(info.st_mode), "Cache directory %s does not exist", -1, dir);
+
+    //========== Allocate memory
+    *cache = nfc_calloc(1, sizeof(**cache));
+    assert(*cache, "Failed to allocate memory for the cache", -1);
+
+    (*cache)->dir = nfc_malloc(strlen(dir) + 1);
+    if (!(*cache)->dir) {
+        PRINT(ERR, "Failed to allocate memory for the cache directory");
+        nfc_free(*cache);
+        return -1;
+    }
+    strcpy((*cache)->dir, dir);
+    (*cache)->maxSize = maxSize;
+
+    //========== Measure the waveform files
+    files = opendir(dir);
+    if (!files) {
+        PRINT(ERR, "Cannot read the cache directory %s", dir);
+        cache_close(*cache);
+        return -1;
+    }
+    while ((entry = readdir(files))) {
+        key = strtoull(entry->d_name, &end, 16);
+        if (end != entry->d_name + 16 || strcmp(end, CACHE_EXTENSION))
+            continue;
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        if (stat(path, &info))
+            continue;
+        if (cache_index(*cache, key, (unsigned long long)info.st_size)) {
+            closedir(files);
+            cache_close(*cache);
+            return -1;
+        }
+        // Ordered by date below, the counter restarts after
+        (*cache)->entries[(*cache)->nbEntries - 1].lastUse = (unsigned long long)info.st_mtime;
+    }
+    closedir(files);
+
+    //========== Order the files by date
+    if ((*cache)->nbEntries)
+        qsort((*cache)->entries, (*cache)->nbEntries, sizeof(cache_entry_t), cache_compareUse);
+    for (size_t i = 0; i < (*cache)->nbEntries; i=i+1)
+        (*cache)->entries[i].lastUse = i + 1;
+    (*cache)->clock = (*cache)->nbEntries;
+
+    PRINT(INFO, "Waveform cache %s: %ld file(s), %llu bytes", dir, (*cache)->nbEntries, (*cache)->size);
+    cache_evict(*cache);
+    return 0;
+}
+
+void cache_close(wavecache_t cache) {
+    PRINT(INFO, "Waveform cache: %lu hit(s), %lu miss(es)", cache->nbHits, cache->nbMisses);
+    nfc_free(cache->entries);
+    nfc_free(cache->dir);
+    nfc_free(cache);
+}
+
+int cache_load(wavecache_t cache, uint64_t key, scatter_t* scatter) {
+    //========== Variables declaration
+    char            path[4096];                  // Path of the waveform
+    cache_header_t  header;                      // Header of the file
+    size_t          fileSize;                    // Size of the file
+    int             valid;                       // 1 if the header matches the file
+#ifndef _WIN32
+    int             fd;                          // Descriptor of the file
+    struct stat     info;                        // Size of the file
+    char*           mapping;                     // Mapping of the file
+#else
+    FILE*           file;                        // File of the waveform
+#endif
+
+    //========== Check arguments
+    assert(cache, "Cache cannot be NULL", -1);
+    cache_path(cache, key, CACHE_EXTENSION, path, sizeof(path));
+
+#ifndef _WIN32
+    //========== Map the file, the points stay in the mapping
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return 1;
+    if (fstat(fd, &info) || (size_t)info.st_size < sizeof(header)) {
+        close(fd);
+        return 1;
+    }
+    fileSize = (size_t)info.st_size;
+    // Private and writable: the points can be modified, not the file
+    mapping  = mmap(NULL, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return 1;
+
+    memcpy(&header, mapping, sizeof(header));
+    valid = header.magic     == CACHE_MAGIC     &&
+            header.pointSize == sizeof(point_t) &&
+            header.key       == key             &&
+            fileSize         == sizeof(header) + header.size * sizeof(point_t);
+    if (!valid || scatter_createMapped(scatter, mapping, fileSize, (point_t*)(mapping + sizeof(header)), (size_t)header.size)) {
+        PRINT(WARN, "Ignoring invalid cached waveform %s", path);
+        munmap(mapping, fileSize);
+        return 1;
+    }
+#else
+    //========== Read the file
+    file = fopen(path, "rb");
+    if (!file)
+        return 1;
+    fseek(file, 0, SEEK_END);
+    fileSize = (size_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    valid = fileSize >= sizeof(header) && fread(&header, sizeof(header), 1, file) == 1 &&
+            header.magic     == CACHE_MAGIC     &&
+            header.pointSize == sizeof(point_t) &&
+            header.key       == key             &&
+            fileSize         == sizeof(header) + header.size * sizeof(point_t);
+    if (!valid || scatter_create(scatter, (size_t)header.size)) {
+        PRINT(WARN, "Ignoring invalid cached waveform %s", path);
+        fclose(file);
+        return 1;
+    }
+    if (fread((*scatter)->points, sizeof(point_t), (size_t)header.size, file) != (size_t)header.size) {
+        PRINT(WARN, "Ignoring invalid cached waveform %s", path);
+        scatter_destroy(*scatter);
+        fclose(file);
+        return 1;
+    }
+    fclose(file);
+#endif
+
+    //========== Mark the waveform as recently used
+    utime(path, NULL);
+    if (cache_index(cache, key, fileSize))
+        PRINT(WARN, "Failed to index the cached waveform %s", path);
+    cache->nbHits = cache->nbHits + 1;
+    return 0;
+}
+
+int cache_store(wavecache_t cache, uint64_t key, scatter_t scatter) {
+    //========== Variables declaration
+    char           path[4096];                   // Path of the waveform
+    char           tmpPath[4096];                // Path of the file being written
+    cache_header_t header;                       // Header of the file
+    FILE*          file;                         // File of the waveform
+    int            ok;                           // 1 if the file is fully written
+#ifndef _WIN32
+    int            fd;                           // Descriptor of the temporary file
+#endif
+
+    //========== Check arguments
+    assert(cache, "Cache cannot be NULL", -1);
+    assert(scatter, "Waveform cannot be NULL", -1);
+    cache_path(cache, key, CACHE_EXTENSION, path, sizeof(path));
+    // Unique per writer, two processes may store the same waveform
+    cache_path(cache, key, ".tmp.XXXXXX", tmpPath, sizeof(tmpPath));
+
+    //========== Write in a temporary file, then rename it
+    header.magic     = CACHE_MAGIC;
+    header.pointSize = sizeof(point_t);
+    header.key       = key;
+    header.size      = scatter->size;
+
+#ifndef _WIN32
+    fd = mkstemp(tmpPath);
+    assert(fd >= 0, "Cannot create file %s", -1, tmpPath);
+    // mkstemp() creates the file for its owner only
+    fchmod(fd, 0644);
+    file = fdopen(fd, "wb");
+    if (!file) {
+        PRINT(ERR, "Cannot open file %s", tmpPath);
+        close(fd);
+        remove(tmpPath);
+        return -1;
+    }
+#else
+    assert(!_mktemp_s(tmpPath, sizeof(tmpPath)), "Cannot name file %s", -1, tmpPath);
+    file = fopen(tmpPath, "wb");
+    assert(file, "Cannot open file %s", -1, tmpPath);
+#endif
+    ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+         fwrite(scatter->points, sizeof(point_t), scatter->size, file) == scatter->size;
+    ok = !fclose(file) && ok;
+    if (!ok || rename(tmpPath, path)) {
+        PRINT(ERR, "Failed to write the cached waveform %s", path);
+        remove(tmpPath);
+        return -1;
+    }
+
+    //========== Count it, then make room
+    if (cache_index(cache, key, sizeof(header) + scatter->size * sizeof(point_t)))
+        PRINT(WARN, "Failed to index the cached waveform %s", path);
+    cache_evict(cache);
+    return 0;
+}
+
+int cache_signal(wavecache_t cache, nfc_sigParam_t* sigParam, scatter_t* signal) {
+    //========== Variables declaration
+    uint64_t key;                                // Key of the signal
+
+    //========== Noisy signals are random
+    if (!cache || sigParam->noiseLevel)
+        return nfc_createSignal(sigParam, signal);
+
+    //========== Read or generate the signal
+    key = cache_key(sigParam, CACHE_SIGNAL);
+    if (!cache_load(cache, key, signal))
+        return 0;
+
+    cache->nbMisses = cache->nbMisses + 1;
+    assert(!nfc_createSignal(sigParam, signal), "Failed to generate signal", -1);
+    if (cache_store(cache, key, *signal))
+        PRINT(WARN, "Failed to cache the signal");
+
+    return 0;
+}
+
+int cache_spectrum(wavecache_t cache, nfc_sigParam_t* sigParam, scatter_t* spectrum) {
+    //========== Variables declaration
+    uint64_t  key = 0;                           // Key of the spectrum
+    scatter_t signal;                            // Signal of the spectrum
+    int       ret;                               // Return value of the FFT
+
+    //========== Read the spectrum
+    if (cache && !sigParam->noiseLevel) {
+        key = cache_key(sigParam, CACHE_SPECTRUM);
+        if (!cache_load(cache, key, spectrum))
+            return 0;
+        cache->nbMisses = cache->nbMisses + 1;
+    }
+
+    //========== Compute the spectrum
+    assert(!nfc_createSignal(sigParam, &signal), "Failed to generate signal", -1);
+    ret = fft_Compute(signal, spectrum);
+    scatter_destroy(signal);
+    assert(!ret, "Failed to compute the spectrum", -1);
+
+    if (cache && !sigParam->noiseLevel && cache_store(cache, key, *spectrum))
+        PRINT(WARN, "Failed to cache the spectrum");
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+# Check that the kernels of the vector tiers run vector instructions: the
+# disassembly of cpu.c should use ymm registers in every kernel of the AVX2
+# tier and zmm registers in every kernel of the AVX-512 tier, except the noise
+# of the AVX2 tier which is scalar. A kernel counts the functions whose name
+# starts with it, such as the windows of the envelope.
+#
+# Usage: cmake -DOBJDUMP=objdump -DOBJECTS=<objects of the library, separated by |> -P cpu_vector.cmake
+
+string(REPLACE "|" ";" OBJECTS "${OBJECTS}")
+foreach(object IN LISTS OBJECTS)
+    if(object MATCHES "cpu\\.c\\.o(bj)?$")
+        set(CPU_OBJECT ${object})
+    endif()
+endforeach()
+if(NOT CPU_OBJECT)
+    message(FATAL_ERROR "No object of cpu.c in ${OBJECTS}")
+endif()
+
+#========== Registers used by each function
+execute_process(
+    COMMAND ${OBJDUMP} -d --no-show-raw-insn ${CPU_OBJECT}
+    OUTPUT_VARIABLE disassembly
+    RESULT_VARIABLE status
+)
+if(status)
+    message(FATAL_ERROR "Failed to disassemble ${CPU_OBJECT}")
+endif()
+string(REPLACE ";" "," disassembly "${disassembly}")
+string(REPLACE "\n" ";" lines "${disassembly}")
+set(function "")
+foreach(line IN LISTS lines)
+    if(line MATCHES "^[0-9a-f]+ <([A-Za-z0-9_.]+)>:$")
+        set(function ${CMAKE_MATCH_1})
+    elseif(line MATCHES "%ymm")
+        set(ymm_${function} 1)
+    elseif(line MATCHES "%zmm")
+        set(zmm_${function} 1)
+    endif()
+endforeach()
+
+#========== Vector registers of each kernel
+set(errors 0)
+foreach(tier AVX2 AVX512)
+    if(tier STREQUAL "AVX2")
+        set(register ymm)
+        set(kernels envelope carrier butterflies magnitude crossings)
+    else()
+        set(register zmm)
+        set(kernels envelope carrier noise butterflies magnitude crossings)
+    endif()
+    foreach(kernel IN LISTS kernels)
+        set(found 0)
+        get_cmake_property(variables VARIABLES)
+        foreach(variable IN LISTS variables)
+            if(variable MATCHES "^${register}_cpu_${kernel}[A-Za-z]*_${tier}(\\..*)?$")
+                set(found 1)
+            endif()
+        endforeach()
+        if(found)
+            message(STATUS "cpu_${kernel}_${tier}: ${register}")
+        else()
+            message(SEND_ERROR "cpu_${kernel}_${tier}: no ${register} instruction")
+            math(EXPR errors "${errors} + 1")
+        endif()
+    endforeach()
+endforeach()
+if(errors)
+    message(FATAL_ERROR "${errors} kernels without vector instructions")
+endif()
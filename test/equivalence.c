@@ -0,0 +1,1609 @@
+/**
+ * @file equivalence.c
+ * @author OUSSET Gaël
+ * @brief Check the implementations of the library against the reference
+ *        implementations, and the reference implementations against the
+ *        golden vectors
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * Usage:
+ *     equivalence <check> <golden directory>
+ *     equivalence generate <golden directory>
+ * 
+ * Each check runs the four standard modes on every CPU tier supported by
+ * the machine, and fails when the error is above the tolerance declared in
+ * equivalence_checks. A new implementation of a function is added there
+ * with its own tolerance.
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "reference.h"
+#include "nfcsig.h"
+#include "nfclazy.h"
+#include "nfctemplate.h"
+#include "FFT.h"
+#include "demod.h"
+#include "events.h"
+#include "ber.h"
+#include "sweep.h"
+#include "partial.h"
+#include "parallel.h"
+#include "prng.h"
+#include "context.h"
+#include "cpu.h"
+#include "wavecache.h"
+#include "assert.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <dirent.h>
+#include <unistd.h>
+
+/**
+ * Seed of the noise of the checked signals
+ */
+#define EQUIV_SEED 0x5EEDULL
+
+/**
+ * Noise level of the checked signals
+ */
+#define EQUIV_NOISE_LEVEL 0.1
+
+/**
+ * Number of points of the checked signals, a power of 2 for the FFT
+ */
+#define EQUIV_NB_POINTS 8192
+
+/**
+ * Number of points of the signals generated in chunks, prime so that the
+ * chunks are uneven and do not fill whole vector registers
+ */
+#define EQUIV_NB_CHUNKED_POINTS 40009
+
+/**
+ * Number of threads of the chunked generation, less than
+ * EQUIV_NB_CHUNKED_POINTS / MIN_POINTS_PER_THREAD
+ */
+#define EQUIV_NB_CHUNKS 7
+
+/**
+ * Event file written by the events check, in the working directory
+ */
+#define EQUIV_EVENTS_FILE "equivalence.nfce"
+
+/**
+ * Partial result files written by the partial check, in the working
+ * directory, with the index of the shard
+ */
+#define EQUIV_PARTIAL_FILE "equivalence_%u.partial"
+
+/**
+ * Number of shards of the partial check
+ */
+#define EQUIV_NB_SHARDS 3
+
+/**
+ * Temporary directory of the cache check, in the working directory
+ */
+#define EQUIV_CACHE_DIR "equivalence_cache_XXXXXX"
+
+/**
+ * Noise level of the BER check with errors
+ */
+#define EQUIV_BER_NOISE_LEVEL 0.5
+
+/**
+ * Numbers of frequencies of the two grids of the NUFFT check, and frames
+ * of the BER check. The CTest entries use the small sizes, the
+ * EQUIV_FULL_SIZE option of CMake restores the full ones (a full BER round
+ * then a partial one), which take about a minute.
+ */
+#ifdef EQUIV_FULL_SIZE
+    #define EQUIV_NUFFT_FREQUENCIES {256, 129}
+    #define EQUIV_BER_MAX_TRIALS    (BER_ROUND_SIZE + 8)
+#else
+    #define EQUIV_NUFFT_FREQUENCIES {32, 17}
+    #define EQUIV_BER_MAX_TRIALS    8
+#endif
+
+/**
+ * Number of points of the golden signals, and stride of their stored
+ * samples
+ */
+#define GOLDEN_NB_POINTS 2048
+#define GOLDEN_STRIDE    16
+
+//========== Structures declarations
+/**
+ * @brief Check of an implementation for a mode
+ * 
+ * @param sigParam Parameters of the signal
+ * @param error Error of the implementation
+ * @return int - 0 if the check could run, -1 otherwise
+ */
+typedef int (*equiv_check_t)(nfc_sigParam_t* sigParam, double* error);
+
+/**
+ * @brief Modes of the checked signals
+ * 
+ */
+static const struct {
+    nfc_standard_t   standard;                   // NFC standard
+    nfc_dataTransm_t dataTransm;                 // Data transmission mode
+    const char*      name;                       // Name of the mode
+    const char*      file;                       // Golden file of the mode
+} equiv_modes[] = {
+    {NFC_A, PCD,  "NFC-A PCD",  "nfc_a_pcd.golden"},
+    {NFC_A, PICC, "NFC-A PICC", "nfc_a_picc.golden"},
+    {NFC_B, PCD,  "NFC-B PCD",  "nfc_b_pcd.golden"},
+    {NFC_B, PICC, "NFC-B PICC", "nfc_b_picc.golden"}
+};
+
+/**
+ * @brief Payload of the checked signals
+ * 
+ */
+static char equiv_data[] = {(char)0xA5, (char)0x3C, (char)0x00, (char)0xFF};
+
+/**
+ * @brief Levels of the checked LCADC, not sorted
+ * 
+ */
+static double equiv_levels[] = {0.6, -0.9, 0.9, -0.6};
+
+/**
+ * Number of levels of the checked LCADC with many levels
+ */
+#define EQUIV_NB_FINE_LEVELS 40
+
+//========== Errors
+/**
+ * @brief Compare two sequences of symbols
+ * 
+ * @param a First sequence
+ * @param sizeA Size of the first sequence
+ * @param b Second sequence
+ * @param sizeB Size of the second sequence
+ * @return double - Number of different symbols, INFINITY if the sizes differ
+ */
+static double equiv_symbolError(char* a, size_t sizeA, char* b, size_t sizeB) {
+    //========== Variables declaration
+    double error = 0;                            // Number of different symbols
+
+    if (sizeA != sizeB)
+        return INFINITY;
+    for (size_t i = 0; i < sizeA; i=i+1)
+        if (!a[i] != !b[i])
+            error = error + 1;
+
+    return error;
+}
+
+/**
+ * @brief Compare a cloud of points with its reference. The times must be
+ *        equal, the amplitudes are compared relatively to the largest
+ *        amplitude of the reference (at least 1).
+ * 
+ * @param signal Cloud of points
+ * @param reference Reference cloud of points
+ * @return double - Largest normalised difference, INFINITY if the sizes or times differ
+ */
+static double equiv_scatterError(scatter_t signal, scatter_t reference) {
+    //========== Variables declaration
+    double error = 0;                            // Largest difference
+    double scale = 1;                            // Largest amplitude of the reference
+
+    if (signal->size != reference->size)
+        return INFINITY;
+    for (size_t i = 0; i < reference->size; i=i+1) {
+        if (signal->points[i].x != reference->points[i].x)
+            return INFINITY;
+        if (fabs(reference->points[i].y) > scale)
+            scale = fabs(reference->points[i].y);
+        if (fabs(signal->points[i].y - reference->points[i].y) > error || isnan(signal->points[i].y))
+            error = isnan(signal->points[i].y) ? INFINITY : fabs(signal->points[i].y - reference->points[i].y);
+    }
+
+    return error / scale;
+}
+
+//========== Checks of the implementations
+/**
+ * @brief Check nfc_encodeData(), see equiv_check_t
+ * 
+ */
+static int equiv_encode(nfc_sigParam_t* sigParam, double* error) {
+    char*  data;
+    char*  reference;
+    size_t size;
+    size_t referenceSize;
+
+    if (nfc_encodeData(sigParam, &data, &size) || ref_encodeData(sigParam, &reference, &referenceSize))
+        return -1;
+    *error = equiv_symbolError(data, size, reference, referenceSize);
+    nfc_free(data);
+    free(reference);
+    return 0;
+}
+
+/**
+ * @brief Check nfc_modulateSubCarrier(), see equiv_check_t
+ * 
+ */
+static int equiv_subCarrier(nfc_sigParam_t* sigParam, double* error) {
+    char*  encoded;
+    size_t encodedSize;
+    char*  data;
+    char*  reference;
+    size_t size;
+    size_t referenceSize;
+
+    if (ref_encodeData(sigParam, &encoded, &encodedSize))
+        return -1;
+    if (nfc_modulateSubCarrier(encoded, encodedSize, sigParam, &data, &size) ||
+        ref_modulateSubCarrier(encoded, encodedSize, sigParam, &reference, &referenceSize)) {
+        free(encoded);
+        return -1;
+    }
+    *error = equiv_symbolError(data, size, reference, referenceSize);
+    free(encoded);
+    nfc_free(data);
+    free(reference);
+    return 0;
+}
+
+/**
+ * @brief Check nfc_createEnvelope(), see equiv_check_t
+ * 
+ */
+static int equiv_envelope(nfc_sigParam_t* sigParam, double* error) {
+    char*     encoded;
+    size_t    encodedSize;
+    char*     subModulated;
+    size_t    subModulatedSize;
+    scatter_t envelope;
+    scatter_t reference;
+    int       status = -1;
+
+    if (ref_encodeData(sigParam, &encoded, &encodedSize))
+        return -1;
+    if (!ref_modulateSubCarrier(encoded, encodedSize, sigParam, &subModulated, &subModulatedSize)) {
+        if (!nfc_createEnvelope(subModulated, subModulatedSize, sigParam, &envelope)) {
+            if (!ref_createEnvelope(subModulated, subModulatedSize, sigParam, &reference)) {
+                *error = equiv_scatterError(envelope, reference);
+                status = 0;
+                scatter_destroy(reference);
+            }
+            scatter_destroy(envelope);
+        }
+        free(subModulated);
+    }
+    free(encoded);
+    return status;
+}
+
+/**
+ * @brief Check nfc_modulate(), nfc_modulateInto() and nfc_modulateInPlace()
+ *        on the reference envelope, see equiv_check_t
+ * 
+ */
+static int equiv_modulate(nfc_sigParam_t* sigParam, double* error) {
+    char*     encoded;
+    size_t    encodedSize;
+    char*     subModulated;
+    size_t    subModulatedSize;
+    scatter_t envelope;
+    scatter_t reference;
+    scatter_t modulated;
+    int       status = -1;
+
+    if (ref_encodeData(sigParam, &encoded, &encodedSize))
+        return -1;
+    if (ref_modulateSubCarrier(encoded, encodedSize, sigParam, &subModulated, &subModulatedSize)) {
+        free(encoded);
+        return -1;
+    }
+    if (!ref_createEnvelope(subModulated, subModulatedSize, sigParam, &envelope)) {
+        if (!ref_modulate(envelope, sigParam, &reference)) {
+            if (!nfc_modulate(envelope, sigParam, &modulated)) {
+                *error = equiv_scatterError(modulated, reference);
+                status = 0;
+                scatter_destroy(modulated);
+            }
+            if (!status && !nfc_modulateInPlace(envelope, sigParam))
+                *error = fmax(*error, equiv_scatterError(envelope, reference));
+            else
+                status = -1;
+            scatter_destroy(reference);
+        }
+        scatter_destroy(envelope);
+    }
+    free(encoded);
+    free(subModulated);
+    return status;
+}
+
+/**
+ * @brief Check nfc_addNoise() and nfc_addNoiseInPlace(), see equiv_check_t
+ * 
+ */
+static int equiv_noise(nfc_sigParam_t* sigParam, double* error) {
+    nfc_context_t context = nfc_contextGet();
+    scatter_t     clean;
+    scatter_t     noisy;
+    scatter_t     reference;
+    int           status = -1;
+
+    if (scatter_create(&clean, sigParam->numberOfPoints))
+        return -1;
+    for (size_t i = 0; i < clean->size; i=i+1) {
+        clean->points[i].x = (int)i;
+        clean->points[i].y = sin((double)i * 0.01);
+    }
+    if (!ref_addNoise(clean, sigParam, EQUIV_SEED, &reference)) {
+        nfc_contextSeed(context, EQUIV_SEED);
+        if (!nfc_addNoise(clean, sigParam, &noisy)) {
+            *error = equiv_scatterError(noisy, reference);
+            status = 0;
+            scatter_destroy(noisy);
+        }
+        nfc_contextSeed(context, EQUIV_SEED);
+        if (!status && !nfc_addNoiseInPlace(clean, sigParam))
+            *error = fmax(*error, equiv_scatterError(clean, reference));
+        else
+            status = -1;
+        scatter_destroy(reference);
+    }
+    scatter_destroy(clean);
+    return status;
+}
+
+/**
+ * @brief Check nfc_createSignal(), see equiv_check_t
+ * 
+ */
+static int equiv_signal(nfc_sigParam_t* sigParam, double* error) {
+    scatter_t signal;
+    scatter_t reference;
+
+    nfc_contextSeed(nfc_contextGet(), EQUIV_SEED);
+    if (nfc_createSignal(sigParam, &signal))
+        return -1;
+    if (ref_createSignal(sigParam, EQUIV_SEED, &reference)) {
+        scatter_destroy(signal);
+        return -1;
+    }
+    *error = equiv_scatterError(signal, reference);
+    scatter_destroy(signal);
+    scatter_destroy(reference);
+    return 0;
+}
+
+/**
+ * @brief Check nfc_lazyRange() on the whole signal and on a range starting
+ *        inside a transition, see equiv_check_t
+ * 
+ */
+static int equiv_lazy(nfc_sigParam_t* sigParam, double* error) {
+    nfc_lazySig_t lazySig;
+    scatter_t     signal;
+    scatter_t     range;
+    scatter_t     reference;
+    size_t        first = sigParam->numberOfPoints / 3;
+    int           status = -1;
+
+    if (ref_createSignal(sigParam, EQUIV_SEED, &reference))
+        return -1;
+    if (!nfc_lazyCreate(sigParam, EQUIV_SEED, &lazySig)) {
+        if (!nfc_lazyRange(lazySig, 0, sigParam->numberOfPoints, &signal)) {
+            *error = equiv_scatterError(signal, reference);
+            scatter_destroy(signal);
+            if (!nfc_lazyRange(lazySig, first, sigParam->numberOfPoints, &range)) {
+                // Compare the range with the end of the reference
+                reference->points = reference->points + first;
+                reference->size   = reference->size - first;
+                *error = fmax(*error, equiv_scatterError(range, reference));
+                reference->points = reference->points - first;
+                reference->size   = reference->size + first;
+                scatter_destroy(range);
+                status = 0;
+            }
+        }
+        nfc_lazyDestroy(lazySig);
+    }
+    scatter_destroy(reference);
+    return status;
+}
+
+/**
+ * @brief Check nfc_templateSignal(), which must give the signal of
+ *        nfc_createSignal() on every mode, see equiv_check_t
+ * 
+ */
+static int equiv_template(nfc_sigParam_t* sigParam, double* error) {
+    nfc_template_t tpl;
+    scatter_t      signal;
+    scatter_t      reference;
+
+    if (nfc_templateCreate(sigParam, &tpl))
+        return -1;
+    nfc_contextSeed(nfc_contextGet(), EQUIV_SEED);
+    if (nfc_templateSignal(tpl, sigParam, &signal)) {
+        nfc_templateDestroy(tpl);
+        return -1;
+    }
+    nfc_templateDestroy(tpl);
+    if (ref_createSignal(sigParam, EQUIV_SEED, &reference)) {
+        scatter_destroy(signal);
+        return -1;
+    }
+    *error = equiv_scatterError(signal, reference);
+    scatter_destroy(signal);
+    scatter_destroy(reference);
+    return 0;
+}
+
+/**
+ * @brief Check fft_Compute() on the reference signal, see equiv_check_t
+ * 
+ */
+static int equiv_fft(nfc_sigParam_t* sigParam, double* error) {
+    scatter_t signal;
+    scatter_t spectrum;
+    scatter_t reference;
+    int       status = -1;
+
+    if (ref_createSignal(sigParam, EQUIV_SEED, &signal))
+        return -1;
+    if (!fft_Compute(signal, &spectrum)) {
+        if (!ref_fftCompute(signal, &reference)) {
+            *error = equiv_scatterError(spectrum, reference);
+            status = 0;
+            scatter_destroy(reference);
+        }
+        scatter_destroy(spectrum);
+    }
+    scatter_destroy(signal);
+    return status;
+}
+
+/**
+ * @brief Check fft_NonUniform() on the LCADC samples of the reference
+ *        signal, from 0 Hz and around the carrier with an odd number of
+ *        frequencies, see equiv_check_t
+ * 
+ */
+static int equiv_nufft(nfc_sigParam_t* sigParam, double* error) {
+    scatter_t signal;
+    scatter_t samples;
+    scatter_t spectrum;
+    scatter_t reference;
+    double    fStart[2]        = {0, 10e6};
+    double    fStep[2]         = {200e3, 31.7e3};
+    size_t    nbFrequencies[2] = EQUIV_NUFFT_FREQUENCIES;
+    int       status           = 0;
+
+    if (ref_createSignal(sigParam, EQUIV_SEED, &signal))
+        return -1;
+    if (ref_LCADC(signal, equiv_levels, sizeof(equiv_levels) / sizeof(*equiv_levels), 0, &samples)) {
+        scatter_destroy(signal);
+        return -1;
+    }
+    *error = 0;
+    for (size_t grid = 0; grid < 2 && !status; grid=grid+1) {
+        status = -1;
+        if (!fft_NonUniform(samples, fStart[grid], fStep[grid], nbFrequencies[grid], &spectrum)) {
+            if (!ref_fftNonUniform(samples, fStart[grid], fStep[grid], nbFrequencies[grid], &reference)) {
+                *error = fmax(*error, equiv_scatterError(spectrum, reference));
+                status = 0;
+                scatter_destroy(reference);
+            }
+            scatter_destroy(spectrum);
+        }
+    }
+    scatter_destroy(samples);
+    scatter_destroy(signal);
+    return status;
+}
+
+/**
+ * @brief Check LCADC() on the reference signal, with and without skipped
+ *        crossings, see equiv_check_t
+ * 
+ */
+static int equiv_lcadc(nfc_sigParam_t* sigParam, double* error) {
+    scatter_t    signal;
+    scatter_t    samples;
+    scatter_t    reference;
+    double       fineLevels[EQUIV_NB_FINE_LEVELS];
+    double*      levels[2]   = {equiv_levels, fineLevels};
+    unsigned int nbLevels[2] = {sizeof(equiv_levels) / sizeof(*equiv_levels), EQUIV_NB_FINE_LEVELS};
+    int          status      = 0;
+
+    // Many levels, in descending order
+    for (size_t l = 0; l < EQUIV_NB_FINE_LEVELS; l=l+1)
+        fineLevels[l] = 1 - 2 * ((double)l + 0.5) / EQUIV_NB_FINE_LEVELS;
+
+    if (ref_createSignal(sigParam, EQUIV_SEED, &signal))
+        return -1;
+    *error = 0;
+    for (size_t set = 0; set < 2 && !status; set=set+1) {
+        for (unsigned int skip = 0; skip <= 2 && !status; skip=skip+2) {
+            status = -1;
+            if (!LCADC(signal, levels[set], nbLevels[set], skip, &samples)) {
+                if (!ref_LCADC(signal, levels[set], nbLevels[set], skip, &reference)) {
+                    *error = fmax(*error, equiv_scatterError(samples, reference));
+                    status = 0;
+                    scatter_destroy(reference);
+                }
+                scatter_destroy(samples);
+            }
+        }
+    }
+    scatter_destroy(signal);
+    return status;
+}
+
+/**
+ * @brief Check LCADC_batch() on the reference signal, the samples against
+ *        ref_LCADC() and the relative reconstruction error against
+ *        ref_LCADCHoldError(), see equiv_check_t
+ * 
+ */
+static int equiv_lcadcBatch(nfc_sigParam_t* sigParam, double* error) {
+    scatter_t      signal;
+    scatter_t      reference;
+    double         fineLevels[EQUIV_NB_FINE_LEVELS];
+    double         zero[1]    = {0};
+    double         rmsError;
+    LCADC_config_t configs[4] = {
+        {equiv_levels, sizeof(equiv_levels) / sizeof(*equiv_levels), 0},
+        {equiv_levels, sizeof(equiv_levels) / sizeof(*equiv_levels), 1},
+        {fineLevels,   EQUIV_NB_FINE_LEVELS,                         0},
+        {zero,         1,                                            3}
+    };
+    LCADC_result_t results[4];
+    int            status     = 0;
+
+    for (size_t l = 0; l < EQUIV_NB_FINE_LEVELS; l=l+1)
+        fineLevels[l] = 1 - 2 * ((double)l + 0.5) / EQUIV_NB_FINE_LEVELS;
+
+    if (ref_createSignal(sigParam, EQUIV_SEED, &signal))
+        return -1;
+    if (LCADC_batch(signal, configs, 4, 1, results)) {
+        scatter_destroy(signal);
+        return -1;
+    }
+    *error = 0;
+    for (size_t c = 0; c < 4 && !status; c=c+1) {
+        status = -1;
+        if (!ref_LCADC(signal, configs[c].levels, configs[c].nbLevels, configs[c].skip, &reference)) {
+            if (!ref_LCADCHoldError(signal, configs[c].levels, configs[c].nbLevels, configs[c].skip, &rmsError)) {
+                *error = fmax(*error, equiv_scatterError(results[c].samples, reference));
+                *error = fmax(*error, results[c].nbSamples == reference->size ? 0 : INFINITY);
+                *error = fmax(*error, fabs(results[c].rmsError - rmsError) / fmax(rmsError, 1e-300));
+                status = 0;
+            }
+            scatter_destroy(reference);
+        }
+    }
+    for (size_t c = 0; c < 4; c=c+1)
+        scatter_destroy(results[c].samples);
+    scatter_destroy(signal);
+    return status;
+}
+
+/**
+ * @brief Check that demod_frame() decodes the noisy reference signal, and
+ *        the same signal delayed by a third of a chip, see equiv_check_t.
+ *        The error is the number of wrong bits.
+ * 
+ */
+static int equiv_demod(nfc_sigParam_t* sigParam, double* error) {
+    scatter_t signal;
+    demod_t   demod;
+    char      data[sizeof(equiv_data)];
+    int       delay;
+    int       status = 0;
+
+    if (ref_createSignal(sigParam, EQUIV_SEED, &signal))
+        return -1;
+    if (demod_create(sigParam, signal->size, &demod)) {
+        scatter_destroy(signal);
+        return -1;
+    }
+    *error = 0;
+    delay  = (int)nfc_symbolDuration(sigParam) / 3;
+    for (size_t pass = 0; pass < 2 && !status; pass=pass+1) {
+        if (pass)
+            for (size_t i = 0; i < signal->size; i=i+1)
+                signal->points[i].x = signal->points[i].x + delay;
+        status = demod_frame(demod, signal, data);
+        for (size_t b = 0; b < 8 * sigParam->dataSize && !status; b=b+1)
+            *error = *error + (((data[b/8] ^ sigParam->data[b/8]) >> (b%8)) & 0x01);
+    }
+    demod_destroy(demod);
+    scatter_destroy(signal);
+    return status;
+}
+
+/**
+ * @brief Check that ber_run() finds no error without noise, and that the
+ *        counts of a noise level do not depend on the other levels of the
+ *        run, see equiv_check_t. The error is the number of differences.
+ * 
+ */
+static int equiv_ber(nfc_sigParam_t* sigParam, double* error) {
+    ber_config_t config;
+    ber_result_t results[2];
+    ber_result_t alone;
+    double       noiseLevels[2] = {0, EQUIV_BER_NOISE_LEVEL};
+
+    // The frames have 4 points per period of the carrier
+    config.standard       = sigParam->encodingType == NRZ ? NFC_B : NFC_A;
+    config.dataTransm     = sigParam->encodingType == MOD_MILLER || sigParam->subModulation == NONE ? PCD : PICC;
+    config.bitRate        = sigParam->bitRate;
+    config.dataSize       = sigParam->dataSize;
+    config.numberOfPoints = 2 * EQUIV_NB_POINTS;
+    config.noiseLevels    = noiseLevels;
+    config.nbNoiseLevels  = 2;
+    config.maxTrials      = EQUIV_BER_MAX_TRIALS;
+    config.minErrors      = 1;
+    config.precision      = 1;
+    config.seed           = EQUIV_SEED;
+    if (ber_run(&config, results))
+        return -1;
+
+    config.noiseLevels   = &noiseLevels[1];
+    config.nbNoiseLevels = 1;
+    if (ber_run(&config, &alone))
+        return -1;
+
+    *error = (double)(results[0].nbBitErrors + results[0].nbFrameErrors) +
+             (results[1].nbFrames      != alone.nbFrames) +
+             (results[1].nbBitErrors   != alone.nbBitErrors) +
+             (results[1].nbFrameErrors != alone.nbFrameErrors);
+    return 0;
+}
+
+/**
+ * @brief Measure of the sweep check: error of the signal of a point against
+ *        the reference with the seed of the point, see sweep_measure_t
+ * 
+ */
+static int equiv_sweepMeasure(void* user, size_t index, nfc_sigParam_t* sigParam, scatter_t signal, double* values) {
+    scatter_t reference;
+
+    if (ref_createSignal(sigParam, prng_hash(EQUIV_SEED, index), &reference))
+        return -1;
+    values[0]              = equiv_scatterError(signal, reference);
+    ((double*)user)[index] = values[0];
+    scatter_destroy(reference);
+    return 0;
+}
+
+/**
+ * @brief Check the signals of sweep_run() over the noise level and the
+ *        modulation index, that a line is written per point and that the
+ *        envelope is only generated once per modulation index and chunk,
+ *        see equiv_check_t
+ * 
+ */
+static int equiv_sweep(nfc_sigParam_t* sigParam, double* error) {
+    sweep_grid_t  grid;
+    double        noiseLevels[]       = {0, EQUIV_NOISE_LEVEL, 2 * EQUIV_NOISE_LEVEL};
+    double        modulationIndices[] = {10, 100};
+    double        errors[6];
+    const char*   names[]             = {"error"};
+    unsigned long nbRuns[NB_STAGES];
+    FILE*         results;
+    int           c;
+    size_t        nbLines             = 0;
+
+    grid.base    = *sigParam;
+    grid.axes[0] = (sweep_axis_t){FIELD_NOISE_LEVEL,      noiseLevels,       3};
+    grid.axes[1] = (sweep_axis_t){FIELD_MODULATION_INDEX, modulationIndices, 2};
+    grid.nbAxes  = 2;
+    grid.seed    = EQUIV_SEED;
+
+    results = tmpfile();
+    if (!results)
+        return -1;
+    if (sweep_run(&grid, equiv_sweepMeasure, errors, 1, names, results, nbRuns)) {
+        fclose(results);
+        return -1;
+    }
+    rewind(results);
+    while ((c = fgetc(results)) != EOF)
+        nbLines = nbLines + (c == '\n');
+    fclose(results);
+
+    *error = 0;
+    for (size_t i = 0; i < 6; i=i+1)
+        *error = fmax(*error, errors[i]);
+    if (nbLines != 7 || nbRuns[STAGE_NOISE] != 6 || nbRuns[STAGE_ENVELOPE] + 1 > 2 + parallel_nbThreads())
+        *error = INFINITY;
+    return 0;
+}
+
+/**
+ * @brief Write the partial results of the shards of the partial check:
+ *        histogram, exact sums of the amplitudes and of their squares,
+ *        size of the signal and some points, then read them back merged
+ * 
+ * @param signal Signal of the check
+ * @param nbShards Number of shards
+ * @param merged Merged results
+ * @return int - 0 if success, -1 otherwise
+ */
+static int equiv_shards(scatter_t signal, unsigned int nbShards, partial_t* merged) {
+    partial_t        partial;
+    partial_entry_t* entry;
+    shard_t          shard;
+    char             names[EQUIV_NB_SHARDS][64];
+    const char*      files[EQUIV_NB_SHARDS];
+    const char*      columns[] = {"index", "y"};
+    double           row[2];
+    size_t           first;
+    size_t           last;
+    int              status    = 0;
+
+    for (shard.index = 0, shard.count = nbShards; shard.index < nbShards && !status; shard.index=shard.index+1) {
+        snprintf(names[shard.index], sizeof(names[shard.index]), EQUIV_PARTIAL_FILE, shard.index);
+        files[shard.index] = names[shard.index];
+        if (partial_create("equivalence", "partial check", &shard, &partial))
+            return -1;
+        shard_range(&shard, signal->size, &first, &last);
+
+        status = partial_entry(partial, "histogram", PARTIAL_COUNTS, 16, &entry);
+        for (size_t i = first; i < last && !status; i=i+1)
+            entry->counts[(size_t)fmin(fmax((signal->points[i].y + 2) * 4, 0), 15)] += 1;
+        status = status || partial_entry(partial, "moments", PARTIAL_SUMS, 2, &entry);
+        for (size_t i = first; i < last && !status; i=i+1)
+            status = partial_sumAdd(&entry->sums[0], signal->points[i].y) ||
+                     partial_sumAdd(&entry->sums[1], signal->points[i].y * signal->points[i].y);
+        status = status || partial_entry(partial, "size", PARTIAL_VALUES, 1, &entry);
+        if (!status)
+            entry->values[0] = (double)signal->size;
+        status = status || partial_entry(partial, "points", PARTIAL_ROWS, 2, &entry) || partial_setColumns(entry, columns);
+        for (size_t i = first; i < last && !status; i=i+1) {
+            row[0] = (double)i;
+            row[1] = signal->points[i].y;
+            if (i % 64 == 0)
+                status = partial_addRow(entry, row);
+        }
+        status = status || partial_write(partial, files[shard.index]);
+        partial_destroy(partial);
+    }
+
+    // The files are read in reverse order, the merge does not depend on it
+    for (unsigned int s = 0; s < nbShards / 2 && !status; s=s+1) {
+        files[s]                = names[nbShards - 1 - s];
+        files[nbShards - 1 - s] = names[s];
+    }
+    status = status || partial_readAll(files, nbShards, merged);
+    for (unsigned int s = 0; s < nbShards; s=s+1)
+        remove(names[s]);
+    return status;
+}
+
+/**
+ * @brief Check that the partial results of 3 shards, merged, are the same
+ *        as the ones of a single shard, and that the exact sums are the
+ *        sums of the amplitudes, see equiv_check_t. The error is the
+ *        number of differences.
+ * 
+ */
+static int equiv_partial(nfc_sigParam_t* sigParam, double* error) {
+    scatter_t        signal;
+    partial_t        single;
+    partial_t        merged;
+    partial_entry_t* a;
+    partial_entry_t* b;
+    double           sum     = 0;
+    int              status  = -1;
+
+    if (ref_createSignal(sigParam, EQUIV_SEED, &signal))
+        return -1;
+    if (equiv_shards(signal, 1, &single)) {
+        scatter_destroy(signal);
+        return -1;
+    }
+    if (!equiv_shards(signal, EQUIV_NB_SHARDS, &merged)) {
+        status = 0;
+        *error = !partial_complete(merged) + (merged->nbEntries != single->nbEntries);
+
+        a = partial_find(single, "histogram");
+        b = partial_find(merged, "histogram");
+        *error = *error + (!b || memcmp(a->counts, b->counts, a->size * sizeof(*a->counts)));
+
+        a = partial_find(single, "moments");
+        b = partial_find(merged, "moments");
+        for (size_t i = 0; i < 2 && b; i=i+1)
+            *error = *error + (partial_sumValue(&a->sums[i]) != partial_sumValue(&b->sums[i]));
+        // The naive sum only agrees with the exact one up to its rounding
+        for (size_t i = 0; i < signal->size; i=i+1)
+            sum = sum + signal->points[i].y;
+        *error = *error + (!b || fabs(partial_sumValue(&b->sums[0]) - sum) > 1e-9 * (double)signal->size);
+
+        a = partial_find(single, "points");
+        b = partial_find(merged, "points");
+        *error = *error + (!b || a->nbRows != b->nbRows ||
+                           memcmp(a->values, b->values, a->nbRows * a->size * sizeof(double)));
+        b = partial_find(merged, "size");
+        *error = *error + (!b || b->values[0] != (double)signal->size);
+        partial_destroy(merged);
+    }
+    partial_destroy(single);
+    scatter_destroy(signal);
+    return status;
+}
+
+/**
+ * @brief Check that LCADC samples written with events_save() are read back
+ *        exactly by events_load(), and that events_seek() stops on the
+ *        first sample at or after the time, see equiv_check_t
+ * 
+ */
+static int equiv_events(nfc_sigParam_t* sigParam, double* error) {
+    scatter_t       signal;
+    scatter_t       samples;
+    scatter_t       loaded;
+    events_reader_t reader;
+    double          fineLevels[EQUIV_NB_FINE_LEVELS];
+    point_t         event;
+    size_t          nbRead;
+    size_t          first;
+    int             time;
+    int             status = -1;
+
+    for (size_t l = 0; l < EQUIV_NB_FINE_LEVELS; l=l+1)
+        fineLevels[l] = 1 - 2 * ((double)l + 0.5) / EQUIV_NB_FINE_LEVELS;
+
+    if (ref_createSignal(sigParam, EQUIV_SEED, &signal))
+        return -1;
+    if (ref_LCADC(signal, fineLevels, EQUIV_NB_FINE_LEVELS, 0, &samples)) {
+        scatter_destroy(signal);
+        return -1;
+    }
+    if (!events_save(EQUIV_EVENTS_FILE, samples, fineLevels, EQUIV_NB_FINE_LEVELS) &&
+        !events_load(EQUIV_EVENTS_FILE, &loaded)) {
+        *error = equiv_scatterError(loaded, samples);
+        scatter_destroy(loaded);
+
+        //----- Seek times before, inside and after the samples
+        if (!events_readerOpen(EQUIV_EVENTS_FILE, &reader)) {
+            status = 0;
+            for (size_t s = 0; s <= 64 && !status; s=s+1) {
+                time  = (int)((double)s / 64 * (double)signal->points[signal->size - 1].x) - 1;
+                first = 0;
+                while (first < samples->size && samples->points[first].x < time)
+                    first = first + 1;
+                if (events_seek(reader, time) || events_read(reader, &event, 1, &nbRead))
+                    status = -1;
+                else if (nbRead != (first < samples->size) ||
+                         (nbRead && (event.x != samples->points[first].x || event.y != samples->points[first].y)))
+                    *error = INFINITY;
+            }
+            events_readerClose(reader);
+        }
+    }
+    remove(EQUIV_EVENTS_FILE);
+    scatter_destroy(samples);
+    scatter_destroy(signal);
+    return status;
+}
+
+/**
+ * @brief Check LCADC_streamPush() on the reference signal fed in blocks of
+ *        irregular sizes, with a buffer of samples smaller than the number
+ *        of levels, see equiv_check_t
+ * 
+ */
+static int equiv_lcadcStream(nfc_sigParam_t* sigParam, double* error) {
+    scatter_t      signal;
+    scatter_t      reference;
+    scatter_t      samples;
+    LCADC_stream_t stream;
+    point_t        buffer[3];
+    size_t         nbSamples = 0;
+    size_t         consumed  = 0;
+    size_t         written;
+    size_t         pushed;
+    size_t         block;
+    int            status    = -1;
+
+    if (ref_createSignal(sigParam, EQUIV_SEED, &signal))
+        return -1;
+    if (ref_LCADC(signal, equiv_levels, sizeof(equiv_levels) / sizeof(*equiv_levels), 1, &reference)) {
+        scatter_destroy(signal);
+        return -1;
+    }
+    if (scatter_create(&samples, reference->size + 1) ||
+        LCADC_streamCreate(equiv_levels, sizeof(equiv_levels) / sizeof(*equiv_levels), 1, &stream)) {
+        scatter_destroy(signal);
+        scatter_destroy(reference);
+        return -1;
+    }
+
+    for (size_t push = 0; push < 4 * signal->size; push=push+1) {
+        block = consumed < signal->size ? (push * 37 + 1) % 701 : 0;
+        if (block > signal->size - consumed)
+            block = signal->size - consumed;
+        if (LCADC_streamPush(stream, signal->points + consumed, block, buffer, sizeof(buffer) / sizeof(*buffer), &written, &pushed))
+            break;
+        // More samples than the reference fails the check below
+        for (size_t i = 0; i < written && nbSamples < samples->size; i=i+1) {
+            samples->points[nbSamples] = buffer[i];
+            nbSamples = nbSamples + 1;
+        }
+        consumed = consumed + pushed;
+        if (consumed == signal->size && !written) {
+            status = 0;
+            break;
+        }
+    }
+
+    samples->size = nbSamples;
+    *error = equiv_scatterError(samples, reference);
+    LCADC_streamDestroy(stream);
+    scatter_destroy(samples);
+    scatter_destroy(reference);
+    scatter_destroy(signal);
+    return status;
+}
+
+/**
+ * @brief Counting allocator of the allocator check
+ * 
+ */
+typedef struct {
+    unsigned long nbAlloc;                       // Number of blocks allocated or resized
+    unsigned long nbFree;                        // Number of blocks freed or resized
+} equiv_allocator_t;
+
+/**
+ * @brief Allocate a block and count it, see nfc_allocator_t
+ * 
+ */
+static void* equiv_alloc(void* user, size_t size) {
+    ((equiv_allocator_t*)user)->nbAlloc = ((equiv_allocator_t*)user)->nbAlloc + 1;
+    return malloc(size);
+}
+
+/**
+ * @brief Resize a block and count it, see nfc_allocator_t
+ * 
+ */
+static void* equiv_realloc(void* user, void* ptr, size_t size) {
+    ((equiv_allocator_t*)user)->nbAlloc = ((equiv_allocator_t*)user)->nbAlloc + 1;
+    ((equiv_allocator_t*)user)->nbFree  = ((equiv_allocator_t*)user)->nbFree + 1;
+    return realloc(ptr, size);
+}
+
+/**
+ * @brief Free a block and count it, see nfc_allocator_t
+ * 
+ */
+static void equiv_freeBlock(void* user, void* ptr) {
+    ((equiv_allocator_t*)user)->nbFree = ((equiv_allocator_t*)user)->nbFree + 1;
+    free(ptr);
+}
+
+/**
+ * @brief Check that the blocks of a context with its own allocator are
+ *        released by that allocator when freed in another context, see
+ *        equiv_check_t. The error is the number of blocks released by the
+ *        wrong allocator or not released.
+ * 
+ */
+static int equiv_allocator(nfc_sigParam_t* sigParam, double* error) {
+    equiv_allocator_t counts[2]   = {{0, 0}, {0, 0}};
+    nfc_allocator_t   allocators[2];
+    nfc_context_t     contexts[2] = {NULL, NULL};
+    nfc_context_t     previous    = nfc_contextGet();
+    scatter_t         signal;
+    int               status      = -1;
+
+    for (size_t c = 0; c < 2; c=c+1) {
+        allocators[c] = (nfc_allocator_t){equiv_alloc, equiv_realloc, equiv_freeBlock, &counts[c]};
+        if (nfc_contextCreate(&contexts[c]))
+            goto end;
+        nfc_contextSetAllocator(contexts[c], &allocators[c]);
+        nfc_contextSetLog(contexts[c], previous->logSink, previous->logUser, previous->verbosity);
+    }
+
+    //========== Allocate in the first context, free in the second one
+    nfc_contextBind(contexts[0]);
+    nfc_contextSeed(contexts[0], EQUIV_SEED);
+    if (!nfc_createSignal(sigParam, &signal)) {
+        nfc_contextBind(contexts[1]);
+        signal->points = nfc_realloc(signal->points, signal->size * sizeof(point_t));
+        scatter_destroy(signal);
+        status = 0;
+        *error = (double)(counts[0].nbAlloc - counts[0].nbFree) + (double)(counts[1].nbAlloc + counts[1].nbFree);
+    }
+
+end:
+    nfc_contextBind(previous);
+    for (size_t c = 0; c < 2; c=c+1)
+        if (contexts[c])
+            nfc_contextDestroy(contexts[c]);
+    return status;
+}
+
+/**
+ * @brief Arguments of the chunks of the parallel check
+ * 
+ */
+typedef struct {
+    nfc_context_t  context;                      // Context of the caller
+    unsigned char* wrong;                        // 1 for each iteration run in another context or stage
+} equiv_parallelTask_t;
+
+/**
+ * @brief Allocate a block at each iteration and check its context, see
+ *        parallel_task_t
+ * 
+ */
+static void equiv_parallelChunk(void* arg, size_t first, size_t last) {
+    equiv_parallelTask_t* task = (equiv_parallelTask_t*)arg;
+
+    for (size_t i = first; i < last; i=i+1) {
+        task->wrong[i] = nfc_contextGet() != task->context || nfc_contextStage() != PROF_LCADC;
+        // Counted apart from the memory of parallel_for()
+        nfc_contextSetStage(PROF_CSV);
+        nfc_free(nfc_malloc(i + 1));
+        nfc_contextSetStage(PROF_LCADC);
+    }
+}
+
+/**
+ * @brief Check that the chunks of parallel_for() run in the context and
+ *        the stage of the caller, and that their allocations are counted
+ *        there, see equiv_check_t. The error is the number of iterations
+ *        run elsewhere plus the number of allocations not counted.
+ * 
+ */
+static int equiv_parallel(nfc_sigParam_t* sigParam, double* error) {
+    equiv_parallelTask_t task;
+    nfc_memStats_t       before;
+    nfc_memStats_t       after;
+    prof_stage_t         stage = nfc_contextStage();
+    size_t               size  = sigParam->numberOfPoints;
+
+    task.context = nfc_contextGet();
+    task.wrong   = calloc(size, 1);
+    if (!task.wrong)
+        return -1;
+
+    nfc_contextSetStage(PROF_LCADC);
+    before = nfc_contextMemStats(task.context, PROF_CSV);
+    parallel_for(size, 1, equiv_parallelChunk, &task);
+    after  = nfc_contextMemStats(task.context, PROF_CSV);
+    nfc_contextSetStage(stage);
+
+    *error = fabs((double)(after.nbAlloc - before.nbAlloc) - (double)size) +
+             fabs((double)(after.nbFree - before.nbFree) - (double)size);
+    for (size_t i = 0; i < size; i=i+1)
+        *error = *error + task.wrong[i];
+    free(task.wrong);
+    return 0;
+}
+
+/**
+ * @brief Generate a signal with nfc_createSignal() and modulate its
+ *        envelope with nfc_modulateInto(), on nbThreads threads
+ * 
+ * @param sigParam Parameters of the signal
+ * @param envelope Envelope to modulate
+ * @param nbThreads Number of threads of parallel_for()
+ * @param signal Generated signal
+ * @param modulated Modulated envelope
+ * @return int - 0 if success, -1 otherwise
+ */
+static int equiv_generate(nfc_sigParam_t* sigParam, scatter_t envelope, unsigned int nbThreads, scatter_t* signal, scatter_t* modulated) {
+    int status = -1;
+
+    parallel_setNbThreads(nbThreads);
+    nfc_contextSeed(nfc_contextGet(), EQUIV_SEED);
+    if (!nfc_createSignal(sigParam, signal)) {
+        if (!scatter_create(modulated, envelope->size)) {
+            if (!nfc_modulateInto(envelope, sigParam, *modulated))
+                status = 0;
+            else
+                scatter_destroy(*modulated);
+        }
+        if (status)
+            scatter_destroy(*signal);
+    }
+    parallel_setNbThreads(0);
+    return status;
+}
+
+/**
+ * @brief Check that nfc_createSignal() and nfc_modulateInto() give the
+ *        same points on one thread and in EQUIV_NB_CHUNKS uneven chunks,
+ *        see equiv_check_t. The error is the number of points that differ
+ *        in any bit.
+ * 
+ */
+static int equiv_chunks(nfc_sigParam_t* sigParam, double* error) {
+    nfc_sigParam_t param = *sigParam;
+    char*          encoded;
+    size_t         encodedSize;
+    char*          subModulated;
+    size_t         subModulatedSize;
+    scatter_t      envelope;
+    scatter_t      serial[2];
+    scatter_t      chunked[2];
+    int            status = -1;
+
+    param.numberOfPoints = EQUIV_NB_CHUNKED_POINTS;
+    if (ref_encodeData(&param, &encoded, &encodedSize))
+        return -1;
+    if (ref_modulateSubCarrier(encoded, encodedSize, &param, &subModulated, &subModulatedSize)) {
+        free(encoded);
+        return -1;
+    }
+    status = ref_createEnvelope(subModulated, subModulatedSize, &param, &envelope);
+    free(encoded);
+    free(subModulated);
+    if (status)
+        return -1;
+    status = -1;
+    if (!equiv_generate(&param, envelope, 1, &serial[0], &serial[1])) {
+        if (!equiv_generate(&param, envelope, EQUIV_NB_CHUNKS, &chunked[0], &chunked[1])) {
+            *error = 0;
+            for (size_t s = 0; s < 2; s=s+1) {
+                if (serial[s]->size != chunked[s]->size)
+                    *error = INFINITY;
+                else
+                    for (size_t i = 0; i < serial[s]->size; i=i+1)
+                        if (serial[s]->points[i].x != chunked[s]->points[i].x ||
+                            memcmp(&serial[s]->points[i].y, &chunked[s]->points[i].y, sizeof(double)))
+                            *error = *error + 1;
+                scatter_destroy(chunked[s]);
+            }
+            status = 0;
+        }
+        scatter_destroy(serial[0]);
+        scatter_destroy(serial[1]);
+    }
+    scatter_destroy(envelope);
+    return status;
+}
+
+/**
+ * @brief Remove the files of the directory of the cache check
+ * 
+ * @param dir Directory of the cache
+ */
+static void equiv_clearCache(const char* dir) {
+    DIR*           files = opendir(dir);
+    struct dirent* entry;
+    char           path[4096];
+
+    if (!files)
+        return;
+    while ((entry = readdir(files)))
+        if (strcmp(entry->d_name, ".") && strcmp(entry->d_name, "..")) {
+            snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+            remove(path);
+        }
+    closedir(files);
+}
+
+/**
+ * @brief Build the path of a cached waveform, see cache_store()
+ * 
+ */
+static void equiv_cachePath(const char* dir, uint64_t key, char* path, size_t size) {
+    snprintf(path, size, "%s/%016llx.nfcw", dir, (unsigned long long)key);
+}
+
+/**
+ * @brief Count the points of a loaded waveform differing from the stored
+ *        one, then destroy it
+ * 
+ */
+static double equiv_cacheDiff(scatter_t stored, scatter_t loaded) {
+    double nbDiff = 0;
+
+    if (stored->size != loaded->size)
+        nbDiff = INFINITY;
+    else
+        for (size_t i = 0; i < stored->size; i=i+1)
+            if (stored->points[i].x != loaded->points[i].x ||
+                memcmp(&stored->points[i].y, &loaded->points[i].y, sizeof(double)))
+                nbDiff = nbDiff + 1;
+    scatter_destroy(loaded);
+    return nbDiff;
+}
+
+/**
+ * @brief Return 1 if a waveform is not read from the cache
+ * 
+ */
+static double equiv_cacheMissing(wavecache_t cache, uint64_t key) {
+    scatter_t loaded;
+
+    if (cache_load(cache, key, &loaded))
+        return 1;
+    scatter_destroy(loaded);
+    return 0;
+}
+
+/**
+ * @brief Check the waveform cache in a temporary directory, see
+ *        equiv_check_t. A waveform must be read back as stored from its
+ *        private mapping, invalid files must be ignored and the least
+ *        recently used waveform evicted. The error is the number of
+ *        failed expectations.
+ * 
+ */
+static int equiv_cache(nfc_sigParam_t* sigParam, double* error) {
+    char               dir[]  = EQUIV_CACHE_DIR;
+    char               path[4096];
+    char               other[4096];
+    uint64_t           key    = cache_key(sigParam, CACHE_SIGNAL);
+    uint32_t           magic  = 0;
+    unsigned long long fileSize;
+    wavecache_t        cache;
+    scatter_t          signal;
+    scatter_t          loaded;
+    FILE*              file;
+    int                status = -1;
+
+    if (ref_createSignal(sigParam, EQUIV_SEED, &signal))
+        return -1;
+    if (!mkdtemp(dir)) {
+        scatter_destroy(signal);
+        return -1;
+    }
+    *error = 0;
+
+    //========== Round trip, the mapping is private
+    if (cache_open(dir, ULLONG_MAX, &cache))
+        goto end;
+    if (cache_store(cache, key, signal) || cache_load(cache, key, &loaded)) {
+        cache_close(cache);
+        goto end;
+    }
+    fileSize = cache->size;
+    *error   = *error + (loaded->mapping ? 0 : 1);
+    // The modified point is the only expected difference, not written back
+    loaded->points[0].y = loaded->points[0].y + 1;
+    *error   = *error + equiv_cacheDiff(signal, loaded) - 1;
+    if (cache_load(cache, key, &loaded))
+        *error = *error + 1;
+    else
+        *error = *error + equiv_cacheDiff(signal, loaded);
+
+    //========== Invalid files
+    //----- Wrong magic number
+    equiv_cachePath(dir, key + 1, path, sizeof(path));
+    if (!cache_store(cache, key + 1, signal) && (file = fopen(path, "r+b"))) {
+        fwrite(&magic, sizeof(magic), 1, file);
+        fclose(file);
+    }
+    *error = *error + 1 - equiv_cacheMissing(cache, key + 1);
+
+    //----- Truncated points
+    equiv_cachePath(dir, key + 2, path, sizeof(path));
+    if (!cache_store(cache, key + 2, signal))
+        truncate(path, (off_t)fileSize - 1);
+    *error = *error + 1 - equiv_cacheMissing(cache, key + 2);
+
+    //----- File of another waveform
+    equiv_cachePath(dir, key, path, sizeof(path));
+    equiv_cachePath(dir, key + 3, other, sizeof(other));
+    rename(path, other);
+    *error = *error + 1 - equiv_cacheMissing(cache, key + 3);
+    cache_close(cache);
+
+    //========== Eviction of the least recently used waveform
+    equiv_clearCache(dir);
+    if (cache_open(dir, 2 * fileSize + fileSize / 2, &cache))
+        goto end;
+    cache_store(cache, key, signal);
+    cache_store(cache, key + 1, signal);
+    *error = *error + equiv_cacheMissing(cache, key);
+    cache_store(cache, key + 2, signal);
+    *error = *error + (cache->size > cache->maxSize ? 1 : 0);
+    *error = *error + equiv_cacheMissing(cache, key);
+    *error = *error + 1 - equiv_cacheMissing(cache, key + 1);
+    *error = *error + equiv_cacheMissing(cache, key + 2);
+    cache_close(cache);
+    status = 0;
+
+end:
+    equiv_clearCache(dir);
+    rmdir(dir);
+    scatter_destroy(signal);
+    return status;
+}
+
+/**
+ * @brief Implementations checked against the references, with their
+ *        tolerance
+ * 
+ */
+static const struct {
+    const char*   name;                          // Name of the check
+    equiv_check_t check;                         // Check of the implementation
+    double        tolerance;                     // Largest accepted error
+} equiv_checks[] = {
+    {"encode",       equiv_encode,      0},
+    {"subcarrier",   equiv_subCarrier,  0},
+    {"envelope",     equiv_envelope,    1e-12},
+    {"modulate",     equiv_modulate,    1e-12},
+    {"noise",        equiv_noise,       1e-12},
+    {"signal",       equiv_signal,      1e-12},
+    {"lazy",         equiv_lazy,        1e-12},
+    {"template",     equiv_template,    1e-12},
+    {"fft",          equiv_fft,         1e-9},
+    {"nufft",        equiv_nufft,       1e-9},
+    {"lcadc",        equiv_lcadc,       0},
+    {"lcadc_stream", equiv_lcadcStream, 0},
+    {"lcadc_batch",  equiv_lcadcBatch,  1e-9},
+    {"events",       equiv_events,      0},
+    {"demod",        equiv_demod,       0},
+    {"ber",          equiv_ber,         0},
+    {"sweep",        equiv_sweep,       1e-12},
+    {"partial",      equiv_partial,     0},
+    {"allocator",    equiv_allocator,   0},
+    {"parallel",     equiv_parallel,    0},
+    {"chunks",       equiv_chunks,      0},
+    {"cache",        equiv_cache,       0}
+};
+
+//========== Golden vectors
+/**
+ * @brief Write a vector of the golden file
+ * 
+ * @param file Golden file
+ * @param name Name of the vector
+ * @param values Values of the vector, every stride-th one is written
+ * @param size Number of values
+ * @param stride Stride of the written values
+ */
+static void golden_write(FILE* file, const char* name, double* values, size_t size, size_t stride) {
+    fprintf(file, "%s %zu %zu\n", name, (size + stride - 1) / stride, stride);
+    for (size_t i = 0; i < size; i=i+stride)
+        fprintf(file, "%.17g\n", values[i]);
+}
+
+/**
+ * @brief Compare a vector of the golden file with values
+ * 
+ * @param file Golden file
+ * @param name Name of the vector
+ * @param values Values to compare
+ * @param size Number of values
+ * @param tolerance Largest accepted difference, relative to the largest value (at least 1)
+ * @return int - 0 if the vector matches, -1 otherwise
+ */
+static int golden_compare(FILE* file, const char* name, double* values, size_t size, double tolerance) {
+    //========== Variables declaration
+    char   fileName[64];                         // Name of the vector in the file
+    size_t count;                                // Number of values in the file
+    size_t stride;                               // Stride of the values in the file
+    double value;                                // Value read in the file
+    double error = 0;                            // Largest difference
+    double scale = 1;                            // Largest value
+
+    if (fscanf(file, "%63s %zu %zu", fileName, &count, &stride) != 3 || strcmp(fileName, name) || !stride) {
+        PRINT(ERR, "Golden vector \"%s\" not found", name);
+        return -1;
+    }
+    if (count != (size + stride - 1) / stride) {
+        PRINT(ERR, "Golden vector \"%s\" has %zu values instead of %zu", name, count, (size + stride - 1) / stride);
+        return -1;
+    }
+    for (size_t i = 0; i < size; i=i+stride) {
+        if (fscanf(file, "%lg", &value) != 1) {
+            PRINT(ERR, "Golden vector \"%s\" is truncated", name);
+            return -1;
+        }
+        scale = fmax(scale, fabs(value));
+        error = fmax(error, fabs(value - values[i]));
+    }
+    if (error / scale > tolerance) {
+        PRINT(ERR, "Golden vector \"%s\": error %g above %g", name, error / scale, tolerance);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Write or compare a vector of the golden file
+ * 
+ * @param file Golden file
+ * @param generate 1 to write the vector, 0 to compare it
+ * @param name Name of the vector
+ * @param values Values of the vector
+ * @param size Number of values
+ * @param stride Stride of the written values
+ * @param tolerance Largest accepted difference, see golden_compare
+ * @return int - 0 if success, -1 otherwise
+ */
+static int golden_vector(FILE* file, int generate, const char* name, double* values, size_t size, size_t stride, double tolerance) {
+    if (generate) {
+        golden_write(file, name, values, size, stride);
+        return 0;
+    }
+    return golden_compare(file, name, values, size, tolerance);
+}
+
+/**
+ * @brief Write or compare the golden vectors of the reference
+ *        implementations for a mode
+ * 
+ * @param path Golden file
+ * @param mode Index of the mode
+ * @param generate 1 to write the golden file, 0 to compare it
+ * @return int - 0 if success, -1 otherwise
+ */
+static int golden_mode(const char* path, size_t mode, int generate) {
+    //========== Variables declaration
+    nfc_sigParam_t sigParam;                     // Parameters of the golden signal
+    FILE*          file;                         // Golden file
+    char*          encoded          = NULL;      // Encoded data
+    size_t         encodedSize      = 0;         // Size of the encoded data
+    char*          subModulated     = NULL;      // Sub-modulated data
+    size_t         subModulatedSize = 0;         // Size of the sub-modulated data
+    scatter_t      envelope         = NULL;      // Envelope
+    scatter_t      signal           = NULL;      // Noisy signal
+    scatter_t      spectrum         = NULL;      // Spectrum of the signal
+    scatter_t      samples          = NULL;      // LCADC samples of the signal
+    double*        values           = NULL;      // Values of a vector
+    int            status           = -1;        // Status of the check
+
+    if (nfc_standardParam(equiv_data, 1, equiv_modes[mode].standard, equiv_modes[mode].dataTransm, BIT_RATE, EQUIV_NOISE_LEVEL, GOLDEN_NB_POINTS, &sigParam))
+        return -1;
+
+    file = fopen(path, generate ? "w" : "r");
+    assert(file, "Cannot open file %s", -1, path);
+
+    //========== Run the references
+    if (        ref_encodeData(&sigParam, &encoded, &encodedSize) ||
+        ref_modulateSubCarrier(encoded, encodedSize, &sigParam, &subModulated, &subModulatedSize) ||
+        ref_createEnvelope(subModulated, subModulatedSize, &sigParam, &envelope) ||
+        ref_createSignal(&sigParam, EQUIV_SEED, &signal) ||
+        ref_fftCompute(signal, &spectrum) ||
+        ref_LCADC(signal, equiv_levels, sizeof(equiv_levels) / sizeof(*equiv_levels), 0, &samples))
+        goto end;
+    values = malloc((samples->size > GOLDEN_NB_POINTS ? samples->size : GOLDEN_NB_POINTS) * sizeof(*values));
+    if (!values)
+        goto end;
+    if (generate)
+        fprintf(file, "# Golden vectors of the %s reference signal\n", equiv_modes[mode].name);
+    else if (fscanf(file, "# Golden vectors of the %*[^\n]") != 0)
+        goto end;
+
+    //========== Write or compare the vectors
+#define GOLDEN_VECTOR(NAME, SIZE, STRIDE, TOLERANCE, VALUE) do {                          \
+        for (size_t i = 0; i < (SIZE); i=i+1)                                             \
+            values[i] = (VALUE);                                                           \
+        if (golden_vector(file, generate, NAME, values, SIZE, STRIDE, TOLERANCE))          \
+            goto end;                                                                      \
+    } while (0)
+
+    GOLDEN_VECTOR("encoded",      encodedSize,      1,             0,     encoded[i]);
+    GOLDEN_VECTOR("subModulated", subModulatedSize, 1,             0,     subModulated[i]);
+    GOLDEN_VECTOR("time",         envelope->size,   GOLDEN_STRIDE, 0,     envelope->points[i].x);
+    GOLDEN_VECTOR("envelope",     envelope->size,   GOLDEN_STRIDE, 1e-12, envelope->points[i].y);
+    GOLDEN_VECTOR("signal",       signal->size,     GOLDEN_STRIDE, 1e-9,  signal->points[i].y);
+    GOLDEN_VECTOR("frequency",    spectrum->size,   GOLDEN_STRIDE, 0,     spectrum->points[i].x);
+    GOLDEN_VECTOR("spectrum",     spectrum->size,   GOLDEN_STRIDE, 1e-9,  spectrum->points[i].y);
+    GOLDEN_VECTOR("lcadcTime",    samples->size,    1,             0,     samples->points[i].x);
+    GOLDEN_VECTOR("lcadcLevel",   samples->size,    1,             0,     samples->points[i].y);
+#undef GOLDEN_VECTOR
+    status = 0;
+
+end:
+    fclose(file);
+    free(values);
+    free(encoded);
+    free(subModulated);
+    if (envelope)
+        scatter_destroy(envelope);
+    if (signal)
+        scatter_destroy(signal);
+    if (spectrum)
+        scatter_destroy(spectrum);
+    if (samples)
+        scatter_destroy(samples);
+    return status;
+}
+
+/**
+ * @brief Write or compare the golden vectors of all the modes
+ * 
+ * @param directory Directory of the golden files
+ * @param generate 1 to write the golden files, 0 to compare them
+ * @return int - 0 if success, -1 otherwise
+ */
+static int golden_run(const char* directory, int generate) {
+    //========== Variables declaration
+    char path[4096];                             // Path of a golden file
+    int  status = 0;                             // Status of the modes
+
+    for (size_t mode = 0; mode < sizeof(equiv_modes) / sizeof(*equiv_modes); mode=mode+1) {
+        snprintf(path, sizeof(path), "%s/%s", directory, equiv_modes[mode].file);
+        if (golden_mode(path, mode, generate)) {
+            PRINT(ERR, "%-10s golden vectors of %s do not match", "golden", equiv_modes[mode].name);
+            status = -1;
+        } else
+            PRINT(NORM, "%-10s %-10s %s", "golden", equiv_modes[mode].name, generate ? "written" : "ok");
+    }
+
+    return status;
+}
+
+/**
+ * @brief Main function
+ * 
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int - 0 if all the checks pass
+ */
+int main(int argc, char* argv[]) {
+    //========== Variable declaration
+    nfc_context_t  context;                      // Context of the checks
+    nfc_sigParam_t sigParam;                     // Parameters of a mode
+    double         error;                        // Error of a check
+    int            status = -1;                  // Status of the checks
+    int            found  = 0;                   // 1 if the check exists
+
+    if (argc != 3) {
+        PRINT(NORM, "Usage: %s <check|golden|generate> <golden directory>", argv[0]);
+        return -1;
+    }
+
+    // Only the errors of the library are printed
+    assert(!nfc_contextCreate(&context), "Failed to create the context", -1);
+    nfc_contextSetLog(context, NULL, NULL, ERR);
+    nfc_contextBind(context);
+
+    //========== Golden vectors
+    if (!strcmp(argv[1], "golden") || !strcmp(argv[1], "generate")) {
+        status = golden_run(argv[2], !strcmp(argv[1], "generate"));
+        found  = 1;
+    }
+
+    //========== Implementations against the references, on every CPU tier
+    for (size_t c = 0; c < sizeof(equiv_checks) / sizeof(*equiv_checks); c=c+1) {
+        if (strcmp(argv[1], equiv_checks[c].name))
+            continue;
+        found  = 1;
+        status = 0;
+        for (cpu_tier_t tier = CPU_GENERIC; tier <= cpu_supportedTier(); tier=tier+1) {
+            cpu_setTier(tier);
+            for (size_t mode = 0; mode < sizeof(equiv_modes) / sizeof(*equiv_modes); mode=mode+1) {
+                if (nfc_standardParam(equiv_data, sizeof(equiv_data), equiv_modes[mode].standard, equiv_modes[mode].dataTransm, BIT_RATE, EQUIV_NOISE_LEVEL, EQUIV_NB_POINTS, &sigParam) ||
+                    equiv_checks[c].check(&sigParam, &error)) {
+                    PRINT(ERR, "%-10s %-7s %-10s failed to run", equiv_checks[c].name, cpu_tierName(tier), equiv_modes[mode].name);
+                    status = -1;
+                } else if (!(error <= equiv_checks[c].tolerance)) {
+                    PRINT(ERR, "%-10s %-7s %-10s error %g above %g", equiv_checks[c].name, cpu_tierName(tier), equiv_modes[mode].name, error, equiv_checks[c].tolerance);
+                    status = -1;
+                } else
+                    PRINT(NORM, "%-10s %-7s %-10s error %g (tolerance %g)", equiv_checks[c].name, cpu_tierName(tier), equiv_modes[mode].name, error, equiv_checks[c].tolerance);
+            }
+        }
+    }
+    if (!found)
+        PRINT(ERR, "Unknown check \"%s\"", argv[1]);
+
+    nfc_contextBind(NULL);
+    nfc_contextDestroy(context);
+    return status;
+}
@@ -0,0 +1,460 @@
+/**
+ * @file reference.c
+ * @author OUSSET Gaël
+ * @brief Reference implementations of the signal generation, FFT and LCADC.
+ *        Straightforward scalar code, written for clarity and never
+ *        optimised.
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "reference.h"
+#include "prng.h"
+#include <complex.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+//========== Signal generation
+/**
+ * @brief Write the 4 symbols of a bit
+ * 
+ * @param symbols Symbols of the bit
+ * @param a First symbol
+ * @param b Second symbol
+ * @param c Third symbol
+ * @param d Fourth symbol
+ */
+static void ref_setBit(char* symbols, char a, char b, char c, char d) {
+    symbols[0] = a;
+    symbols[1] = b;
+    symbols[2] = c;
+    symbols[3] = d;
+}
+
+int ref_encodeData(nfc_sigParam_t* sigParam, char** encodedData, size_t* encodedSize) {
+    //========== Variables declaration
+    char*  data = sigParam->data;
+    size_t size = sigParam->dataSize;
+    int    bit;                                  // Current bit
+    int    previous;                             // Previous bit
+
+    if (!data || !size)
+        return -1;
+
+    *encodedSize = 8 * 4 * size;
+    *encodedData = malloc(*encodedSize);
+    if (!*encodedData)
+        return -1;
+
+    for (size_t i = 0; i < size; i=i+1) {
+        for (int j = 0; j < 8; j=j+1) {
+            char* symbols = *encodedData + 32*i + 4*(size_t)j;
+
+            bit = (data[i] >> j) & 0x01;
+            switch (sigParam->encodingType) {
+                //----- Modified miller: 1 -> 1101, 0 after 1 -> 1111, 0 after 0 -> 0111
+                case MOD_MILLER:
+                    if (i == 0 && j == 0)
+                        // The first bit is a 0 after a 1
+                        previous = 1;
+                    else if (j == 0)
+                        previous = (data[i-1] >> 7) & 0x01;
+                    else
+                        previous = (data[i] >> (j-1)) & 0x01;
+                    if (bit)
+                        ref_setBit(symbols, 1, 1, 0, 1);
+                    else if (previous)
+                        ref_setBit(symbols, 1, 1, 1, 1);
+                    else
+                        ref_setBit(symbols, 0, 1, 1, 1);
+                break;
+
+                //----- Non-return-to-zero: 1 -> 1111, 0 -> 0000
+                case NRZ:
+                    if (bit)
+                        ref_setBit(symbols, 1, 1, 1, 1);
+                    else
+                        ref_setBit(symbols, 0, 0, 0, 0);
+                break;
+
+                //----- Manchester: 1 -> 0011, 0 -> 1100
+                case MANCHESTER:
+                    if (bit)
+                        ref_setBit(symbols, 0, 0, 1, 1);
+                    else
+                        ref_setBit(symbols, 1, 1, 0, 0);
+                break;
+
+                default:
+                    free(*encodedData);
+                    return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+int ref_modulateSubCarrier(char* encodedData, size_t encodedSize, nfc_sigParam_t* sigParam, char** subModulatedData, size_t* subModulatedSize) {
+    //========== Variables declaration
+    unsigned int ratio;                          // Sub-carrier half periods per symbol times 2
+    char         level;                          // Level of the sub-carrier
+
+    if (sigParam->subModulation == NONE) {
+        *subModulatedSize = encodedSize;
+        *subModulatedData = malloc(encodedSize);
+        if (!*subModulatedData)
+            return -1;
+        memcpy(*subModulatedData, encodedData, encodedSize);
+        return 0;
+    }
+
+    ratio             = sigParam->subCarrierFreq / sigParam->bitRate;
+    *subModulatedSize = encodedSize * ratio / 2;
+    *subModulatedData = malloc(*subModulatedSize);
+    if (!*subModulatedData)
+        return -1;
+
+    for (size_t i = 0; i < encodedSize; i=i+1) {
+        // OOK keeps the carrier at 1 for a symbol at 1, BPSK inverts its phase
+        level = sigParam->subModulation == BPSK && encodedData[i] ? 1 : 0;
+        for (size_t j = i*ratio/2; j < (i+1)*ratio/2; j=j+1) {
+            if (sigParam->subModulation == OOK && encodedData[i])
+                (*subModulatedData)[j] = 1;
+            else {
+                (*subModulatedData)[j] = level;
+                level = !level;
+            }
+        }
+    }
+
+    return 0;
+}
+
+int ref_createEnvelope(char* subModulatedData, size_t subModulatedSize, nfc_sigParam_t* sigParam, scatter_t* envelope) {
+    //========== Variables declaration
+    unsigned int numberOfPoints = sigParam->numberOfPoints;
+    unsigned int symboleDuration;                // Duration of a symbol (ns)
+    unsigned int transTime;                      // Transition time (points)
+    double       modulationDepth;                // Level of a symbol at 0
+    double       sum;                            // Sum of the levels of the window
+    unsigned int count;                          // Number of points of the window
+    size_t       symbol;                         // Index of a symbol
+
+    if (sigParam->subModulation == NONE)
+        symboleDuration = (unsigned int)1e9 / sigParam->bitRate / 4;
+    else
+        symboleDuration = (unsigned int)1e9 / sigParam->subCarrierFreq / 2;
+    transTime       = (unsigned int)(2*1e9) / sigParam->carrierFreq * numberOfPoints / sigParam->simDuration;
+    modulationDepth = (double)(100 - sigParam->modulationIndex) / (double)(sigParam->modulationIndex + 100);
+
+    if (scatter_create(envelope, numberOfPoints))
+        return -1;
+
+    for (size_t i = 0; i < numberOfPoints; i=i+1)
+        (*envelope)->points[i].x = (int)((unsigned long long)i * sigParam->simDuration / numberOfPoints);
+
+    for (size_t i = 0; i < numberOfPoints; i=i+1) {
+        sum   = 0;
+        count = 0;
+        for (size_t j = i + 1 > transTime ? i + 1 - transTime : 0; j <= i; j=j+1) {
+            symbol = (size_t)(*envelope)->points[j].x / symboleDuration;
+            if (symbol >= subModulatedSize)
+                symbol = subModulatedSize - 1;
+            sum   = sum + (subModulatedData[symbol] ? 1 : modulationDepth);
+            count = count + 1;
+        }
+        (*envelope)->points[i].y = sum / (double)count;
+    }
+
+    return 0;
+}
+
+int ref_modulate(scatter_t envelope, nfc_sigParam_t* sigParam, scatter_t* modulatedSignal) {
+    if (scatter_create(modulatedSignal, envelope->size))
+        return -1;
+
+    for (size_t i = 0; i < envelope->size; i=i+1) {
+        (*modulatedSignal)->points[i].x = envelope->points[i].x;
+        (*modulatedSignal)->points[i].y = envelope->points[i].y * sin(
+            (double)2 * (double)M_PI * (double)sigParam->carrierFreq * (double)envelope->points[i].x / (double)1e9
+        );
+    }
+
+    return 0;
+}
+
+int ref_addNoise(scatter_t signal, nfc_sigParam_t* sigParam, uint64_t seed, scatter_t* noisySignal) {
+    if (scatter_create(noisySignal, signal->size))
+        return -1;
+
+    for (size_t i = 0; i < signal->size; i=i+1) {
+        (*noisySignal)->points[i].x = signal->points[i].x;
+        (*noisySignal)->points[i].y = signal->points[i].y + sigParam->noiseLevel * (prng_uniform(seed, i) - 0.5);
+    }
+
+    return 0;
+}
+
+int ref_createSignal(nfc_sigParam_t* sigParam, uint64_t seed, scatter_t* signal) {
+    //========== Variables declaration
+    char*     encodedData      = NULL;           // Encoded data
+    size_t    encodedSize      = 0;              // Size of the encoded data
+    char*     subModulatedData = NULL;           // Sub-modulated data
+    size_t    subModulatedSize = 0;              // Size of the sub-modulated data
+    scatter_t envelope         = NULL;           // Envelope
+    scatter_t modulated        = NULL;           // Modulated signal
+    int       status           = -1;             // Status of the generation
+
+    if (!ref_encodeData(sigParam, &encodedData, &encodedSize) &&
+        !ref_modulateSubCarrier(encodedData, encodedSize, sigParam, &subModulatedData, &subModulatedSize) &&
+        !ref_createEnvelope(subModulatedData, subModulatedSize, sigParam, &envelope) &&
+        !ref_modulate(envelope, sigParam, &modulated) &&
+        !ref_addNoise(modulated, sigParam, seed, signal))
+        status = 0;
+
+    free(encodedData);
+    free(subModulatedData);
+    if (envelope)
+        scatter_destroy(envelope);
+    if (modulated)
+        scatter_destroy(modulated);
+    return status;
+}
+
+//========== FFT
+int ref_fftIterative(scatter_t in, scatter_t out) {
+    //========== Variables declaration
+    size_t          n = in->size;                // Number of points
+    size_t          j;                           // Bit-reversed index
+    size_t          bit;                         // Bit of the reversed index
+    complex double* X;                           // Spectrum
+    complex double  swap;                        // Swapped value
+    complex double  wlen;                        // Twiddle factor of a stage
+    complex double  w;                           // Current twiddle factor
+    complex double  u;                           // Even value of a butterfly
+    complex double  t;                           // Odd value of a butterfly
+
+    if (!n || (n & (n - 1)) || out->size != n)
+        return -1;
+    X = malloc(n * sizeof(*X));
+    if (!X)
+        return -1;
+    for (size_t i = 0; i < n; i=i+1)
+        X[i] = in->points[i].y;
+
+    //----- Bit-reversal permutation
+    j = 0;
+    for (size_t i = 1; i < n; i=i+1) {
+        for (bit = n >> 1; j & bit; bit = bit >> 1)
+            j = j ^ bit;
+        j = j ^ bit;
+        if (i < j) {
+            swap = X[i];
+            X[i] = X[j];
+            X[j] = swap;
+        }
+    }
+
+    //----- Butterflies
+    for (size_t len = 2; len <= n; len=len<<1) {
+        wlen = cexp(I * (-2.0 * M_PI / (double)len));
+        for (size_t i = 0; i < n; i=i+len) {
+            w = 1.0;
+            for (size_t k = 0; k < len / 2; k=k+1) {
+                u              = X[i+k];
+                t              = w * X[i+k+len/2];
+                X[i+k]         = u + t;
+                X[i+k+len/2]   = u - t;
+                w              = w * wlen;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; i=i+1)
+        out->points[i].y = cabs(X[i]);
+
+    free(X);
+    return 0;
+}
+
+int ref_fftCompute(scatter_t timeSerie, scatter_t* freqSerie) {
+    //========== Variables declaration
+    double samplingRate = 0;                     // Average sampling rate (Hz)
+    size_t n            = timeSerie->size;       // Number of points
+
+    if (scatter_create(freqSerie, n))
+        return -1;
+    if (ref_fftIterative(timeSerie, *freqSerie)) {
+        scatter_destroy(*freqSerie);
+        return -1;
+    }
+
+    for (size_t i = 1; i < n; i=i+1)
+        samplingRate = samplingRate + timeSerie->points[i].x - timeSerie->points[i-1].x;
+    samplingRate = (double)(n - 1) / samplingRate * 1e9;
+
+    for (size_t i = 0; i < n; i=i+1)
+        (*freqSerie)->points[i].x = i < n/2 ?
+            (int)((double)i * samplingRate / (double)n) :
+            (int)((double)((int)i - (int)n) * samplingRate / (double)n);
+
+    return 0;
+}
+
+int ref_fftNonUniform(scatter_t timeSerie, double fStart, double fStep, size_t nbFrequencies, scatter_t* freqSerie) {
+    //========== Variables declaration
+    size_t         n      = timeSerie->size;     // Number of samples
+    point_t*       points = timeSerie->points;   // Samples
+    double*        weights;                      // Time each sample stands for
+    double         period = 0;                   // Average sampling period (ns)
+    double         frequency;                    // Frequency (Hz)
+    double         phase;                        // Phase of a sample, in turns
+    complex double sum;                          // Fourier sum
+
+    weights = malloc(n * sizeof(*weights));
+    if (!weights)
+        return -1;
+    if (n > 1)
+        period = (double)(points[n-1].x - points[0].x) / (double)(n - 1);
+    for (size_t i = 0; i < n; i=i+1) {
+        if (n == 1 || period <= 0)
+            weights[i] = 1;
+        else
+            weights[i] = (double)(points[i < n-1 ? i+1 : i].x - points[i > 0 ? i-1 : i].x) /
+                         (i == 0 || i == n-1 ? period : 2 * period);
+    }
+
+    if (scatter_create(freqSerie, nbFrequencies)) {
+        free(weights);
+        return -1;
+    }
+    for (size_t k = 0; k < nbFrequencies; k=k+1) {
+        frequency = fStart + (double)k * fStep;
+        sum       = 0;
+        for (size_t i = 0; i < n; i=i+1) {
+            phase = frequency * (double)points[i].x * 1e-9;
+            sum   = sum + weights[i] * points[i].y * cexp(-2 * M_PI * I * (phase - floor(phase)));
+        }
+        (*freqSerie)->points[k].x = (int)lround(frequency);
+        (*freqSerie)->points[k].y = cabs(sum);
+    }
+
+    free(weights);
+    return 0;
+}
+
+//========== LCADC
+int ref_LCADC(scatter_t signal, double* levels, unsigned int nbLevels, unsigned int skip, scatter_t* output) {
+    //========== Variables declaration
+    double*      sorted;                         // Levels in ascending order
+    double       swap;                           // Swapped level
+    point_t*     samples;                        // Samples
+    size_t       nbSamples = 0;                  // Number of samples
+    unsigned int skpCnt    = 0;                  // Crossings still to skip
+    point_t      a;                              // First point of a step
+    point_t      b;                              // Second point of a step
+    double       level;                          // Level tested
+
+    //----- Sort the levels
+    sorted = malloc((nbLevels ? nbLevels : 1) * sizeof(*sorted));
+    if (!sorted)
+        return -1;
+    for (size_t i = 0; i < nbLevels; i=i+1) {
+        sorted[i] = levels[i];
+        for (size_t j = i; j > 0 && sorted[j-1] > sorted[j]; j=j-1) {
+            swap        = sorted[j];
+            sorted[j]   = sorted[j-1];
+            sorted[j-1] = swap;
+        }
+    }
+
+    //----- At most every level is crossed at every step
+    samples = malloc((signal->size * nbLevels + 1) * sizeof(*samples));
+    if (!samples) {
+        free(sorted);
+        return -1;
+    }
+
+    for (size_t i = 1; i < signal->size; i=i+1) {
+        a = signal->points[i-1];
+        b = signal->points[i];
+        for (size_t j = 0; j < nbLevels; j=j+1) {
+            // Levels are crossed upwards in ascending order, downwards in descending order
+            level = b.y > a.y ? sorted[j] : sorted[nbLevels - 1 - j];
+            if (!((a.y < level && level < b.y) || (b.y < level && level < a.y)))
+                continue;
+            if (skpCnt) {
+                skpCnt = skpCnt - 1;
+                continue;
+            }
+            skpCnt               = skip;
+            samples[nbSamples].x = a.x + (int)lround((level - a.y) / (b.y - a.y) * (double)(b.x - a.x));
+            samples[nbSamples].y = level;
+            nbSamples            = nbSamples + 1;
+        }
+    }
+
+    free(sorted);
+    if (scatter_create(output, nbSamples)) {
+        free(samples);
+        return -1;
+    }
+    if (nbSamples)
+        memcpy((*output)->points, samples, nbSamples * sizeof(*samples));
+
+    free(samples);
+    return 0;
+}
+
+int ref_LCADCHoldError(scatter_t signal, double* levels, unsigned int nbLevels, unsigned int skip, double* rmsError) {
+    //========== Variables declaration
+    double*      sorted;                         // Levels in ascending order
+    double       swap;                           // Swapped level
+    unsigned int skpCnt  = 0;                    // Crossings still to skip
+    double       hold    = 0;                    // Level of the last sample
+    double       squares = 0;                    // Sum of the squared errors
+    point_t      a;                              // First point of a step
+    point_t      b;                              // Second point of a step
+    double       level;                          // Level tested
+
+    //----- Sort the levels
+    sorted = malloc((nbLevels ? nbLevels : 1) * sizeof(*sorted));
+    if (!sorted)
+        return -1;
+    for (size_t i = 0; i < nbLevels; i=i+1) {
+        sorted[i] = levels[i];
+        for (size_t j = i; j > 0 && sorted[j-1] > sorted[j]; j=j-1) {
+            swap        = sorted[j];
+            sorted[j]   = sorted[j-1];
+            sorted[j-1] = swap;
+        }
+    }
+
+    //----- Same crossings as ref_LCADC(), the last sample of a step is held from its end
+    squares = signal->points[0].y * signal->points[0].y;
+    for (size_t i = 1; i < signal->size; i=i+1) {
+        a = signal->points[i-1];
+        b = signal->points[i];
+        for (size_t j = 0; j < nbLevels; j=j+1) {
+            level = b.y > a.y ? sorted[j] : sorted[nbLevels - 1 - j];
+            if (!((a.y < level && level < b.y) || (b.y < level && level < a.y)))
+                continue;
+            if (skpCnt) {
+                skpCnt = skpCnt - 1;
+                continue;
+            }
+            skpCnt = skip;
+            hold   = level;
+        }
+        squares = squares + (b.y - hold) * (b.y - hold);
+    }
+
+    free(sorted);
+    *rmsError = sqrt(squares / (double)signal->size);
+    return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file reference.h
+ * @author OUSSET Gaël
+ * @brief Reference implementations of the signal generation, FFT and LCADC.
+ *        They are the plain scalar versions of the library functions, kept
+ *        as oracles: any faster implementation must give the same results
+ *        within the tolerance declared by the equivalence tests.
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include "nfcsig.h"
+#include "scatter.h"
+#include <stdint.h>
+
+//========== Functions
+/**
+ * @brief Reference of nfc_encodeData()
+ * 
+ * @param sigParam Parameters of the signal
+ * @param encodedData Encoded data, to free with free()
+ * @param encodedSize Size of the encoded data
+ * @return int - 0 if success, -1 otherwise
+ */
+int ref_encodeData(nfc_sigParam_t* sigParam, char** encodedData, size_t* encodedSize);
+
+/**
+ * @brief Reference of nfc_modulateSubCarrier()
+ * 
+ * @param encodedData Encoded data
+ * @param encodedSize Size of the encoded data
+ * @param sigParam Parameters of the signal
+ * @param subModulatedData Sub-modulated data, to free with free()
+ * @param subModulatedSize Size of the sub-modulated data
+ * @return int - 0 if success, -1 otherwise
+ */
+int ref_modulateSubCarrier(char* encodedData, size_t encodedSize, nfc_sigParam_t* sigParam, char** subModulatedData, size_t* subModulatedSize);
+
+/**
+ * @brief Reference of nfc_createEnvelope(): moving average over the
+ *        transition time, point by point
+ * 
+ * @param subModulatedData Sub-modulated data
+ * @param subModulatedSize Size of the sub-modulated data
+ * @param sigParam Parameters of the signal
+ * @param envelope Envelope of the signal
+ * @return int - 0 if success, -1 otherwise
+ */
+int ref_createEnvelope(char* subModulatedData, size_t subModulatedSize, nfc_sigParam_t* sigParam, scatter_t* envelope);
+
+/**
+ * @brief Reference of nfc_modulate()
+ * 
+ * @param envelope Envelope of the signal
+ * @param sigParam Parameters of the signal
+ * @param modulatedSignal Modulated signal
+ * @return int - 0 if success, -1 otherwise
+ */
+int ref_modulate(scatter_t envelope, nfc_sigParam_t* sigParam, scatter_t* modulatedSignal);
+
+/**
+ * @brief Reference of nfc_addNoise() with a context seeded with seed: the
+ *        noise of the point i is drawn with the counter i
+ * 
+ * @param signal Signal
+ * @param sigParam Parameters of the signal
+ * @param seed Seed of the noise
+ * @param noisySignal Noisy signal
+ * @return int - 0 if success, -1 otherwise
+ */
+int ref_addNoise(scatter_t signal, nfc_sigParam_t* sigParam, uint64_t seed, scatter_t* noisySignal);
+
+/**
+ * @brief Reference of nfc_createSignal() with a context seeded with seed
+ * 
+ * @param sigParam Parameters of the signal
+ * @param seed Seed of the noise
+ * @param signal Generated signal
+ * @return int - 0 if success, -1 otherwise
+ */
+int ref_createSignal(nfc_sigParam_t* sigParam, uint64_t seed, scatter_t* signal);
+
+/**
+ * @brief Reference of fft_Iterative()
+ * 
+ * @param in Time serie
+ * @param out Magnitudes of the spectrum, same size as in (power of 2)
+ * @return int - 0 if success, -1 otherwise
+ */
+int ref_fftIterative(scatter_t in, scatter_t out);
+
+/**
+ * @brief Reference of fft_Compute()
+ * 
+ * @param timeSerie Time serie
+ * @param freqSerie Magnitudes vs frequency (Hz)
+ * @return int - 0 if success, -1 otherwise
+ */
+int ref_fftCompute(scatter_t timeSerie, scatter_t* freqSerie);
+
+/**
+ * @brief Reference of fft_NonUniform(): direct sum of the weighted samples
+ *        at each frequency
+ * 
+ * @param timeSerie Time serie (ns)
+ * @param fStart First frequency (Hz)
+ * @param fStep Step between the frequencies (Hz)
+ * @param nbFrequencies Number of frequencies
+ * @param freqSerie Magnitudes vs frequency (Hz)
+ * @return int - 0 if success, -1 otherwise
+ */
+int ref_fftNonUniform(scatter_t timeSerie, double fStart, double fStep, size_t nbFrequencies, scatter_t* freqSerie);
+
+/**
+ * @brief Reference of LCADC(): every level strictly between two points is
+ *        sampled, upwards in ascending order and downwards in descending
+ *        order, at the time interpolated linearly between the points
+ * 
+ * @param signal Signal to sample
+ * @param levels Levels of the LCADC, in any order
+ * @param nbLevels Number of levels
+ * @param skip Number of crossings skipped after each sample
+ * @param output Sampled signal
+ * @return int - 0 if success, -1 otherwise
+ */
+int ref_LCADC(scatter_t signal, double* levels, unsigned int nbLevels, unsigned int skip, scatter_t* output);
+
+/**
+ * @brief Reference of the reconstruction error of LCADC_batch(): the level
+ *        of the last sample is held from the point that ends its step, 0
+ *        before the first sample
+ * 
+ * @param signal Signal to sample
+ * @param levels Levels of the LCADC, in any order
+ * @param nbLevels Number of levels
+ * @param skip Number of crossings skipped after each sample
+ * @param rmsError RMS error of the reconstruction
+ * @return int - 0 if success, -1 otherwise
+ */
+int ref_LCADCHoldError(scatter_t signal, double* levels, unsigned int nbLevels, unsigned int skip, double* rmsError);
+
+#endif // REFERENCE_H